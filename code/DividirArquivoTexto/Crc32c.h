@@ -0,0 +1,143 @@
+/**
+ * @file Crc32c.h
+ * @brief CRC32C (Castagnoli) incremental, com acelerao por hardware quando a CPU oferece.
+ *
+ * Usado pelos manifestos do divisor (uma soma por parte, calculada enquanto a parte  gravada) e pela
+ * verificao das partes. O mesmo polinmio do iSCSI, ext4 e Btrfs:
+ * - x86-64 com SSE4.2: instruo `crc32` (8 bytes por instruo), escolhida em tempo de execuo;
+ * - ARMv8 com a extenso CRC: `__crc32cd`, quando o compilador a habilita (`__ARM_FEATURE_CRC32`);
+ * - demais: tabelas *slicing-by-8* (8 bytes por iterao, sem instrues especiais).
+ *
+ * A interface segue a do `crc32` da zlib: `atualizar(0, ...)` comea uma soma e `atualizar(crc, ...)`
+ * continua a anterior, ento os blocos podem ser somados  medida que chegam.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#define CRC32C_X86 1
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define CRC32C_ARM 1
+#endif
+
+namespace crc32c {
+
+/// Polinmio de Castagnoli, bits invertidos.
+inline constexpr std::uint32_t kPolinomio = 0x82F63B78u;
+
+/**
+ * @brief Tabelas do *slicing-by-8*: `t[k][b]`  o CRC do byte `b` seguido de `k` bytes zero.
+ */
+inline constexpr std::array<std::array<std::uint32_t, 256>, 8> kTabelas = [] {
+    std::array<std::array<std::uint32_t, 256>, 8> t{};
+    for (std::uint32_t b = 0; b < 256; ++b) {
+        std::uint32_t c = b;
+        for (int i = 0; i < 8; ++i) c = (c >> 1) ^ ((c & 1) ? kPolinomio : 0);
+        t[0][b] = c;
+    }
+    for (std::uint32_t b = 0; b < 256; ++b) {
+        for (int k = 1; k < 8; ++k) t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xFF];
+    }
+    return t;
+}();
+
+/**
+ * @brief CRC32C em software (sem pr/ps-inverso: recebe e devolve o estado interno).
+ */
+[[nodiscard]] inline std::uint32_t software(std::uint32_t estado, const unsigned char* p, std::size_t n) noexcept {
+    for (; n >= 8; p += 8, n -= 8) {
+        std::uint32_t lo;
+        std::uint32_t hi;
+        std::memcpy(&lo, p, 4);
+        std::memcpy(&hi, p + 4, 4);
+        lo ^= estado; // little-endian (x86, ARM): os 4 primeiros bytes so os menos significativos
+        estado = kTabelas[7][lo & 0xFF] ^ kTabelas[6][(lo >> 8) & 0xFF] ^ kTabelas[5][(lo >> 16) & 0xFF] ^ kTabelas[4][lo >> 24]
+            ^ kTabelas[3][hi & 0xFF] ^ kTabelas[2][(hi >> 8) & 0xFF] ^ kTabelas[1][(hi >> 16) & 0xFF] ^ kTabelas[0][hi >> 24];
+    }
+    for (; n > 0; ++p, --n) estado = (estado >> 8) ^ kTabelas[0][(estado ^ *p) & 0xFF];
+    return estado;
+}
+
+#if defined(CRC32C_X86)
+
+/**
+ * @brief CRC32C com a instruo `crc32` do SSE4.2 (s pode ser chamada se `temAceleracao()`).
+ */
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("sse4.2")))
+#endif
+[[nodiscard]] inline std::uint32_t hardware(std::uint32_t estado, const unsigned char* p, std::size_t n) noexcept {
+    std::uint64_t e = estado;
+    for (; n >= 8; p += 8, n -= 8) {
+        std::uint64_t v;
+        std::memcpy(&v, p, 8);
+        e = _mm_crc32_u64(e, v);
+    }
+    std::uint32_t e32 = static_cast<std::uint32_t>(e);
+    for (; n > 0; ++p, --n) e32 = _mm_crc32_u8(e32, *p);
+    return e32;
+}
+
+/**
+ * @brief Diz se a CPU tem SSE4.2 (consultado uma vez).
+ */
+[[nodiscard]] inline bool temAceleracao() noexcept {
+#if defined(_MSC_VER)
+    static const bool tem = [] {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 20)) != 0;
+    }();
+#else
+    static const bool tem = __builtin_cpu_supports("sse4.2");
+#endif
+    return tem;
+}
+
+#elif defined(CRC32C_ARM)
+
+/**
+ * @brief CRC32C com as instrues `crc32c*` do ARMv8 (habilitadas na compilao).
+ */
+[[nodiscard]] inline std::uint32_t hardware(std::uint32_t estado, const unsigned char* p, std::size_t n) noexcept {
+    for (; n >= 8; p += 8, n -= 8) {
+        std::uint64_t v;
+        std::memcpy(&v, p, 8);
+        estado = __crc32cd(estado, v);
+    }
+    for (; n > 0; ++p, --n) estado = __crc32cb(estado, *p);
+    return estado;
+}
+
+[[nodiscard]] inline bool temAceleracao() noexcept { return true; }
+
+#else
+
+[[nodiscard]] inline std::uint32_t hardware(std::uint32_t estado, const unsigned char* p, std::size_t n) noexcept {
+    return software(estado, p, n);
+}
+
+[[nodiscard]] inline bool temAceleracao() noexcept { return false; }
+
+#endif
+
+/**
+ * @brief Continua a soma `crc` (0 para comear) com `n` bytes em `dados`.
+ */
+[[nodiscard]] inline std::uint32_t atualizar(std::uint32_t crc, const void* dados, std::size_t n) noexcept {
+    const auto* p = static_cast<const unsigned char*>(dados);
+    const std::uint32_t estado = ~crc;
+    return ~(temAceleracao() ? hardware(estado, p, n) : software(estado, p, n));
+}
+
+} // namespace crc32c
@@ -6,13 +6,42 @@
 #include <filesystem>   // Para manipulao de diretrios
 #include <iomanip>      // Para std::setw e std::setfill (formatar nomes de arquivos)
 #include <sstream>      // Para construir os nomes dos arquivos dinamicamente
+#include <string_view>  // Para as partes: trechos do texto baixado, sem cpia
+#include <algorithm>    // Para std::min e std::max
+#include <chrono>       // Para medir o tempo de gravao
+#include <thread>       // Para std::thread::hardware_concurrency
+#include <random>       // Para gerar o texto de teste do benchmark
+#include <cstdint>      // Para std::uint64_t (tamanhos de entradas maiores que 4 GB)
+#include <cstring>      // Para std::memchr (procura de '\n' no modo streaming)
+#include <array>        // Para a tabela do hash rolante (cortes por contedo)
+
+#ifdef _WIN32
+#include <fcntl.h>      // Para _O_BINARY e _O_RDONLY
+#include <io.h>         // Para _open, _read, _close e _setmode (leitura por descritor no modo streaming)
+#else
+#include <fcntl.h>          // Para open
+#include <sys/resource.h>   // Para getrusage (pico de memria)
+#include <unistd.h>         // Para read e close
+#include <cerrno>           // Para errno (leitura interrompida por sinal)
+#endif
+
+#include "GravadorDePartes.h" // Gravao das partes: ofstream, threads ou io_uring
+#include "Crc32c.h"           // Somas de verificao das partes no manifesto
+
+#ifdef _WIN32
+// Evita as macros min e max do windows.h, que quebram std::min e std::max
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
 
 // Cabealhos do Windows SDK para a funcionalidade de rede
 #include <windows.h>
 #include <wininet.h>
+#include <psapi.h>      // Para GetProcessMemoryInfo (pico de memria)
 
 // Diretiva para o linker incluir a biblioteca wininet.lib
 #pragma comment(lib, "wininet.lib")
+#pragma comment(lib, "psapi.lib")
 
 /**
  * @brief Baixa o contedo de uma URL como texto.
@@ -45,6 +74,7 @@ std::string baixarTexto(const std::wstring& url) {
 
     return downloadedData;
 }
+#endif // _WIN32
 
 /**
  * @brief Divide um texto grande em um nmero especfico de partes menores.
@@ -75,49 +105,795 @@ std::vector<std::string> dividirTexto(const std::string& texto, int numeroDePart
     return partes;
 }
 
-int main() {
-    const std::wstring url = L"https://www.gutenberg.org/files/1342/1342-0.txt"; // Pride and Prejudice
+/**
+ * @brief Diz se o byte  a continuao de um caractere UTF-8 de vrios bytes (10xxxxxx).
+ */
+constexpr bool ehContinuacaoUtf8(char c) {
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+/**
+ * @brief Escolhe um corte perto de `alvo` que no divida linhas nem caracteres UTF-8.
+ *
+ * Procura o '\n' mais prximo de `alvo`, para trs e para frente, a no mximo `janela` bytes; o corte
+ * fica logo depois dele. Se a linha for longa demais, recua at o incio do caractere UTF-8 que contm
+ * `alvo` (no mximo 3 bytes, olhando s os bits altos do byte), sem decodificar o texto. O corte nunca
+ * fica em `inicio` (a parte no seria vazia) nem depois do fim do texto.
+ *
+ * @param inicio Incio da parte atual; o corte fica em (inicio, texto.length()].
+ */
+size_t pontoDeCorteUtf8(std::string_view texto, size_t inicio, size_t alvo, size_t janela) {
+    alvo = std::clamp(alvo, inicio + 1, texto.length());
+    if (alvo == texto.length()) {
+        return alvo;
+    }
+    // texto[alvo - 1] == '\n' j  um fim de linha; seno, o '\n' anterior mais prximo...
+    const size_t de = std::max(inicio, alvo > janela ? alvo - janela : 0);
+    const size_t antes = texto.substr(de, alvo - de).rfind('\n');
+    if (antes != std::string_view::npos && de + antes + 1 == alvo) {
+        return alvo;
+    }
+    // ... e o prximo, dentro da janela.
+    const size_t depois = texto.substr(alvo, janela).find('\n');
+    const size_t corteAntes = (antes == std::string_view::npos) ? 0 : de + antes + 1;
+    const size_t corteDepois = (depois == std::string_view::npos) ? 0 : alvo + depois + 1;
+    if (corteAntes > inicio && (corteDepois == 0 || alvo - corteAntes <= corteDepois - alvo)) {
+        return corteAntes;
+    }
+    if (corteDepois != 0) {
+        return corteDepois;
+    }
+    // Linha maior que a janela: corta no incio de um caractere.
+    size_t corte = alvo;
+    for (int recuo = 0; recuo < 3 && corte > inicio + 1 && ehContinuacaoUtf8(texto[corte]); ++recuo) {
+        --corte;
+    }
+    while (corte < texto.length() && ehContinuacaoUtf8(texto[corte])) {
+        ++corte; // a parte comeou no meio do caractere: avana at o fim dele
+    }
+    return corte;
+}
+
+/**
+ * @brief Divide o texto em at `numeroDePartes` partes, sem cortar linhas nem caracteres UTF-8 e sem copiar o texto.
+ *
+ * Primeira fase da diviso paralela: o corte k fica perto do byte k * tamanhoTotal / numeroDePartes,
+ * ajustado por `pontoDeCorteUtf8` com uma janela de meia parte, ento cada corte custa uma busca curta,
+ * independente dos outros, e nenhuma parte passa de 1,5x o tamanho ideal por causa do ajuste (a no ser
+ * por linhas mais longas que isso, que so cortadas em um limite de caractere).
+ * As partes so `std::string_view` para dentro de `texto`, que precisa continuar vivo enquanto forem usadas.
+ */
+std::vector<std::string_view> dividirTextoUtf8(std::string_view texto, int numeroDePartes) {
+    std::vector<std::string_view> partes;
+    if (texto.empty() || numeroDePartes <= 0) {
+        return partes;
+    }
+    partes.reserve(numeroDePartes);
+
+    const size_t tamanhoDaParte = texto.length() / numeroDePartes;
+    const size_t janela = std::max<size_t>(tamanhoDaParte / 2, 1);
+    size_t pos_inicial = 0;
+    for (int k = 1; k < numeroDePartes && pos_inicial < texto.length(); ++k) {
+        const size_t corte = pontoDeCorteUtf8(texto, pos_inicial, tamanhoDaParte * k, janela);
+        if (corte >= texto.length()) {
+            break; // o resto vira a ltima parte
+        }
+        partes.push_back(texto.substr(pos_inicial, corte - pos_inicial));
+        pos_inicial = corte;
+    }
+    if (pos_inicial < texto.length()) {
+        partes.push_back(texto.substr(pos_inicial));
+    }
+    return partes;
+}
+
+/**
+ * @brief Segunda fase da diviso: grava cada parte em `<diretorio>/parte_NNN.txt`.
+ *
+ * As partes so gravadas direto do texto baixado pelo `GravadorDePartes.h`. O padro  `Metodo::Ofstream`,
+ * em sequncia: nas medidas do `--bench-gravacao` (1000 partes) ele foi mais rpido que o io_uring e que o
+ * pool de threads, que economizam chamadas de sistema mas no tempo. Os outros mtodos so escolhidos na
+ * linha de comando com `--gravacao <ofstream|threads|io_uring>`.
+ */
+gravacao::Estatisticas salvarPartes(const std::vector<std::string_view>& partes, const std::string& nome_diretorio,
+    gravacao::Metodo metodo = gravacao::Metodo::Ofstream) {
+    std::vector<gravacao::Pedido> pedidos;
+    pedidos.reserve(partes.size());
+    for (size_t i = 0; i < partes.size(); ++i) {
+        std::stringstream ss;
+        ss << nome_diretorio << "/parte_"
+            << std::setw(3) << std::setfill('0') << (i + 1)
+            << ".txt";
+        pedidos.push_back({ ss.str(), partes[i] });
+    }
+    return gravacao::gravar(pedidos, metodo);
+}
+
+// --- Modo streaming: diviso de um descritor (stdin, pipe ou arquivo) com memria limitada ---
+
+/**
+ * @brief Como o modo streaming decide onde uma parte termina.
+ */
+enum class CriterioDeCorte {
+    Bytes,  ///< Parte com pelo menos `limite` bytes, terminando no prximo '\n' (ou em um caractere, se a linha passar de 2x o limite).
+    Linhas, ///< Parte com exatamente `limite` linhas (a ltima pode ter menos).
+    Conteudo, ///< Cortes definidos pelo contedo (hash rolante), com tamanho mdio perto de `limite` bytes.
+};
+
+/**
+ * @brief Tabela do *Gear hash* usado pelos cortes definidos pelo contedo: 256 valores pseudoaleatrios fixos.
+ *
+ * Gerada por splitmix64 com semente fixa: os cortes de um mesmo texto so sempre os mesmos, em qualquer
+ * mquina e em qualquer execuo.
+ */
+constexpr std::array<std::uint64_t, 256> kTabelaGear = [] {
+    std::array<std::uint64_t, 256> t{};
+    std::uint64_t x = 0x9E3779B97F4A7C15ull;
+    for (std::uint64_t& v : t) {
+        x += 0x9E3779B97F4A7C15ull;
+        std::uint64_t z = x;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        v = z ^ (z >> 31);
+    }
+    return t;
+}();
+
+/**
+ * @brief Resumo de uma diviso em streaming.
+ */
+struct ResultadoStreaming {
+    size_t partes = 0;        ///< Arquivos gravados (listados em `<diretorio>/manifesto.tsv`).
+    std::uint64_t bytes = 0;  ///< Bytes lidos da entrada (e gravados nas partes).
+    double segundos = 0.0;    ///< Tempo total.
+};
+
+/**
+ * @brief L at `tamanho` bytes do descritor, repetindo em caso de interrupo; devolve 0 no fim da entrada.
+ */
+size_t lerBloco(int fd, char* destino, size_t tamanho) {
+    for (;;) {
+#ifdef _WIN32
+        const int n = _read(fd, destino, static_cast<unsigned>(std::min<size_t>(tamanho, 1u << 30)));
+#else
+        const ssize_t n = read(fd, destino, tamanho);
+        if (n < 0 && errno == EINTR) continue;
+#endif
+        if (n < 0) throw std::runtime_error("Erro ao ler a entrada.");
+        return static_cast<size_t>(n);
+    }
+}
+
+/**
+ * @brief Pico de memria residente do processo (RSS), em KB.
+ */
+size_t picoDeMemoriaKB() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS contadores{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &contadores, sizeof(contadores));
+    return contadores.PeakWorkingSetSize / 1024;
+#else
+    struct rusage uso {};
+    getrusage(RUSAGE_SELF, &uso);
+#ifdef __APPLE__
+    return static_cast<size_t>(uso.ru_maxrss) / 1024; // macOS informa em bytes
+#else
+    return static_cast<size_t>(uso.ru_maxrss); // Linux informa em KB
+#endif
+#endif
+}
+
+/**
+ * @brief Divide a entrada lida de `fd` em partes `<diretorio>/parte_NNN.txt`, sem nunca guard-la inteira na memria.
+ *
+ * A entrada  lida em blocos de `tamanhoDoBloco` bytes para um nico buffer, reaproveitado a cada leitura.
+ * Cada bloco  varrido com `memchr` e os trechos so gravados na parte atual assim que lidos, ento a memria
+ * usada  um bloco mais o buffer do `std::ofstream`, qualquer que seja o tamanho da entrada ou das partes.
+ * Os cortes seguem as mesmas regras de `pontoDeCorteUtf8`: no fim de uma linha e, se uma linha passar de
+ * 2x o limite (modo `Bytes`), antes do primeiro byte que inicia um caractere UTF-8.
+ *
+ * No modo `Conteudo`, um *Gear hash* rolante (`h = (h << 1) + tabela[byte]`, que depende s dos ltimos
+ * 64 bytes) decide os cortes: a parte termina quando os bits altos de `h` selecionados pela mscara so
+ * zero, com mnimo de `limite / 4` e mximo de `4 * limite` bytes, e nunca antes de um byte de continuao
+ * UTF-8. Como o corte depende s do contedo prximo, inserir ou remover bytes no comeo do texto muda
+ * apenas as partes vizinhas da alterao; as demais partes (e suas somas) continuam iguais, o que
+ * permite deduplicao.
+ *
+ * Junto com as partes  gravado `<diretorio>/manifesto.tsv`, com nome, deslocamento, tamanho e CRC32C de
+ * cada parte. O CRC  calculado sobre os mesmos trechos que vo para o arquivo, enquanto so gravados
+ * (com a instruo `crc32` do SSE4.2, quando existir), sem uma segunda leitura.
+ *
+ * @param fd Descritor de entrada (0 para stdin);  lido at o fim, mas no  fechado.
+ * @param limite Bytes (modos `Bytes` e `Conteudo`) ou linhas (modo `Linhas`) por parte; precisa ser positivo.
+ */
+ResultadoStreaming dividirStreaming(int fd, CriterioDeCorte criterio, std::uint64_t limite, const std::string& nome_diretorio,
+    size_t tamanhoDoBloco = 1 << 20) {
+    if (limite == 0) {
+        throw std::runtime_error("O limite por parte deve ser positivo.");
+    }
+    const auto inicio = std::chrono::steady_clock::now();
+    std::filesystem::create_directory(nome_diretorio);
+
+    std::vector<char> bloco(tamanhoDoBloco);
+    ResultadoStreaming resultado;
+    std::ofstream arquivo_saida;
+    std::string nome_arquivo;
+    std::uint64_t bytesNaParte = 0;
+    std::uint64_t linhasNaParte = 0;
+    std::uint64_t inicioDaParte = 0;
+    std::uint32_t crcDaParte = 0;
+
+    // Cortes por contedo: a mscara tem log2(limite) bits, os mais altos de h (que dependem de mais bytes).
+    int bitsDaMascara = 0;
+    while ((std::uint64_t{ 1 } << (bitsDaMascara + 1)) <= limite && bitsDaMascara < 63) ++bitsDaMascara;
+    const std::uint64_t mascara = bitsDaMascara == 0 ? 0 : ~std::uint64_t{ 0 } << (64 - bitsDaMascara);
+    const std::uint64_t minimo = std::max<std::uint64_t>(limite / 4, 1);
+    const std::uint64_t maximo = 4 * limite;
+    std::uint64_t hash = 0;
+    bool cortePendente = false;
+
+    const std::string nome_manifesto = nome_diretorio + "/manifesto.tsv";
+    std::ofstream manifesto(nome_manifesto, std::ios::binary);
+    if (!manifesto.is_open()) {
+        throw std::runtime_error("Erro ao criar o arquivo: " + nome_manifesto);
+    }
+    manifesto << "# parte\tdeslocamento\ttamanho\tcrc32c\n";
+
+    auto fecharParte = [&]() {
+        arquivo_saida.close();
+        if (!arquivo_saida) {
+            throw std::runtime_error("Erro ao gravar o arquivo: " + nome_arquivo);
+        }
+        manifesto << std::filesystem::path(nome_arquivo).filename().string() << '\t' << inicioDaParte << '\t'
+            << bytesNaParte << '\t' << std::hex << std::setw(8) << std::setfill('0') << crcDaParte << std::dec << '\n';
+        inicioDaParte += bytesNaParte;
+        bytesNaParte = 0;
+        linhasNaParte = 0;
+        crcDaParte = 0;
+        cortePendente = false;
+    };
+
+    for (size_t lidos; (lidos = lerBloco(fd, bloco.data(), bloco.size())) > 0;) {
+        resultado.bytes += lidos;
+        const char* const dados = bloco.data();
+        size_t pos = 0;
+        while (pos < lidos) {
+            if (!arquivo_saida.is_open()) {
+                std::stringstream ss;
+                ss << nome_diretorio << "/parte_"
+                    << std::setw(3) << std::setfill('0') << (++resultado.partes)
+                    << ".txt";
+                nome_arquivo = ss.str();
+                arquivo_saida.open(nome_arquivo, std::ios::binary);
+                if (!arquivo_saida.is_open()) {
+                    throw std::runtime_error("Erro ao criar o arquivo: " + nome_arquivo);
+                }
+            }
+
+            // Procura o fim da parte atual dentro de [pos, lidos); corte == lidos significa "continua no prximo bloco".
+            size_t corte = lidos;
+            bool terminou = false;
+            if (criterio == CriterioDeCorte::Linhas) {
+                for (size_t p = pos; p < lidos;) {
+                    const void* quebra = std::memchr(dados + p, '\n', lidos - p);
+                    if (!quebra) break;
+                    p = static_cast<size_t>(static_cast<const char*>(quebra) - dados) + 1;
+                    if (++linhasNaParte == limite) {
+                        corte = p;
+                        terminou = true;
+                        break;
+                    }
+                }
+            }
+            else if (criterio == CriterioDeCorte::Conteudo) {
+                for (size_t p = pos; p < lidos; ++p) {
+                    // O corte escolhido no byte anterior s acontece antes do incio de um caractere (o byte
+                    // seguinte pode estar no prximo bloco, por isso a deciso fica pendente).
+                    if (cortePendente && !ehContinuacaoUtf8(dados[p])) {
+                        corte = p;
+                        terminou = true;
+                        break;
+                    }
+                    hash = (hash << 1) + kTabelaGear[static_cast<unsigned char>(dados[p])];
+                    const std::uint64_t tamanho = bytesNaParte + (p + 1 - pos);
+                    if (tamanho >= minimo && ((hash & mascara) == 0 || tamanho >= maximo)) {
+                        cortePendente = true;
+                    }
+                }
+            }
+            else {
+                const std::uint64_t faltam = bytesNaParte < limite ? limite - bytesNaParte : 1;
+                const std::uint64_t ateForcar = 2 * limite - std::min(bytesNaParte, 2 * limite);
+                const size_t busca = pos + static_cast<size_t>(std::min<std::uint64_t>(faltam - 1, lidos - pos));
+                const void* quebra = std::memchr(dados + busca, '\n', lidos - busca);
+                const size_t fimDaLinha = quebra ? static_cast<size_t>(static_cast<const char*>(quebra) - dados) + 1 : lidos + 1;
+                if (fimDaLinha <= lidos && fimDaLinha - pos <= ateForcar) {
+                    corte = fimDaLinha;
+                    terminou = true;
+                }
+                else if (ateForcar < lidos - pos) {
+                    // Linha longa demais: corta antes do primeiro byte que no  continuao de um caractere.
+                    size_t p = pos + static_cast<size_t>(ateForcar);
+                    while (p < lidos && ehContinuacaoUtf8(dados[p])) ++p;
+                    if (p < lidos) {
+                        corte = p;
+                        terminou = true;
+                    }
+                }
+            }
+
+            arquivo_saida.write(dados + pos, static_cast<std::streamsize>(corte - pos));
+            crcDaParte = crc32c::atualizar(crcDaParte, dados + pos, corte - pos);
+            bytesNaParte += corte - pos;
+            pos = corte;
+            if (terminou) {
+                fecharParte();
+            }
+        }
+    }
+    if (arquivo_saida.is_open()) {
+        fecharParte();
+    }
+    manifesto.close();
+    if (!manifesto) {
+        throw std::runtime_error("Erro ao gravar o arquivo: " + nome_manifesto);
+    }
+    resultado.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    return resultado;
+}
+
+/**
+ * @brief Converte um tamanho como "500", "64K", "256M" ou "2G" em bytes.
+ */
+std::uint64_t lerTamanho(const std::string& texto) {
+    size_t fim = 0;
+    std::uint64_t valor = std::stoull(texto, &fim);
+    if (fim < texto.length()) {
+        switch (texto[fim]) {
+        case 'k': case 'K': valor <<= 10; break;
+        case 'm': case 'M': valor <<= 20; break;
+        case 'g': case 'G': valor <<= 30; break;
+        default: throw std::runtime_error("Tamanho invalido: " + texto);
+        }
+    }
+    return valor;
+}
+
+/**
+ * @brief Linha de comando do modo streaming: `--stream <bytes|linhas|conteudo> <limite> <diretorio> [entrada|-]`.
+ *
+ * Sem entrada (ou com "-"), l de stdin. No fim mostra partes, vazo e pico de memria residente.
+ */
+int executarStreaming(int argc, char* argv[]) {
+    if (argc < 5) {
+        std::cerr << "Uso: " << argv[0] << " --stream <bytes|linhas|conteudo> <limite> <diretorio> [entrada|-]" << std::endl;
+        return 1;
+    }
+    const std::string modo = argv[2];
+    if (modo != "bytes" && modo != "linhas" && modo != "conteudo") {
+        std::cerr << "Criterio invalido: " << modo << " (use bytes, linhas ou conteudo)" << std::endl;
+        return 1;
+    }
+    const CriterioDeCorte criterio = (modo == "bytes") ? CriterioDeCorte::Bytes
+                                   : (modo == "linhas") ? CriterioDeCorte::Linhas : CriterioDeCorte::Conteudo;
+    const std::uint64_t limite = (criterio == CriterioDeCorte::Linhas) ? std::stoull(argv[3]) : lerTamanho(argv[3]);
+    const std::string entrada = argc > 5 ? argv[5] : "-";
+
+    int fd = 0;
+    if (entrada != "-") {
+#ifdef _WIN32
+        fd = _open(entrada.c_str(), _O_RDONLY | _O_BINARY);
+#else
+        fd = open(entrada.c_str(), O_RDONLY);
+#endif
+        if (fd < 0) throw std::runtime_error("Nao foi possivel abrir " + entrada);
+    }
+#ifdef _WIN32
+    else {
+        _setmode(0, _O_BINARY); // sem converso de \r\n em stdin
+    }
+#endif
+    const ResultadoStreaming r = dividirStreaming(fd, criterio, limite, argv[4]);
+    if (fd != 0) {
+#ifdef _WIN32
+        _close(fd);
+#else
+        close(fd);
+#endif
+    }
+    std::cout << r.partes << " partes, " << r.bytes << " bytes em " << std::fixed << std::setprecision(3)
+        << r.segundos << " s (" << static_cast<double>(r.bytes) / 1e9 / std::max(r.segundos, 1e-9) << " GB/s), "
+        << "pico de memoria residente: " << picoDeMemoriaKB() << " KB" << std::endl;
+    std::cout << "manifesto: " << argv[4] << "/manifesto.tsv (CRC32C " << (crc32c::temAceleracao() ? "por hardware" : "em software")
+        << ")" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Confere as partes listadas em `<diretorio>/manifesto.tsv`: sequncia, tamanhos e CRC32C.
+ *
+ * As partes precisam ser contguas (cada deslocamento  o anterior mais o tamanho anterior) e cada arquivo
+ * precisa ter o tamanho e o CRC32C registrados.
+ *
+ * @return size_t Nmero de problemas encontrados (0 = tudo confere).
+ */
+size_t verificarManifesto(const std::string& nome_diretorio, bool detalhes = true) {
+    std::ifstream manifesto(nome_diretorio + "/manifesto.tsv");
+    if (!manifesto.is_open()) {
+        throw std::runtime_error("Manifesto nao encontrado em " + nome_diretorio);
+    }
+    size_t problemas = 0;
+    size_t partes = 0;
+    std::uint64_t esperado = 0;
+    std::vector<char> buffer(1 << 20);
+    auto problema = [&](const std::string& mensagem) {
+        if (detalhes) std::cout << "PROBLEMA: " << mensagem << std::endl;
+        ++problemas;
+    };
+    for (std::string linha; std::getline(manifesto, linha);) {
+        if (linha.empty() || linha[0] == '#') continue;
+        std::istringstream campos(linha);
+        std::string nome;
+        std::uint64_t deslocamento = 0;
+        std::uint64_t tamanho = 0;
+        std::uint32_t crc = 0;
+        if (!(campos >> nome >> deslocamento >> tamanho >> std::hex >> crc)) {
+            problema("linha invalida no manifesto: " + linha);
+            continue;
+        }
+        ++partes;
+        if (deslocamento != esperado) problema(nome + ": deslocamento " + std::to_string(deslocamento) + ", esperado " + std::to_string(esperado));
+        esperado = deslocamento + tamanho;
+
+        std::ifstream arquivo(nome_diretorio + "/" + nome, std::ios::binary);
+        if (!arquivo.is_open()) {
+            problema(nome + ": arquivo ausente");
+            continue;
+        }
+        std::uint64_t lidos = 0;
+        std::uint32_t calculado = 0;
+        while (arquivo.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || arquivo.gcount() > 0) {
+            const size_t n = static_cast<size_t>(arquivo.gcount());
+            calculado = crc32c::atualizar(calculado, buffer.data(), n);
+            lidos += n;
+        }
+        if (lidos != tamanho) problema(nome + ": " + std::to_string(lidos) + " bytes, esperado " + std::to_string(tamanho));
+        else if (calculado != crc) problema(nome + ": CRC32C diferente");
+    }
+    if (detalhes) {
+        std::cout << partes << " partes, " << esperado << " bytes: " << (problemas == 0 ? "tudo confere" : std::to_string(problemas) + " problema(s)") << std::endl;
+    }
+    return problemas;
+}
+
+// --- Testes e benchmark da diviso (sem bibliotecas externas) ---
+
+/**
+ * @brief Verifica as garantias de `dividirTextoUtf8` em textos com caracteres de 1 a 4 bytes.
+ *
+ * Para cada texto e nmero de partes: a concatenao das partes  o texto original, nenhuma parte 
+ * vazia ou comea no meio de um caractere, e toda parte (menos a ltima) termina em '\n' quando o texto
+ * tem linhas mais curtas que meia parte.
+ *
+ * O modo streaming (`dividirStreaming`)  verificado com os mesmos textos, lidos de um arquivo temporrio
+ * em blocos de poucos bytes (para que os cortes caiam nas fronteiras dos blocos): alm das garantias
+ * acima, cada parte tem o nmero certo de linhas, ou entre `limite` e 2x `limite` bytes (entre `limite` / 4
+ * e 4x `limite` nos cortes por contedo), e o manifesto confere com as partes gravadas. O CRC32C 
+ * conferido com o valor de referncia de "123456789" e entre as verses por hardware e em software.
+ *
+ * @return int Nmero de falhas (0 = todos passaram).
+ */
+int executarTestes() {
+    struct Caso { const char* nome; std::string texto; bool linhasCurtas; };
+    std::string misto;
+    for (int i = 0; i < 500; ++i) {
+        // "Ao n i: corao, po, euro, japons e emoji" em UTF-8 (o arquivo-fonte no  UTF-8)
+        misto += "A\xC3\xA7\xC3\xA3o n\xC2\xBA " + std::to_string(i) + ": cora\xC3\xA7\xC3\xA3o, p\xC3\xA3o, \xE2\x82\xAC, "
+            "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E e \xF0\x9F\x99\x82\n";
+    }
+    std::string semQuebras;
+    for (int i = 0; i < 3000; ++i) {
+        semQuebras += (i % 3 == 0) ? "\xC3\xA7" : (i % 3 == 1) ? "\xE8\xAA\x9E" : "\xF0\x9F\x99\x82"; // , japons, emoji
+    }
+    const std::vector<Caso> casos = {
+        { "ASCII", std::string(5000, 'a') + "\n" + std::string(5000, 'b') + "\n", false },
+        { "linhas com 1 a 4 bytes por caractere", misto, true },
+        { "sem quebras de linha", semQuebras, false },
+        { "um nico caractere", "\xF0\x9F\x99\x82", false },
+        { "s quebras de linha", std::string(1000, '\n'), true },
+    };
+
+    int falhas = 0;
+    auto falha = [&](const Caso& caso, int n, const std::string& motivo) {
+        std::cout << "FALHOU: " << caso.nome << ", " << n << " partes: " << motivo << std::endl;
+        ++falhas;
+    };
+    for (const Caso& caso : casos) {
+        for (int n : { 1, 2, 3, 7, 100, 10000 }) {
+            const std::vector<std::string_view> partes = dividirTextoUtf8(caso.texto, n);
+            std::string juntas;
+            for (size_t i = 0; i < partes.size(); ++i) {
+                juntas += partes[i];
+                if (partes[i].empty()) falha(caso, n, "parte vazia");
+                else if (ehContinuacaoUtf8(partes[i].front())) falha(caso, n, "parte comea no meio de um caractere");
+                else if (caso.linhasCurtas && n <= 100 && i + 1 < partes.size() && partes[i].back() != '\n') {
+                    falha(caso, n, "parte no termina em fim de linha");
+                }
+            }
+            if (juntas != caso.texto) falha(caso, n, "as partes no reconstituem o texto");
+            if (static_cast<int>(partes.size()) > n) falha(caso, n, "partes demais");
+        }
+    }
+
+    const std::filesystem::path temporario = std::filesystem::temp_directory_path() / "dividir_teste_streaming";
+    std::filesystem::remove_all(temporario);
+    std::filesystem::create_directories(temporario);
+    const std::string entrada = (temporario / "entrada.txt").string();
+    for (const Caso& caso : casos) {
+        std::ofstream(entrada, std::ios::binary) << caso.texto;
+        for (CriterioDeCorte criterio : { CriterioDeCorte::Bytes, CriterioDeCorte::Linhas, CriterioDeCorte::Conteudo }) {
+            for (std::uint64_t limite : { 1, 5, 100, 4096 }) {
+                for (size_t tamanhoDoBloco : { 1, 7, 4096 }) {
+                    const std::string saida = (temporario / "partes").string();
+                    std::filesystem::remove_all(saida);
+#ifdef _WIN32
+                    const int fd = _open(entrada.c_str(), _O_RDONLY | _O_BINARY);
+#else
+                    const int fd = open(entrada.c_str(), O_RDONLY);
+#endif
+                    const ResultadoStreaming r = dividirStreaming(fd, criterio, limite, saida, tamanhoDoBloco);
+#ifdef _WIN32
+                    _close(fd);
+#else
+                    close(fd);
+#endif
+                    const int n = static_cast<int>(limite);
+                    std::string juntas;
+                    for (size_t i = 0; i < r.partes; ++i) {
+                        std::stringstream nome;
+                        nome << saida << "/parte_" << std::setw(3) << std::setfill('0') << (i + 1) << ".txt";
+                        std::ifstream arquivo(nome.str(), std::ios::binary);
+                        const std::string parte((std::istreambuf_iterator<char>(arquivo)), std::istreambuf_iterator<char>());
+                        juntas += parte;
+                        const bool ultima = (i + 1 == r.partes);
+                        if (parte.empty()) falha(caso, n, "streaming: parte vazia");
+                        else if (ehContinuacaoUtf8(parte.front())) falha(caso, n, "streaming: parte comea no meio de um caractere");
+                        else if (criterio == CriterioDeCorte::Linhas) {
+                            const auto linhas = static_cast<std::uint64_t>(std::count(parte.begin(), parte.end(), '\n'));
+                            if (ultima ? linhas > limite : (linhas != limite || parte.back() != '\n')) {
+                                falha(caso, n, "streaming: nmero de linhas errado");
+                            }
+                        }
+                        else if (criterio == CriterioDeCorte::Conteudo) {
+                            if (!ultima && (parte.length() < std::max<std::uint64_t>(limite / 4, 1) || parte.length() > 4 * limite + 3)) {
+                                falha(caso, n, "streaming: parte por contedo com " + std::to_string(parte.length()) + " bytes");
+                            }
+                        }
+                        else if (!ultima && (parte.length() < limite || parte.length() > 2 * limite + 3)) {
+                            falha(caso, n, "streaming: parte com " + std::to_string(parte.length()) + " bytes");
+                        }
+                        else if (!ultima && caso.linhasCurtas && limite >= 100 && parte.back() != '\n') {
+                            falha(caso, n, "streaming: parte no termina em fim de linha");
+                        }
+                    }
+                    if (juntas != caso.texto || r.bytes != caso.texto.length()) {
+                        falha(caso, n, "streaming: as partes no reconstituem o texto");
+                    }
+                    if (verificarManifesto(saida, false) != 0) {
+                        falha(caso, n, "streaming: manifesto no confere com as partes");
+                    }
+                }
+            }
+        }
+    }
+    std::filesystem::remove_all(temporario);
+
+    const Caso crc{ "CRC32C", "123456789", false };
+    if (crc32c::atualizar(0, crc.texto.data(), crc.texto.length()) != 0xE3069283u) falha(crc, 0, "valor de referncia");
+    std::mt19937 rng(7);
+    std::string aleatorio(4096, '\0');
+    for (char& c : aleatorio) c = static_cast<char>(rng());
+    for (size_t inicio = 0; inicio < 16; ++inicio) {
+        for (size_t tamanho : { 0, 1, 7, 8, 9, 63, 1000, 4000 }) {
+            const auto* p = reinterpret_cast<const unsigned char*>(aleatorio.data() + inicio);
+            const std::uint32_t emPartes = crc32c::atualizar(crc32c::atualizar(0, p, tamanho / 3), p + tamanho / 3, tamanho - tamanho / 3);
+            if (crc32c::hardware(~0u, p, tamanho) != crc32c::software(~0u, p, tamanho)
+                || emPartes != crc32c::atualizar(0, p, tamanho)) {
+                falha(crc, static_cast<int>(tamanho), "hardware, software e soma incremental diferem");
+            }
+        }
+    }
+
+    std::cout << "Testes da divisao UTF-8: " << (falhas == 0 ? "PASSARAM" : "FALHARAM") << std::endl;
+    return falhas;
+}
+
+/**
+ * @brief Decodifica o texto inteiro para UTF-32, como a variante Melhor1 faz (para UTF-16) antes de dividir.
+ *
+ * Usada s no benchmark, para medir o custo de decodificar tudo contra o de olhar apenas os bytes
+ * perto dos cortes.
+ */
+std::u32string decodificarUtf8(std::string_view texto) {
+    std::u32string saida;
+    saida.reserve(texto.length());
+    for (size_t i = 0; i < texto.length();) {
+        const unsigned char c = static_cast<unsigned char>(texto[i]);
+        const int n = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+        char32_t cp = n == 1 ? c : c & (0x7F >> n);
+        for (int j = 1; j < n && i + j < texto.length(); ++j) {
+            cp = (cp << 6) | (static_cast<unsigned char>(texto[i + j]) & 0x3F);
+        }
+        saida.push_back(cp);
+        i += n;
+    }
+    return saida;
+}
+
+/**
+ * @brief Gera `megabytes` MB de texto UTF-8 com palavras de 1 a 4 bytes por caractere (sempre o mesmo texto).
+ */
+std::string gerarTextoUtf8(size_t megabytes) {
+    // Palavras de 1 a 4 bytes por caractere, em UTF-8: guerra, paz, ao, corao, japons, emoji, russo, euro.
+    const char* palavras[] = { "guerra ", "paz ", "a\xC3\xA7\xC3\xA3o ", "cora\xC3\xA7\xC3\xA3o ", "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E ",
+        "\xF0\x9F\x99\x82 ", "\xD0\x9C\xD0\xBE\xD1\x81\xD0\xBA\xD0\xB2\xD0\xB0 ", "\xE2\x82\xAC " };
+    std::mt19937 rng(42);
+    std::string texto;
+    texto.reserve(megabytes << 20);
+    while (texto.length() < (megabytes << 20)) {
+        texto += palavras[rng() % std::size(palavras)];
+        if (rng() % 12 == 0) texto += '\n';
+    }
+    return texto;
+}
+
+/**
+ * @brief Compara a vazo (GB/s) das formas de dividir `megabytes` MB de texto UTF-8 em 100 partes.
+ *
+ * - `dividirTexto`: cortes em bytes crus, cada parte copiada com `substr` (pode cortar caracteres);
+ * - decodificar tudo e dividir: o custo mnimo da converso para texto largo usada pela Melhor1;
+ * - `dividirTextoUtf8`: cortes ajustados olhando s os bytes perto de cada corte, sem cpias.
+ */
+void benchDivisao(size_t megabytes) {
+    const std::string texto = gerarTextoUtf8(megabytes);
+
+    auto mede = [&](const char* nome, auto&& dividir) {
+        double melhor = 0.0;
+        size_t partes = 0;
+        for (int r = 0; r < 3; ++r) {
+            const auto t0 = std::chrono::steady_clock::now();
+            partes = dividir();
+            const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            melhor = (r == 0) ? s : std::min(melhor, s);
+        }
+        std::cout << std::left << std::setw(36) << nome << std::right << std::fixed << std::setprecision(3)
+            << std::setw(10) << melhor * 1000.0 << " ms " << std::setw(9) << static_cast<double>(texto.length()) / 1e9 / melhor
+            << " GB/s  (" << partes << " partes)" << std::endl;
+    };
+    std::cout << "Texto UTF-8 de " << texto.length() << " bytes, 100 partes:" << std::endl;
+    mede("bytes crus + substr", [&] { return dividirTexto(texto, 100).size(); });
+    mede("decodificar tudo + dividir", [&] {
+        const std::u32string largo = decodificarUtf8(texto);
+        std::vector<std::u32string_view> partes;
+        for (size_t i = 0; i < 100; ++i) {
+            partes.push_back(std::u32string_view(largo).substr(i * (largo.length() / 100), largo.length() / 100));
+        }
+        return partes.size();
+    });
+    mede("dividirTextoUtf8 (so os cortes)", [&] { return dividirTextoUtf8(texto, 100).size(); });
+}
+
+/**
+ * @brief Compara os mtodos de gravao (ofstream, threads, io_uring) nas partes de `megabytes` MB de texto.
+ *
+ * Rode uma vez com `diretorio` em disco e outra em tmpfs (ex.: /dev/shm) para separar o custo das
+ * chamadas de sistema do custo do dispositivo.
+ */
+void benchGravacao(size_t megabytes, int numeroDePartes, const std::string& nome_diretorio) {
+    const std::string texto = gerarTextoUtf8(megabytes);
+    const std::vector<std::string_view> partes = dividirTextoUtf8(texto, numeroDePartes);
+    std::filesystem::create_directories(nome_diretorio);
+    std::vector<gravacao::Pedido> pedidos;
+    for (size_t i = 0; i < partes.size(); ++i) {
+        std::stringstream ss;
+        ss << nome_diretorio << "/parte_" << std::setw(3) << std::setfill('0') << (i + 1) << ".txt";
+        pedidos.push_back({ ss.str(), partes[i] });
+    }
+    std::cout << "Gravacao em " << nome_diretorio << ": ";
+    gravacao::compararMetodos(pedidos);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--teste") {
+        return executarTestes() == 0 ? 0 : 1;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--stream") {
+        try {
+            return executarStreaming(argc, argv);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Erro: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    if (argc > 2 && std::string(argv[1]) == "--verificar") {
+        try {
+            return verificarManifesto(argv[2]) == 0 ? 0 : 1;
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Erro: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    if (argc > 1 && std::string(argv[1]) == "--bench-gravacao") {
+        try {
+            benchGravacao(argc > 2 ? std::stoul(argv[2]) : 256, argc > 3 ? std::stoi(argv[3]) : 100,
+                argc > 4 ? argv[4] : "textos_divididos");
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Erro: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        benchDivisao(argc > 2 ? std::stoul(argv[2]) : 256);
+        return 0;
+    }
+
+    // --- Modo padro: [--gravacao <metodo>] [arquivo]. Sem arquivo, baixa o texto (s no Windows) ---
     const int NUMERO_DE_PARTES = 100;
     const std::string nome_diretorio = "textos_divididos"; // Nome da pasta de sada
+    gravacao::Metodo metodo = gravacao::Metodo::Ofstream;
+    int proximo = 1;
 
     try {
+        if (argc > 2 && std::string(argv[1]) == "--gravacao") {
+            metodo = gravacao::metodoPorNome(argv[2]);
+            proximo = 3;
+        }
+        const std::string arquivo = argc > proximo ? argv[proximo] : "";
+#ifndef _WIN32
+        if (arquivo.empty()) {
+            std::cerr << "O download usa WinINet e so esta disponivel no Windows; informe um arquivo ([--gravacao <ofstream|threads|io_uring>] <arquivo>) "
+                "ou use --stream, --verificar <diretorio>, --teste, --bench [MB] ou --bench-gravacao [MB] [partes] [diretorio]." << std::endl;
+            return 1;
+        }
+#endif
+
         // --- NOVO: Cria o diretrio para salvar os arquivos ---
         std::cout << "Criando diretorio de saida: " << nome_diretorio << std::endl;
         std::filesystem::create_directory(nome_diretorio);
 
-        std::cout << "Baixando o texto de: " << std::string(url.begin(), url.end()) << "..." << std::endl;
-        std::string textoCompleto = baixarTexto(url);
+        std::string textoCompleto;
+        if (!arquivo.empty()) {
+            std::cout << "Lendo o texto de: " << arquivo << "..." << std::endl;
+            std::ifstream entrada(arquivo, std::ios::binary);
+            if (!entrada) throw std::runtime_error("Erro ao abrir o arquivo: " + arquivo);
+            textoCompleto.assign(std::istreambuf_iterator<char>(entrada), std::istreambuf_iterator<char>());
+        }
+#ifdef _WIN32
+        else {
+            const std::wstring url = L"https://www.gutenberg.org/files/1342/1342-0.txt"; // Pride and Prejudice
+            std::cout << "Baixando o texto de: " << std::string(url.begin(), url.end()) << "..." << std::endl;
+            textoCompleto = baixarTexto(url);
+            std::cout << "Download concluido. ";
+        }
+#endif
 
-        std::cout << "Download concluido. Total de " << textoCompleto.length() << " bytes." << std::endl;
+        std::cout << "Total de " << textoCompleto.length() << " bytes." << std::endl;
         std::cout << "Dividindo o texto em " << NUMERO_DE_PARTES << " partes..." << std::endl;
 
-        std::vector<std::string> textosMenores = dividirTexto(textoCompleto, NUMERO_DE_PARTES);
+        // --- ALTERADO: diviso em duas fases (cortes em fim de linha ou de caractere, depois gravao pelo mtodo escolhido) ---
+        std::vector<std::string_view> textosMenores = dividirTextoUtf8(textoCompleto, NUMERO_DE_PARTES);
 
         std::cout << "Divisao concluida. Salvando arquivos..." << std::endl;
 
-        // --- ALTERADO: Loop para salvar cada parte em um arquivo ---
-        for (int i = 0; i < textosMenores.size(); ++i) {
-            // Constri o nome do arquivo com zero  esquerda (ex: parte_001.txt)
-            std::stringstream ss;
-            ss << nome_diretorio << "/parte_"
-                << std::setw(3) << std::setfill('0') << (i + 1)
-                << ".txt";
-            std::string nome_arquivo = ss.str();
-
-            // Abre o arquivo para escrita
-            std::ofstream arquivo_saida(nome_arquivo);
-            if (!arquivo_saida.is_open()) {
-                std::cerr << "Erro ao criar o arquivo: " << nome_arquivo << std::endl;
-                continue; // Pula para a prxima iterao
-            }
-
-            // Escreve o contedo da parte no arquivo
-            arquivo_saida << textosMenores[i];
-
-            // O arquivo  fechado automaticamente quando 'arquivo_saida' sai de escopo
-        }
+        const gravacao::Estatisticas gravacao = salvarPartes(textosMenores, nome_diretorio, metodo);
 
-        std::cout << "\n" << textosMenores.size() << " arquivos foram salvos com sucesso no diretorio '" << nome_diretorio << "'." << std::endl;
+        std::cout << "\n" << gravacao.arquivos << " arquivos foram salvos com sucesso no diretorio '" << nome_diretorio
+            << "' em " << gravacao.segundos * 1000.0 << " ms (" << gravacao::nome(gravacao.metodo) << ", "
+            << gravacao.chamadasDeSistema << " chamadas de sistema)." << std::endl;
 
     }
     catch (const std::exception& e) { // Usando std::exception para pegar tambm erros do filesystem
@@ -0,0 +1,538 @@
+/**
+ * @file GravadorDePartes.h
+ * @brief Gravao em lote das partes geradas pelos divisores de texto.
+ *
+ * Os dois divisores (DividirArquivoTexto e DividirArquivoTexto_Melhor1) terminam do mesmo jeito: uma lista
+ * de arquivos novos, cada um com um trecho de memria (texto baixado ou arquivo mapeado). Este cabealho
+ * oferece trs formas de grav-los, com as mesmas garantias e as mesmas estatsticas:
+ * - `Metodo::Ofstream`: um `std::ofstream` por parte, em sequncia (o caminho original);
+ * - `Metodo::Threads`: `open`/`write`/`close` (ou `CreateFile`/`WriteFile`) distribudos entre threads;
+ * - `Metodo::IoUring` (Linux): `openat`, `write` e `close` de cada parte encadeados em um anel io_uring,
+ *   com vrias partes em voo e uma nica chamada `io_uring_enter` por lote.
+ *
+ * O io_uring  usado direto pelas chamadas de sistema (sem liburing) e exige kernel 5.19 ou mais novo
+ * (descritores diretos alocados pelo prprio `openat`); `gravar` cai para `Metodo::Threads` quando ele no
+ * est disponvel, inclusive no Windows.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace gravacao {
+
+/**
+ * @brief Um arquivo a criar (ou truncar) com o contedo `dados`, que precisa continuar vlido at o fim da gravao.
+ */
+struct Pedido {
+    std::string caminho;
+    std::string_view dados;
+};
+
+/**
+ * @brief Forma de gravar os arquivos.
+ */
+enum class Metodo {
+    Ofstream, ///< Um std::ofstream por arquivo, em sequncia.
+    Threads,  ///< Chamadas de sistema diretas, arquivos distribudos entre threads.
+    IoUring,  ///< Operaes assncronas encadeadas em um anel io_uring (Linux).
+};
+
+/**
+ * @brief Resultado de uma gravao.
+ */
+struct Estatisticas {
+    Metodo metodo = Metodo::Ofstream;  ///< Mtodo realmente usado (pode diferir do pedido, aps um fallback).
+    size_t arquivos = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t chamadasDeSistema = 0; ///< Chamadas feitas pelo gravador (estimadas no mtodo Ofstream).
+    double segundos = 0.0;
+};
+
+[[nodiscard]] inline std::string_view nome(Metodo metodo) {
+    switch (metodo) {
+    case Metodo::Ofstream: return "ofstream";
+    case Metodo::Threads: return "threads";
+    case Metodo::IoUring: return "io_uring";
+    }
+    return "?";
+}
+
+/**
+ * @brief Inverso de `nome`: converte "ofstream", "threads" ou "io_uring" no mtodo.
+ * @throws std::invalid_argument Se o nome no for de nenhum mtodo.
+ */
+[[nodiscard]] inline Metodo metodoPorNome(std::string_view texto) {
+    for (Metodo m : { Metodo::Ofstream, Metodo::Threads, Metodo::IoUring }) {
+        if (nome(m) == texto) return m;
+    }
+    throw std::invalid_argument("Metodo de gravacao desconhecido: " + std::string(texto) + " (use ofstream, threads ou io_uring)");
+}
+
+// =========================== Ofstream ===========================
+
+/**
+ * @brief Grava os arquivos em sequncia, cada um com um `std::ofstream` novo.
+ *
+ * As chamadas de sistema no so observveis de dentro da biblioteca padro; a contagem assume o
+ * comportamento da libstdc++ e da MSVC STL para uma escrita grande em `std::ios::binary`: `open`,
+ * uma escrita por GB e `close`.
+ */
+inline Estatisticas gravarComOfstream(const std::vector<Pedido>& pedidos) {
+    const auto inicio = std::chrono::steady_clock::now();
+    Estatisticas e;
+    e.metodo = Metodo::Ofstream;
+    for (const Pedido& p : pedidos) {
+        std::ofstream saida(p.caminho, std::ios::binary | std::ios::trunc);
+        if (!saida.is_open()) {
+            throw std::runtime_error("Erro ao criar o arquivo: " + p.caminho);
+        }
+        saida.write(p.dados.data(), static_cast<std::streamsize>(p.dados.size()));
+        saida.close();
+        if (!saida) {
+            throw std::runtime_error("Erro ao gravar o arquivo: " + p.caminho);
+        }
+        e.chamadasDeSistema += 2 + std::max<std::uint64_t>(1, (p.dados.size() + (1u << 30) - 1) >> 30);
+        e.bytes += p.dados.size();
+        ++e.arquivos;
+    }
+    e.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    return e;
+}
+
+// =========================== Threads ===========================
+
+/**
+ * @brief Cria o arquivo e grava `dados` com chamadas de sistema diretas, contando-as em `chamadas`.
+ * @throws std::runtime_error Se o arquivo no puder ser criado ou gravado.
+ */
+inline void gravarArquivo(const Pedido& p, std::atomic<std::uint64_t>& chamadas) {
+#ifdef _WIN32
+    const HANDLE saida = CreateFileA(p.caminho.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    chamadas.fetch_add(1, std::memory_order_relaxed);
+    if (saida == INVALID_HANDLE_VALUE) throw std::runtime_error("Erro ao criar o arquivo: " + p.caminho);
+    for (size_t gravados = 0; gravados < p.dados.size();) {
+        DWORD escritos = 0;
+        const DWORD pedaco = static_cast<DWORD>(std::min<size_t>(p.dados.size() - gravados, 1u << 30));
+        chamadas.fetch_add(1, std::memory_order_relaxed);
+        if (!WriteFile(saida, p.dados.data() + gravados, pedaco, &escritos, nullptr) || escritos == 0) {
+            CloseHandle(saida);
+            throw std::runtime_error("Erro ao gravar o arquivo: " + p.caminho);
+        }
+        gravados += escritos;
+    }
+    chamadas.fetch_add(1, std::memory_order_relaxed);
+    CloseHandle(saida);
+#else
+    const int saida = open(p.caminho.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    chamadas.fetch_add(1, std::memory_order_relaxed);
+    if (saida < 0) throw std::runtime_error("Erro ao criar o arquivo: " + p.caminho);
+    for (size_t gravados = 0; gravados < p.dados.size();) {
+        const ssize_t n = write(saida, p.dados.data() + gravados, p.dados.size() - gravados);
+        chamadas.fetch_add(1, std::memory_order_relaxed);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            close(saida);
+            throw std::runtime_error("Erro ao gravar o arquivo: " + p.caminho);
+        }
+        gravados += static_cast<size_t>(n);
+    }
+    chamadas.fetch_add(1, std::memory_order_relaxed);
+    if (close(saida) != 0) throw std::runtime_error("Erro ao gravar o arquivo: " + p.caminho);
+#endif
+}
+
+/**
+ * @brief Grava os arquivos com `threads` threads (0 = nmero de CPUs), que retiram pedidos de um contador atmico.
+ *
+ * O primeiro erro  relanado depois que todas as threads terminam.
+ */
+inline Estatisticas gravarComThreads(const std::vector<Pedido>& pedidos, unsigned threads = 0) {
+    const auto inicio = std::chrono::steady_clock::now();
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::atomic<size_t> proximo{ 0 };
+    std::atomic<std::uint64_t> chamadas{ 0 };
+    std::atomic<bool> falhou{ false };
+    std::exception_ptr primeiroErro;
+    auto trabalhador = [&]() {
+        for (size_t i = proximo.fetch_add(1); i < pedidos.size() && !falhou; i = proximo.fetch_add(1)) {
+            try {
+                gravarArquivo(pedidos[i], chamadas);
+            }
+            catch (...) {
+                if (!falhou.exchange(true)) primeiroErro = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < std::min<size_t>(threads, pedidos.size()); ++t) pool.emplace_back(trabalhador);
+    trabalhador(); // a thread que chamou tambm grava
+    for (std::thread& t : pool) t.join();
+    if (primeiroErro) std::rethrow_exception(primeiroErro);
+
+    Estatisticas e;
+    e.metodo = Metodo::Threads;
+    e.arquivos = pedidos.size();
+    for (const Pedido& p : pedidos) e.bytes += p.dados.size();
+    e.chamadasDeSistema = chamadas.load();
+    e.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    return e;
+}
+
+// =========================== io_uring ===========================
+
+#ifdef __linux__
+
+/**
+ * @class AnelIoUring
+ * @brief Anel io_uring mnimo (RAII sobre `io_uring_setup`, os trs `mmap` e o `close`).
+ *
+ * S o necessrio para o gravador: obter SQEs livres, publicar o *tail* da fila de submisso, chamar
+ * `io_uring_enter` e consumir CQEs. As posies compartilhadas com o kernel so acessadas com
+ * `std::atomic_ref` (*acquire* ao ler o que o kernel escreveu, *release* ao publicar).
+ */
+class AnelIoUring {
+public:
+    /**
+     * @brief Cria o anel com `entradas` SQEs e uma tabela esparsa de `arquivosFixos` descritores diretos.
+     * @throws std::runtime_error Se o kernel no suportar io_uring ou descritores diretos.
+     */
+    AnelIoUring(unsigned entradas, unsigned arquivosFixos) {
+        io_uring_params params{};
+        fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entradas, &params));
+        ++chamadas_;
+        if (fd_ < 0) throw std::runtime_error("io_uring_setup falhou");
+
+        tamanhoSq_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        tamanhoCq_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool unico = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (unico) tamanhoSq_ = tamanhoCq_ = std::max(tamanhoSq_, tamanhoCq_);
+        sq_ = mmap(nullptr, tamanhoSq_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        cq_ = unico ? sq_ : mmap(nullptr, tamanhoCq_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+        tamanhoSqes_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, tamanhoSqes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        chamadas_ += unico ? 2 : 3;
+        if (sq_ == MAP_FAILED || cq_ == MAP_FAILED || sqes == MAP_FAILED) {
+            if (sqes != MAP_FAILED) munmap(sqes, tamanhoSqes_);
+            libera();
+            throw std::runtime_error("mmap do anel io_uring falhou");
+        }
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<char*>(sq_);
+        auto* cq = static_cast<char*>(cq_);
+        sqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        entradas_ = params.sq_entries;
+        for (unsigned i = 0; i < entradas_; ++i) sqArray_[i] = i; // SQE i sempre na posio i do anel
+
+        io_uring_rsrc_register tabela{};
+        tabela.nr = arquivosFixos;
+        tabela.flags = IORING_RSRC_REGISTER_SPARSE;
+        ++chamadas_;
+        if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_FILES2, &tabela, sizeof(tabela)) < 0) {
+            libera();
+            throw std::runtime_error("io_uring sem suporte a descritores diretos");
+        }
+    }
+
+    AnelIoUring(const AnelIoUring&) = delete;
+    AnelIoUring& operator=(const AnelIoUring&) = delete;
+
+    ~AnelIoUring() { libera(); }
+
+    /// SQEs que ainda cabem na fila de submisso.
+    [[nodiscard]] unsigned livres() const noexcept { return entradas_ - (local_ - std::atomic_ref(*sqHead_).load(std::memory_order_acquire)); }
+
+    /// Prxima SQE, zerada; s  vista pelo kernel depois de `submete`.
+    io_uring_sqe& proxima() noexcept {
+        io_uring_sqe& sqe = sqes_[local_++ & sqMask_];
+        sqe = io_uring_sqe{};
+        return sqe;
+    }
+
+    /**
+     * @brief Publica as SQEs preparadas e espera at `minimo` concluses (uma chamada `io_uring_enter`).
+     * @throws std::runtime_error Se `io_uring_enter` falhar.
+     */
+    void submete(unsigned minimo) {
+        const unsigned tail = *sqTail_;
+        const unsigned novas = local_ - tail;
+        std::atomic_ref(*sqTail_).store(local_, std::memory_order_release);
+        for (;;) {
+            ++chamadas_;
+            const long r = syscall(__NR_io_uring_enter, fd_, novas, minimo, minimo ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            if (r >= 0) return;
+            if (errno != EINTR) throw std::runtime_error("io_uring_enter falhou");
+        }
+    }
+
+    /// Consome as concluses disponveis, chamando `f(user_data, res)` para cada uma.
+    template <typename F>
+    void colhe(F&& f) {
+        unsigned head = *cqHead_;
+        const unsigned tail = std::atomic_ref(*cqTail_).load(std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes_[head & cqMask_];
+            f(cqe.user_data, cqe.res);
+        }
+        std::atomic_ref(*cqHead_).store(head, std::memory_order_release);
+    }
+
+    [[nodiscard]] std::uint64_t chamadas() const noexcept { return chamadas_; }
+
+private:
+    void libera() noexcept {
+        if (sqes_) munmap(sqes_, tamanhoSqes_);
+        if (cq_ && cq_ != MAP_FAILED && cq_ != sq_) munmap(cq_, tamanhoCq_);
+        if (sq_ && sq_ != MAP_FAILED) munmap(sq_, tamanhoSq_);
+        if (fd_ >= 0) close(fd_);
+        sqes_ = nullptr;
+        sq_ = cq_ = nullptr;
+        fd_ = -1;
+    }
+
+    int fd_ = -1;
+    void* sq_ = nullptr;
+    void* cq_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t tamanhoSq_ = 0;
+    size_t tamanhoCq_ = 0;
+    size_t tamanhoSqes_ = 0;
+    unsigned* sqHead_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned* sqArray_ = nullptr;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned cqMask_ = 0;
+    unsigned entradas_ = 0;
+    unsigned local_ = 0;              ///< Tail local: SQEs preparadas, publicadas ou no.
+    std::uint64_t chamadas_ = 0;      ///< Chamadas de sistema feitas pelo anel.
+};
+
+#endif // __linux__
+
+/**
+ * @brief Diz se este sistema consegue gravar com `Metodo::IoUring` (anel e descritores diretos).
+ */
+[[nodiscard]] inline bool ioUringDisponivel() {
+#ifdef __linux__
+    static const bool disponivel = [] {
+        try {
+            AnelIoUring anel(4, 1);
+            return true;
+        }
+        catch (const std::exception&) {
+            return false;
+        }
+    }();
+    return disponivel;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Maior arquivo que `gravarComIoUring` aceita: 63 escritas de 1 GiB (o ndice da escrita ocupa 6 bits
+ *        do `user_data` e o `len` de uma SQE tem 32 bits).
+ */
+inline constexpr std::uint64_t kMaximoPorArquivoIoUring = std::uint64_t{ 63 } << 30;
+
+/**
+ * @brief Diz se todos os pedidos cabem no gravador io_uring (nenhum maior que `kMaximoPorArquivoIoUring`).
+ */
+[[nodiscard]] inline bool cabeNoIoUring(const std::vector<Pedido>& pedidos) {
+    return std::all_of(pedidos.begin(), pedidos.end(),
+        [](const Pedido& p) { return p.dados.size() <= kMaximoPorArquivoIoUring; });
+}
+
+/**
+ * @brief Grava os arquivos por um anel io_uring, com at `emVoo` arquivos em andamento ao mesmo tempo.
+ *
+ * Cada arquivo vira uma cadeia `openat -> write... -> close` (SQEs ligadas por `IOSQE_IO_LINK`) sobre um
+ * descritor direto: o `openat` instala o arquivo na posio `k` da tabela registrada e as escritas e o
+ * `close` usam a mesma posio, sem que o programa precise ver o descritor. Cadeias de arquivos diferentes
+ * correm em paralelo no kernel; o programa s volta a chamar `io_uring_enter` quando precisa de espao no
+ * anel ou de uma posio livre, ento o nmero de chamadas de sistema cai de ~3 por arquivo para poucas
+ * por lote.
+ *
+ * @throws std::runtime_error Se o io_uring no estiver disponvel, se algum arquivo passar de
+ *         `kMaximoPorArquivoIoUring` (verificado antes de qualquer gravao) ou se alguma operao falhar
+ *         (depois de esperar todas as operaes em voo).
+ */
+inline Estatisticas gravarComIoUring(const std::vector<Pedido>& pedidos, unsigned emVoo = 64) {
+#ifdef __linux__
+    for (const Pedido& p : pedidos) {
+        if (p.dados.size() > kMaximoPorArquivoIoUring) throw std::runtime_error("Arquivo grande demais para o gravador io_uring: " + p.caminho);
+    }
+    const auto inicio = std::chrono::steady_clock::now();
+    constexpr size_t kPedacoMaximo = size_t{ 1 } << 30; // `len` de uma SQE tem 32 bits
+    emVoo = std::max(1u, emVoo);
+    AnelIoUring anel(256, emVoo);
+
+    // user_data = (ndice do pedido << 8) | (pedao << 2) | operao. Os elos so IOSQE_IO_HARDLINK: mesmo
+    // que o openat ou uma escrita falhe, o close da cadeia roda e a posio volta a ficar livre quando
+    // todas as CQEs da cadeia chegarem.
+    enum : std::uint64_t { kOpen = 0, kWrite = 1, kClose = 2 };
+    std::vector<unsigned> pendentes(pedidos.size(), 0);
+    std::vector<unsigned> posicaoDoPedido(pedidos.size(), 0);
+    std::vector<unsigned> posicoesLivres;
+    for (unsigned k = emVoo; k > 0; --k) posicoesLivres.push_back(k - 1);
+    std::string erro;
+    size_t cqesFaltando = 0;
+
+    auto trata = [&](std::uint64_t dados, std::int32_t res) {
+        const size_t i = static_cast<size_t>(dados >> 8);
+        const size_t deslocamento = static_cast<size_t>((dados >> 2) & 63) * kPedacoMaximo;
+        const std::uint64_t operacao = dados & 3;
+        const bool curta = operacao == kWrite
+            && static_cast<size_t>(res) != std::min(kPedacoMaximo, pedidos[i].dados.size() - deslocamento);
+        if ((res < 0 || curta) && erro.empty()) {
+            erro = std::string(operacao == kOpen ? "Erro ao criar o arquivo: " : "Erro ao gravar o arquivo: ") + pedidos[i].caminho;
+        }
+        --cqesFaltando;
+        if (--pendentes[i] == 0) posicoesLivres.push_back(posicaoDoPedido[i]);
+    };
+
+    size_t proximo = 0;
+    size_t emAndamento = 0;
+    while ((proximo < pedidos.size() && erro.empty()) || emAndamento > 0) {
+        while (proximo < pedidos.size() && !posicoesLivres.empty() && erro.empty()) {
+            const Pedido& p = pedidos[proximo];
+            const size_t pedacos = (p.dados.size() + kPedacoMaximo - 1) / kPedacoMaximo;
+            if (anel.livres() < pedacos + 2) break;
+            const unsigned posicao = posicoesLivres.back();
+            posicoesLivres.pop_back();
+            posicaoDoPedido[proximo] = posicao;
+            pendentes[proximo] = static_cast<unsigned>(pedacos + 2);
+            cqesFaltando += pedacos + 2;
+
+            io_uring_sqe& abre = anel.proxima();
+            abre.opcode = IORING_OP_OPENAT;
+            abre.fd = AT_FDCWD;
+            abre.addr = reinterpret_cast<std::uint64_t>(p.caminho.c_str());
+            abre.len = 0644;
+            abre.open_flags = O_WRONLY | O_CREAT | O_TRUNC;
+            abre.file_index = posicao + 1; // posio na tabela registrada, +1 (0 = descritor comum)
+            abre.flags = IOSQE_IO_HARDLINK;
+            abre.user_data = (proximo << 8) | kOpen;
+            for (size_t k = 0; k < pedacos; ++k) {
+                const size_t deslocamento = k * kPedacoMaximo;
+                io_uring_sqe& escreve = anel.proxima();
+                escreve.opcode = IORING_OP_WRITE;
+                escreve.fd = static_cast<std::int32_t>(posicao);
+                escreve.flags = IOSQE_FIXED_FILE | IOSQE_IO_HARDLINK;
+                escreve.addr = reinterpret_cast<std::uint64_t>(p.dados.data() + deslocamento);
+                escreve.len = static_cast<std::uint32_t>(std::min(kPedacoMaximo, p.dados.size() - deslocamento));
+                escreve.off = deslocamento;
+                escreve.user_data = (proximo << 8) | (k << 2) | kWrite;
+            }
+            io_uring_sqe& fecha = anel.proxima();
+            fecha.opcode = IORING_OP_CLOSE;
+            fecha.file_index = posicao + 1;
+            fecha.user_data = (proximo << 8) | kClose;
+            ++proximo;
+            ++emAndamento;
+        }
+        // Tudo o que cabia foi preparado: publica e espera at metade das cadeias em voo terminar, para que a
+        // prxima rodada tenha vrias posies livres (uma chamada por lote, no uma por arquivo).
+        // Espera no mximo pelas CQEs que ainda faltam (uma cadeia pode j ter entregado parte das suas).
+        anel.submete(static_cast<unsigned>(std::min<size_t>(cqesFaltando, std::max(1u, emVoo / 2) * 3)));
+        const size_t livresAntes = posicoesLivres.size();
+        anel.colhe(trata);
+        emAndamento -= posicoesLivres.size() - livresAntes;
+    }
+    if (!erro.empty()) throw std::runtime_error(erro);
+
+    Estatisticas e;
+    e.metodo = Metodo::IoUring;
+    e.arquivos = pedidos.size();
+    for (const Pedido& p : pedidos) e.bytes += p.dados.size();
+    e.chamadasDeSistema = anel.chamadas();
+    e.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    return e;
+#else
+    (void)pedidos;
+    (void)emVoo;
+    throw std::runtime_error("io_uring so existe no Linux");
+#endif
+}
+
+/**
+ * @brief Grava os arquivos com o mtodo pedido; `IoUring` cai para `Threads` se no estiver disponvel ou
+ *        se algum arquivo for maior que `kMaximoPorArquivoIoUring`.
+ */
+inline Estatisticas gravar(const std::vector<Pedido>& pedidos, Metodo metodo, unsigned threads = 0) {
+    if (metodo == Metodo::IoUring && (!ioUringDisponivel() || !cabeNoIoUring(pedidos))) metodo = Metodo::Threads;
+    switch (metodo) {
+    case Metodo::Ofstream: return gravarComOfstream(pedidos);
+    case Metodo::Threads: return gravarComThreads(pedidos, threads);
+    case Metodo::IoUring: return gravarComIoUring(pedidos);
+    }
+    return {};
+}
+
+/**
+ * @brief Grava os mesmos arquivos com cada mtodo (melhor de 3) e mostra tempo, vazo e chamadas de sistema.
+ */
+inline void compararMetodos(const std::vector<Pedido>& pedidos) {
+    std::uint64_t bytes = 0;
+    for (const Pedido& p : pedidos) bytes += p.dados.size();
+    std::cout << pedidos.size() << " arquivos, " << bytes << " bytes" << std::endl;
+    for (Metodo metodo : { Metodo::Ofstream, Metodo::Threads, Metodo::IoUring }) {
+        if (metodo == Metodo::IoUring && !ioUringDisponivel()) {
+            std::cout << std::left << std::setw(10) << nome(metodo) << std::right << "  indisponivel neste sistema" << std::endl;
+            continue;
+        }
+        Estatisticas melhor;
+        for (int r = 0; r < 3; ++r) {
+            const Estatisticas e = gravar(pedidos, metodo);
+            if (r == 0 || e.segundos < melhor.segundos) melhor = e;
+        }
+        std::cout << std::left << std::setw(10) << nome(metodo) << std::right << std::fixed << std::setprecision(3)
+            << std::setw(11) << melhor.segundos * 1000.0 << " ms" << std::setw(9)
+            << static_cast<double>(bytes) / 1e9 / std::max(melhor.segundos, 1e-9) << " GB/s"
+            << std::setw(9) << melhor.chamadasDeSistema << " chamadas de sistema"
+            << (metodo == Metodo::Ofstream ? " (estimadas)" : "") << std::endl;
+    }
+}
+
+} // namespace gravacao
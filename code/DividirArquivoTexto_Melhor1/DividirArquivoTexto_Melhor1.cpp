@@ -6,6 +6,17 @@
  * processar texto em streaming (sem carregar tudo na memória de uma vez) e salvar partes em arquivos.
  * Ele é projetado para rodar no Windows, usando o Visual Studio ou similar.
  *
+ * Se o primeiro argumento não for uma URL (http:// ou https://), ele é tratado como um arquivo local:
+ * o arquivo é mapeado em memória (`mmap` / `MapViewOfFile`), os pontos de corte são achados com
+ * `memchr` e cada parte é gravada direto do mapeamento, sem conversão para UTF-16. Esse modo também
+ * compila e roda em Linux/macOS. Com um quarto argumento (número de threads), as partes são gravadas
+ * em paralelo; `--bench-paralelo` compara a gravação sequencial com a paralela em vários números de threads,
+ * e `--bench-gravacao` compara ofstream, pool de threads e io_uring (GravadorDePartes.h, compartilhado com o
+ * DividirArquivoTexto) na gravação das mesmas partes. `--juntar` faz o caminho inverso: confere a sequência
+ * parte_001.txt, parte_002.txt, ... (e o manifesto.tsv, se houver), reserva o arquivo de saída com `fallocate`
+ * e copia as partes em paralelo, cada uma para o seu deslocamento, com `copy_file_range`/`splice`;
+ * `--bench-juncao` mede a ida e volta (divisão -> junção) contra uma junção ingênua com ifstream/ofstream.
+ *
  * Compilação: No Visual Studio, certifique-se de que o projeto está configurado para C++23 ou superior,
  * e que a biblioteca wininet.lib está linkada (o #pragma faz isso automaticamente no MSVC).
  * Além disso, você precisará configurar os comandos url, partes e nome do diretório direto nas opções do
@@ -18,7 +29,7 @@
 // Para manipular strings (sequências de caracteres), como std::string e std::wstring.
 #include <string>
 
-// Para vetores dinâmicos (arrays que crescem), embora não usado diretamente aqui, pode ser útil para extensões.
+// Para vetores dinâmicos (arrays que crescem), como a lista de partes do modo local.
 #include <vector>
 
 // Para lançar exceções em erros, como std::runtime_error.
@@ -39,8 +50,25 @@
 // Para algoritmos úteis, como std::find para procurar caracteres em strings.
 #include <algorithm> // Para std::find
 
-// Para funções de strings C, como std::strlen para medir comprimento de char*.
-#include <cstring> // Para strlen em main
+// Para funções de strings C, como std::strlen para medir comprimento de char* e std::memchr para achar '\n'.
+#include <cstring> // Para strlen em main e memchr no modo local
+
+// Para medir o tempo da divisão e calcular a vazão (GB/s).
+#include <chrono>
+
+// Para referências a trechos de texto sem cópia, como as partes dentro do arquivo mapeado.
+#include <string_view>
+
+// Para gravar as partes em paralelo: várias threads retiram partes de um contador atômico compartilhado.
+#include <atomic>
+#include <thread>
+#include <cstdint> // Para intptr_t (descritor ou HANDLE do arquivo remontado)
+
+#ifdef _WIN32
+// Evita que windows.h defina as macros min e max, que conflitam com std::min e std::max.
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
 
 // Cabeçalhos do Windows SDK para funcionalidades específicas do Windows.
 // Necessário para funções de sistema, como conversões de encoding e rede.
@@ -52,6 +80,19 @@
 // Diretiva para o linker incluir automaticamente a biblioteca wininet.lib no MSVC.
 // Isso evita configurar manualmente no projeto do Visual Studio.
 #pragma comment(lib, "wininet.lib")
+#else
+// Em sistemas POSIX (Linux, macOS), para abrir e mapear o arquivo local em memória (open, fstat, mmap).
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno> // Para errno, ao decidir se copy_file_range precisa ser trocado por pwrite
+#endif
+
+// Gravação em lote das partes (ofstream, pool de threads ou io_uring), compartilhada com o DividirArquivoTexto.
+#include "../DividirArquivoTexto/GravadorDePartes.h"
+
+#ifdef _WIN32
 
 /**
  * @brief Converte uma string em UTF-8 para uma wide string (wstring) usando APIs do Windows.
@@ -218,6 +259,808 @@ void baixarEDividirESalvar(const std::wstring& url, int numeroDePartes, const st
 
     std::cout << (parteAtual + 1) << " partes foram salvas com sucesso no diretorio '" << nome_diretorio << "'." << std::endl;
 }
+#endif // _WIN32
+
+// --- Modo local: arquivo mapeado em memória, cortes com memchr e gravação sem cópia ---
+
+/**
+ * @brief Arquivo local mapeado em memória, somente para leitura (RAII sobre mmap / MapViewOfFile).
+ *
+ * Para alunos iniciantes: mapear um arquivo faz o sistema operacional "colar" o conteúdo dele no espaço de
+ * endereços do programa. Os bytes são lidos do disco sob demanda, quando são acessados, e vêm direto do
+ * cache de páginas do sistema, sem passar por buffers intermediários do programa. Assim conseguimos olhar
+ * o arquivo inteiro como se fosse um grande array de char, sem carregá-lo para um std::string.
+ * O destrutor desfaz o mapeamento automaticamente (RAII).
+ */
+class ArquivoMapeado {
+public:
+    /**
+     * @brief Mapeia o arquivo inteiro.
+     * @param caminho Caminho do arquivo de entrada.
+     * @throw std::runtime_error Se o arquivo não puder ser aberto ou mapeado.
+     */
+    explicit ArquivoMapeado(const std::string& caminho) {
+#ifdef _WIN32
+        HANDLE arquivo = CreateFileA(caminho.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (arquivo == INVALID_HANDLE_VALUE) throw std::runtime_error("Nao foi possivel abrir " + caminho);
+        LARGE_INTEGER tamanho{};
+        if (!GetFileSizeEx(arquivo, &tamanho)) {
+            CloseHandle(arquivo);
+            throw std::runtime_error("Nao foi possivel obter o tamanho de " + caminho);
+        }
+        tamanho_ = static_cast<size_t>(tamanho.QuadPart);
+        if (tamanho_ > 0) { // arquivos vazios não podem ser mapeados
+            HANDLE mapeamento = CreateFileMappingA(arquivo, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            CloseHandle(arquivo); // o mapeamento mantém o arquivo aberto
+            if (!mapeamento) throw std::runtime_error("Nao foi possivel mapear " + caminho);
+            dados_ = static_cast<const char*>(MapViewOfFile(mapeamento, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(mapeamento); // a visão mantém o mapeamento
+            if (!dados_) throw std::runtime_error("Nao foi possivel mapear " + caminho);
+        }
+        else {
+            CloseHandle(arquivo);
+        }
+#else
+        int fd = open(caminho.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Nao foi possivel abrir " + caminho);
+        struct stat st {};
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::runtime_error("Nao foi possivel obter o tamanho de " + caminho);
+        }
+        tamanho_ = static_cast<size_t>(st.st_size);
+        if (tamanho_ > 0) { // mmap de tamanho 0 falha
+            void* mapa = mmap(nullptr, tamanho_, PROT_READ, MAP_SHARED, fd, 0);
+            close(fd); // o mapeamento mantém o arquivo aberto
+            if (mapa == MAP_FAILED) throw std::runtime_error("Nao foi possivel mapear " + caminho);
+            // O arquivo é lido uma única vez, do início ao fim: o kernel pode ler adiante com folga.
+            madvise(mapa, tamanho_, MADV_SEQUENTIAL);
+            dados_ = static_cast<const char*>(mapa);
+        }
+        else {
+            close(fd);
+        }
+#endif
+    }
+
+    ArquivoMapeado(const ArquivoMapeado&) = delete;
+    ArquivoMapeado& operator=(const ArquivoMapeado&) = delete;
+
+    ~ArquivoMapeado() {
+        if (!dados_) return;
+#ifdef _WIN32
+        UnmapViewOfFile(dados_);
+#else
+        munmap(const_cast<char*>(dados_), tamanho_);
+#endif
+    }
+
+    /// Conteúdo do arquivo (vazio se o arquivo estiver vazio).
+    std::string_view conteudo() const noexcept { return { dados_, tamanho_ }; }
+
+private:
+    const char* dados_ = nullptr;
+    size_t tamanho_ = 0;
+};
+
+/**
+ * @brief Uma parte do texto: intervalo [inicio, inicio + tamanho) em bytes dentro do arquivo.
+ */
+struct Parte {
+    size_t inicio;
+    size_t tamanho;
+};
+
+/**
+ * @brief Calcula onde cortar o texto, com a mesma regra do modo de download, mas sobre bytes.
+ *
+ * @param texto O texto inteiro (normalmente o conteúdo de um ArquivoMapeado).
+ * @param numeroDePartes O número máximo de partes.
+ * @return std::vector<Parte> As partes, em ordem, cobrindo o texto inteiro.
+ *
+ * Para alunos iniciantes: cada parte começa onde a anterior terminou. Andamos tamanhoDaParte bytes a
+ * partir do início da parte e procuramos o próximo '\n' com std::memchr, uma busca em memória que a
+ * biblioteca C faz com instruções vetoriais (vários bytes por vez). O corte fica logo depois do '\n',
+ * então nenhuma linha é dividida; e como '\n' nunca aparece dentro de um caractere UTF-8 de vários
+ * bytes, também nenhum caractere é cortado ao meio, sem precisar converter nada para wstring.
+ * O que sobrar depois da penúltima parte vira a última.
+ */
+std::vector<Parte> calcularPartes(std::string_view texto, int numeroDePartes) {
+    std::vector<Parte> partes;
+    const size_t tamanhoDaParte = texto.size() / static_cast<size_t>(numeroDePartes);
+    size_t inicio = 0;
+    while (texto.size() - inicio >= tamanhoDaParte && inicio < texto.size()
+        && static_cast<int>(partes.size()) < numeroDePartes - 1) {
+        const size_t alvo = inicio + tamanhoDaParte;
+        const void* quebra = std::memchr(texto.data() + alvo, '\n', texto.size() - alvo);
+        const size_t fim = quebra ? static_cast<size_t>(static_cast<const char*>(quebra) - texto.data()) + 1 // Incluir o '\n'
+                                  : texto.size(); // Sem '\n' até o fim: a parte vai até o fim do texto
+        partes.push_back({ inicio, fim - inicio });
+        inicio = fim;
+    }
+    if (inicio < texto.size()) {
+        partes.push_back({ inicio, texto.size() - inicio });
+    }
+    return partes;
+}
+
+/**
+ * @brief Monta o nome do arquivo de uma parte, no formato <diretorio>/parte_001.txt.
+ */
+std::string nomeDaParte(const std::string& nome_diretorio, size_t indice) {
+    std::stringstream ss;
+    ss << nome_diretorio << "/parte_"
+        << std::setw(3) << std::setfill('0') << (indice + 1)
+        << ".txt";
+    return ss.str();
+}
+
+/**
+ * @brief Divide um arquivo local em partes lógicas e salva cada uma, lendo do arquivo mapeado em memória.
+ *
+ * @param caminho O arquivo de texto de entrada (UTF-8 ou qualquer codificação compatível com ASCII).
+ * @param numeroDePartes O número de partes em que dividir o texto.
+ * @param nome_diretorio O nome da pasta onde salvar os arquivos.
+ * @param metodo Como gravar as partes (GravadorDePartes.h). O padrão é `Metodo::Ofstream`, que nas medidas do
+ * `--bench-gravacao` ainda é o mais rápido; os outros métodos só compensam quando a medida mostrar ganho.
+ * @throw std::runtime_error Se a entrada não puder ser lida ou alguma parte não puder ser gravada.
+ *
+ * Para alunos iniciantes: ao contrário do modo de download, aqui o texto nunca é copiado para uma
+ * string. Os cortes são calculados direto sobre o mapeamento e cada parte é escrita no arquivo de saída
+ * a partir do ponteiro para dentro do mapeamento (cada pedido de gravação aponta para o seu trecho). O custo total é linear no tamanho do arquivo; no fim
+ * mostramos a vazão em GB/s (bytes do arquivo de entrada divididos pelo tempo total).
+ *
+ * @return double O tempo total, em segundos.
+ */
+double dividirArquivoLocal(const std::string& caminho, int numeroDePartes, const std::string& nome_diretorio,
+    gravacao::Metodo metodo = gravacao::Metodo::Ofstream) {
+    if (numeroDePartes < 1) {
+        throw std::runtime_error("O numero de partes deve ser pelo menos 1.");
+    }
+    const auto t0 = std::chrono::steady_clock::now();
+
+    ArquivoMapeado arquivo(caminho);
+    const std::string_view texto = arquivo.conteudo();
+
+    std::cout << "Criando diretorio de saida: " << nome_diretorio << std::endl;
+    std::filesystem::create_directory(nome_diretorio);
+
+    const std::vector<Parte> partes = calcularPartes(texto, numeroDePartes);
+    const auto t1 = std::chrono::steady_clock::now();
+
+    // Escrita direta do mapeamento: sem cópia, sem conversão, sem buffer intermediário.
+    std::vector<gravacao::Pedido> pedidos;
+    pedidos.reserve(partes.size());
+    for (size_t i = 0; i < partes.size(); ++i) {
+        pedidos.push_back({ nomeDaParte(nome_diretorio, i), texto.substr(partes[i].inicio, partes[i].tamanho) });
+    }
+    gravacao::gravar(pedidos, metodo);
+    const auto t2 = std::chrono::steady_clock::now();
+
+    const double segundosCorte = std::chrono::duration<double>(t1 - t0).count();
+    const double segundosTotal = std::chrono::duration<double>(t2 - t0).count();
+    const double gigabytes = static_cast<double>(texto.size()) / 1e9;
+    std::cout << partes.size() << " partes foram salvas com sucesso no diretorio '" << nome_diretorio << "'." << std::endl;
+    std::cout << std::fixed << std::setprecision(3)
+        << texto.size() << " bytes em " << segundosTotal * 1000.0 << " ms"
+        << " (cortes: " << segundosCorte * 1000.0 << " ms): "
+        << (segundosTotal > 0.0 ? gigabytes / segundosTotal : 0.0) << " GB/s" << std::endl;
+    return segundosTotal;
+}
+
+// --- Modo local paralelo: cortes independentes e gravação das partes por várias threads ---
+
+/**
+ * @brief Calcula os cortes de forma independente, um perto de cada múltiplo de tamanhoTotal / numeroDePartes.
+ *
+ * @param texto O texto inteiro.
+ * @param numeroDePartes O número máximo de partes.
+ * @return std::vector<Parte> As partes, em ordem, cobrindo o texto inteiro.
+ *
+ * Para alunos iniciantes: calcularPartes precisa saber onde a parte anterior terminou para achar o próximo
+ * corte, então percorre os cortes um depois do outro. Aqui o corte k fica no primeiro '\n' a partir do byte
+ * k * tamanhoTotal / numeroDePartes: cada corte é um "salto" direto para perto do ponto ideal seguido de uma
+ * busca curta (até o fim daquela linha), o que dá O(numeroDePartes) buscas no total em vez de ler o texto.
+ * As partes ficam mais próximas do tamanho ideal do que na regra sequencial. Se duas posições caírem na
+ * mesma linha (linhas maiores que uma parte), os cortes coincidem e o número de partes diminui.
+ */
+std::vector<Parte> calcularPartesParalelas(std::string_view texto, int numeroDePartes) {
+    std::vector<Parte> partes;
+    size_t inicio = 0;
+    for (int k = 1; k < numeroDePartes && inicio < texto.size(); ++k) {
+        const size_t alvo = std::max(inicio, texto.size() / static_cast<size_t>(numeroDePartes) * static_cast<size_t>(k));
+        const void* quebra = std::memchr(texto.data() + alvo, '\n', texto.size() - alvo);
+        if (!quebra) break; // sem '\n' até o fim: o resto vira a última parte
+        const size_t fim = static_cast<size_t>(static_cast<const char*>(quebra) - texto.data()) + 1;
+        partes.push_back({ inicio, fim - inicio });
+        inicio = fim;
+    }
+    if (inicio < texto.size()) {
+        partes.push_back({ inicio, texto.size() - inicio });
+    }
+    return partes;
+}
+
+/**
+ * @brief Grava uma parte do arquivo de entrada em um arquivo novo, sem passar por buffers do programa.
+ *
+ * @param origem O arquivo de entrada já mapeado.
+ * @param fdOrigem Descritor aberto do mesmo arquivo (usado por copy_file_range; ignorado no Windows).
+ * @param parte O intervalo de bytes a copiar.
+ * @param nome_arquivo O arquivo de saída (criado ou truncado).
+ * @throw std::runtime_error Se a saída não puder ser criada ou gravada.
+ *
+ * Para alunos iniciantes: no Linux usamos copy_file_range, que pede ao kernel para copiar bytes de um
+ * arquivo para outro sem trazê-los para a memória do programa (em alguns sistemas de arquivos, nem os
+ * dados são copiados: os blocos passam a ser compartilhados). Se o kernel ou o sistema de arquivos não
+ * suportar, caímos para pwrite a partir do mapeamento. Cada chamada recebe o próprio deslocamento, então
+ * várias threads podem gravar ao mesmo tempo sem disputar a posição de um descritor compartilhado.
+ */
+void gravarParte(const ArquivoMapeado& origem, [[maybe_unused]] int fdOrigem, const Parte& parte, const std::string& nome_arquivo) {
+    const char* dados = origem.conteudo().data() + parte.inicio;
+#ifdef _WIN32
+    HANDLE saida = CreateFileA(nome_arquivo.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (saida == INVALID_HANDLE_VALUE) throw std::runtime_error("Erro ao criar o arquivo: " + nome_arquivo);
+    size_t gravados = 0;
+    while (gravados < parte.tamanho) {
+        const DWORD pedaco = static_cast<DWORD>(std::min<size_t>(parte.tamanho - gravados, 1u << 30));
+        DWORD escritos = 0;
+        if (!WriteFile(saida, dados + gravados, pedaco, &escritos, nullptr) || escritos == 0) {
+            CloseHandle(saida);
+            throw std::runtime_error("Erro ao gravar o arquivo: " + nome_arquivo);
+        }
+        gravados += escritos;
+    }
+    CloseHandle(saida);
+#else
+    const int saida = open(nome_arquivo.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (saida < 0) throw std::runtime_error("Erro ao criar o arquivo: " + nome_arquivo);
+    size_t gravados = 0;
+#ifdef __linux__
+    loff_t deslocamento = static_cast<loff_t>(parte.inicio);
+    while (gravados < parte.tamanho) {
+        const ssize_t n = copy_file_range(fdOrigem, &deslocamento, saida, nullptr, parte.tamanho - gravados, 0);
+        if (n <= 0) break; // sem suporte (EXDEV, EINVAL, ENOSYS...) ou erro: o resto vai por pwrite
+        gravados += static_cast<size_t>(n);
+    }
+#endif
+    while (gravados < parte.tamanho) {
+        const ssize_t n = pwrite(saida, dados + gravados, parte.tamanho - gravados, static_cast<off_t>(gravados));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            close(saida);
+            throw std::runtime_error("Erro ao gravar o arquivo: " + nome_arquivo);
+        }
+        gravados += static_cast<size_t>(n);
+    }
+    if (close(saida) != 0) throw std::runtime_error("Erro ao gravar o arquivo: " + nome_arquivo);
+#endif
+}
+
+/**
+ * @brief Divide um arquivo local em duas fases: calcula todos os cortes e depois grava as partes em paralelo.
+ *
+ * @param caminho O arquivo de texto de entrada.
+ * @param numeroDePartes O número de partes em que dividir o texto.
+ * @param nome_diretorio O nome da pasta onde salvar os arquivos.
+ * @param numeroDeThreads Quantas threads gravam partes ao mesmo tempo (0 = número de CPUs).
+ * @param silencioso Se verdadeiro, não imprime o resumo (usado pelo benchmark).
+ * @return double O tempo total, em segundos.
+ * @throw std::runtime_error Se a entrada não puder ser lida ou alguma parte não puder ser gravada.
+ *
+ * Para alunos iniciantes: depois da primeira fase, cada parte é um trabalho independente (de onde copiar,
+ * quanto copiar e para qual arquivo). As threads pegam o próximo trabalho livre com um contador atômico
+ * (fetch_add), então uma thread que termina cedo já pega outra parte, sem fila nem mutex. O primeiro erro
+ * de gravação é guardado e relançado depois que todas as threads terminarem.
+ */
+double dividirArquivoParalelo(const std::string& caminho, int numeroDePartes, const std::string& nome_diretorio,
+    unsigned numeroDeThreads, bool silencioso = false) {
+    if (numeroDePartes < 1) {
+        throw std::runtime_error("O numero de partes deve ser pelo menos 1.");
+    }
+    if (numeroDeThreads == 0) {
+        numeroDeThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const auto t0 = std::chrono::steady_clock::now();
+
+    ArquivoMapeado arquivo(caminho);
+    const std::string_view texto = arquivo.conteudo();
+    std::filesystem::create_directory(nome_diretorio);
+    const std::vector<Parte> partes = calcularPartesParalelas(texto, numeroDePartes);
+    const auto t1 = std::chrono::steady_clock::now();
+
+    // Aberto depois do diretório e do corte, que podem lançar, para não vazar o descritor.
+    int fdOrigem = -1;
+#ifndef _WIN32
+    fdOrigem = open(caminho.c_str(), O_RDONLY);
+    if (fdOrigem < 0) throw std::runtime_error("Nao foi possivel abrir " + caminho);
+#endif
+
+    std::atomic<size_t> proxima{ 0 };
+    std::exception_ptr primeiroErro;
+    std::atomic<bool> falhou{ false };
+    auto trabalhador = [&]() {
+        for (size_t i = proxima.fetch_add(1); i < partes.size() && !falhou; i = proxima.fetch_add(1)) {
+            try {
+                gravarParte(arquivo, fdOrigem, partes[i], nomeDaParte(nome_diretorio, i));
+            }
+            catch (...) {
+                if (!falhou.exchange(true)) primeiroErro = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    const size_t quantas = std::min<size_t>(numeroDeThreads, partes.size());
+    for (size_t t = 1; t < quantas; ++t) threads.emplace_back(trabalhador);
+    trabalhador(); // a thread principal também trabalha
+    for (std::thread& t : threads) t.join();
+#ifndef _WIN32
+    close(fdOrigem);
+#endif
+    if (primeiroErro) std::rethrow_exception(primeiroErro);
+    const auto t2 = std::chrono::steady_clock::now();
+
+    const double segundosCorte = std::chrono::duration<double>(t1 - t0).count();
+    const double segundosTotal = std::chrono::duration<double>(t2 - t0).count();
+    if (!silencioso) {
+        std::cout << partes.size() << " partes foram salvas com sucesso no diretorio '" << nome_diretorio
+            << "' por " << std::max<size_t>(quantas, 1) << " thread(s)." << std::endl;
+        std::cout << std::fixed << std::setprecision(3)
+            << texto.size() << " bytes em " << segundosTotal * 1000.0 << " ms"
+            << " (cortes: " << segundosCorte * 1000.0 << " ms): "
+            << (segundosTotal > 0.0 ? static_cast<double>(texto.size()) / 1e9 / segundosTotal : 0.0) << " GB/s" << std::endl;
+    }
+    return segundosTotal;
+}
+
+/**
+ * @brief Compara a divisão sequencial com a paralela para 1, 2, 4, ... threads (até o dobro do número de CPUs).
+ *
+ * Para alunos iniciantes: cada configuração roda 3 vezes e vale o menor tempo, para reduzir o ruído de
+ * outros programas. O speedup é o tempo sequencial dividido pelo tempo paralelo. Com o arquivo de entrada
+ * no cache de páginas, o limite costuma ser a velocidade de escrita do disco, e não a CPU.
+ */
+void benchParalelo(const std::string& caminho, int numeroDePartes, const std::string& nome_diretorio) {
+    const auto tamanho = std::filesystem::file_size(caminho);
+    std::streambuf* coutOriginal = std::cout.rdbuf(nullptr); // silencia as mensagens de dividirArquivoLocal
+    double sequencial = 0.0;
+    try {
+        for (int r = 0; r < 3; ++r) {
+            const double s = dividirArquivoLocal(caminho, numeroDePartes, nome_diretorio);
+            sequencial = (r == 0) ? s : std::min(sequencial, s);
+        }
+    }
+    catch (...) {
+        std::cout.rdbuf(coutOriginal);
+        throw;
+    }
+    std::cout.rdbuf(coutOriginal);
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Arquivo: " << caminho << " (" << tamanho << " bytes), " << numeroDePartes << " partes, "
+        << std::thread::hardware_concurrency() << " CPUs" << std::endl;
+    std::cout << "sequencial (ofstream)   " << std::setw(10) << sequencial * 1000.0 << " ms  "
+        << static_cast<double>(tamanho) / 1e9 / sequencial << " GB/s" << std::endl;
+    const unsigned maximo = std::max(2u, 2 * std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= maximo; threads *= 2) {
+        double melhor = 0.0;
+        for (int r = 0; r < 3; ++r) {
+            const double s = dividirArquivoParalelo(caminho, numeroDePartes, nome_diretorio, threads, true);
+            melhor = (r == 0) ? s : std::min(melhor, s);
+        }
+        std::cout << "paralelo, " << std::setw(3) << threads << " thread(s)  " << std::setw(10) << melhor * 1000.0 << " ms  "
+            << static_cast<double>(tamanho) / 1e9 / melhor << " GB/s  speedup " << sequencial / melhor << "x" << std::endl;
+    }
+}
+
+/**
+ * @brief Grava as partes de um arquivo local com cada método do GravadorDePartes.h e compara tempo e chamadas de sistema.
+ *
+ * Para alunos iniciantes: os cortes são os mesmos do modo paralelo e os dados saem direto do arquivo
+ * mapeado; só muda a forma de criar e escrever os arquivos. Com muitas partes pequenas, o custo é dominado
+ * pelas chamadas open/write/close, e o io_uring as junta em poucas chamadas io_uring_enter. Rode uma vez com
+ * a pasta de saída em disco e outra em tmpfs (ex.: /dev/shm) para separar o custo das chamadas do custo do disco.
+ */
+void benchGravacao(const std::string& caminho, int numeroDePartes, const std::string& nome_diretorio) {
+    if (numeroDePartes < 1) {
+        throw std::runtime_error("O numero de partes deve ser pelo menos 1.");
+    }
+    ArquivoMapeado arquivo(caminho);
+    const std::string_view texto = arquivo.conteudo();
+    std::filesystem::create_directories(nome_diretorio);
+
+    std::vector<gravacao::Pedido> pedidos;
+    for (const Parte& parte : calcularPartesParalelas(texto, numeroDePartes)) {
+        pedidos.push_back({ nomeDaParte(nome_diretorio, pedidos.size()), texto.substr(parte.inicio, parte.tamanho) });
+    }
+    std::cout << "Arquivo: " << caminho << " -> " << nome_diretorio << ": ";
+    gravacao::compararMetodos(pedidos);
+}
+
+// --- Junção: remonta as partes parte_NNN.txt em um único arquivo ---
+
+/**
+ * @brief Uma parte encontrada no diretório, já com o lugar onde entra no arquivo remontado.
+ */
+struct ParteEncontrada {
+    std::string caminho;
+    size_t numero;       ///< O NNN de parte_NNN.txt (começa em 1).
+    size_t tamanho;      ///< Tamanho do arquivo da parte, em bytes.
+    size_t deslocamento; ///< Onde a parte começa no arquivo remontado.
+};
+
+/**
+ * @brief Lê o número de uma parte a partir do nome do arquivo ("parte_042.txt" -> 42).
+ * @return size_t O número, ou 0 se o nome não for de uma parte.
+ */
+size_t numeroDaParte(const std::string& nome) {
+    const std::string prefixo = "parte_";
+    const std::string sufixo = ".txt";
+    if (nome.size() <= prefixo.size() + sufixo.size() || nome.rfind(prefixo, 0) != 0
+        || nome.compare(nome.size() - sufixo.size(), sufixo.size(), sufixo) != 0) {
+        return 0;
+    }
+    const std::string digitos = nome.substr(prefixo.size(), nome.size() - prefixo.size() - sufixo.size());
+    if (digitos.size() > 9 || digitos.find_first_not_of("0123456789") != std::string::npos) return 0;
+    return static_cast<size_t>(std::stoul(digitos));
+}
+
+/**
+ * @brief Lista as partes de um diretório, confere a sequência e calcula o deslocamento de cada uma.
+ *
+ * @param nome_diretorio A pasta gerada pelo divisor.
+ * @return std::vector<ParteEncontrada> As partes em ordem (parte_001, parte_002, ...).
+ * @throw std::runtime_error Se não houver partes, se faltar ou sobrar alguma na sequência, ou se o
+ *        manifesto.tsv (quando existir) não conferir com os arquivos.
+ *
+ * Para alunos iniciantes: a ordem vem do número no nome, e não da ordem alfabética (parte_1000.txt vem
+ * depois de parte_999.txt). A sequência precisa ser exatamente 1, 2, ..., N: uma parte faltando ou
+ * repetida (parte_07.txt e parte_007.txt) geraria um arquivo errado sem ninguém perceber. Como o tamanho
+ * de cada parte é conhecido antes de copiar qualquer byte, o deslocamento de cada uma no arquivo final é
+ * só a soma dos tamanhos das anteriores. O DividirArquivoTexto (modo --stream) grava também um
+ * manifesto.tsv com nome, deslocamento e tamanho de cada parte; se ele existir, conferimos os três.
+ */
+std::vector<ParteEncontrada> listarPartes(const std::string& nome_diretorio) {
+    std::vector<ParteEncontrada> partes;
+    for (const auto& entrada : std::filesystem::directory_iterator(nome_diretorio)) {
+        if (!entrada.is_regular_file()) continue;
+        const size_t numero = numeroDaParte(entrada.path().filename().string());
+        if (numero == 0) continue;
+        partes.push_back({ entrada.path().string(), numero, static_cast<size_t>(entrada.file_size()), 0 });
+    }
+    if (partes.empty()) {
+        throw std::runtime_error("Nenhum arquivo parte_NNN.txt em " + nome_diretorio);
+    }
+    std::sort(partes.begin(), partes.end(), [](const ParteEncontrada& a, const ParteEncontrada& b) { return a.numero < b.numero; });
+    size_t deslocamento = 0;
+    for (size_t i = 0; i < partes.size(); ++i) {
+        if (partes[i].numero != i + 1) {
+            throw std::runtime_error(partes[i].numero == i ? "Parte repetida: " + partes[i].caminho
+                                                           : "Parte ausente: numero " + std::to_string(i + 1) + " em " + nome_diretorio);
+        }
+        partes[i].deslocamento = deslocamento;
+        deslocamento += partes[i].tamanho;
+    }
+
+    std::ifstream manifesto(nome_diretorio + "/manifesto.tsv");
+    if (manifesto.is_open()) {
+        size_t i = 0;
+        for (std::string linha; std::getline(manifesto, linha);) {
+            if (linha.empty() || linha[0] == '#') continue;
+            std::istringstream campos(linha);
+            std::string nome;
+            size_t deslocamentoEsperado = 0;
+            size_t tamanhoEsperado = 0;
+            if (!(campos >> nome >> deslocamentoEsperado >> tamanhoEsperado)) {
+                throw std::runtime_error("Linha invalida no manifesto: " + linha);
+            }
+            if (i >= partes.size() || numeroDaParte(nome) != i + 1) {
+                throw std::runtime_error("O manifesto lista " + nome + ", que nao corresponde a parte " + std::to_string(i + 1));
+            }
+            if (partes[i].deslocamento != deslocamentoEsperado || partes[i].tamanho != tamanhoEsperado) {
+                throw std::runtime_error(nome + ": deslocamento " + std::to_string(partes[i].deslocamento) + " e tamanho "
+                    + std::to_string(partes[i].tamanho) + " pelo disco, deslocamento " + std::to_string(deslocamentoEsperado)
+                    + " e tamanho " + std::to_string(tamanhoEsperado) + " no manifesto");
+            }
+            ++i;
+        }
+        if (i != partes.size()) {
+            throw std::runtime_error("O manifesto lista " + std::to_string(i) + " partes, mas o diretorio tem " + std::to_string(partes.size()));
+        }
+    }
+    return partes;
+}
+
+/**
+ * @brief Como os bytes de cada parte chegam ao arquivo remontado.
+ *
+ * Automatico tenta copy_file_range, depois splice e por fim leitura/escrita; os outros começam no
+ * método indicado (usados pelo benchmark para comparar os caminhos).
+ */
+enum class MetodoDeJuncao { Automatico, Splice, LeituraEscrita };
+
+/**
+ * @brief Copia uma parte para a posição dela no arquivo de saída (já aberto e pré-alocado).
+ *
+ * @param parte A parte e o deslocamento de destino.
+ * @param saida Descritor (HANDLE no Windows, convertido) do arquivo remontado.
+ * @param metodo Por onde começar a cadeia de métodos.
+ * @throw std::runtime_error Se a parte não puder ser lida ou a saída não puder ser gravada.
+ *
+ * Para alunos iniciantes: copy_file_range e splice são cópias feitas dentro do kernel: os bytes vão do
+ * cache de páginas da parte para o cache de páginas da saída sem passar por um buffer do programa.
+ * splice precisa de um pipe no meio (arquivo -> pipe -> arquivo), mas funciona em casos em que
+ * copy_file_range é recusado (EXDEV, EINVAL...). O último recurso é o laço clássico pread/pwrite com um
+ * buffer de 1 MB. Todas as escritas levam o deslocamento explícito, então várias threads podem gravar no
+ * mesmo descritor ao mesmo tempo, cada uma na sua faixa.
+ */
+void copiarParte(const ParteEncontrada& parte, intptr_t saida, MetodoDeJuncao metodo) {
+#ifdef _WIN32
+    (void)metodo; // no Windows só existe leitura/escrita
+    HANDLE destino = reinterpret_cast<HANDLE>(saida);
+    HANDLE origem = CreateFileA(parte.caminho.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (origem == INVALID_HANDLE_VALUE) throw std::runtime_error("Nao foi possivel abrir " + parte.caminho);
+    std::vector<char> buffer(1 << 20);
+    size_t copiados = 0;
+    while (copiados < parte.tamanho) {
+        DWORD lidos = 0;
+        const DWORD pedaco = static_cast<DWORD>(std::min(buffer.size(), parte.tamanho - copiados));
+        if (!ReadFile(origem, buffer.data(), pedaco, &lidos, nullptr) || lidos == 0) {
+            CloseHandle(origem);
+            throw std::runtime_error("Erro ao ler " + parte.caminho);
+        }
+        OVERLAPPED posicao{};
+        const ULONGLONG destinoDoPedaco = parte.deslocamento + copiados;
+        posicao.Offset = static_cast<DWORD>(destinoDoPedaco);
+        posicao.OffsetHigh = static_cast<DWORD>(destinoDoPedaco >> 32);
+        DWORD escritos = 0;
+        if (!WriteFile(destino, buffer.data(), lidos, &escritos, &posicao) || escritos != lidos) {
+            CloseHandle(origem);
+            throw std::runtime_error("Erro ao gravar a parte " + parte.caminho);
+        }
+        copiados += lidos;
+    }
+    CloseHandle(origem);
+#else
+    const int destino = static_cast<int>(saida);
+    const int origem = open(parte.caminho.c_str(), O_RDONLY);
+    if (origem < 0) throw std::runtime_error("Nao foi possivel abrir " + parte.caminho);
+    size_t copiados = 0;
+    auto falhar = [&](const std::string& mensagem) {
+        close(origem);
+        throw std::runtime_error(mensagem + " (" + parte.caminho + ")");
+    };
+#ifdef __linux__
+    if (metodo == MetodoDeJuncao::Automatico) {
+        loff_t de = 0;
+        loff_t para = static_cast<loff_t>(parte.deslocamento);
+        while (copiados < parte.tamanho) {
+            const ssize_t n = copy_file_range(origem, &de, destino, &para, parte.tamanho - copiados, 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break; // sem suporte ou erro: o resto vai por splice
+            copiados += static_cast<size_t>(n);
+        }
+    }
+    if (copiados < parte.tamanho && metodo != MetodoDeJuncao::LeituraEscrita) {
+        int tubo[2];
+        if (pipe2(tubo, O_CLOEXEC) == 0) {
+            const int capacidade = fcntl(tubo[1], F_SETPIPE_SZ, 1 << 20); // pipe maior = menos chamadas
+            const size_t porVez = capacidade > 0 ? static_cast<size_t>(capacidade) : 65536;
+            loff_t de = static_cast<loff_t>(copiados);
+            loff_t para = static_cast<loff_t>(parte.deslocamento + copiados);
+            while (copiados < parte.tamanho) {
+                const ssize_t n = splice(origem, &de, tubo[1], nullptr, std::min(porVez, parte.tamanho - copiados), SPLICE_F_MOVE);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) break; // sem suporte: o resto vai por pread/pwrite
+                for (ssize_t noTubo = n; noTubo > 0;) {
+                    const ssize_t m = splice(tubo[0], nullptr, destino, &para, static_cast<size_t>(noTubo), SPLICE_F_MOVE);
+                    if (m < 0 && errno == EINTR) continue;
+                    if (m <= 0) {
+                        close(tubo[0]);
+                        close(tubo[1]);
+                        falhar("Erro ao gravar a parte");
+                    }
+                    noTubo -= m;
+                }
+                copiados += static_cast<size_t>(n);
+            }
+            close(tubo[0]);
+            close(tubo[1]);
+        }
+    }
+#endif
+    std::vector<char> buffer;
+    while (copiados < parte.tamanho) {
+        if (buffer.empty()) buffer.resize(1 << 20);
+        const ssize_t n = pread(origem, buffer.data(), std::min(buffer.size(), parte.tamanho - copiados), static_cast<off_t>(copiados));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) falhar("Erro ao ler a parte (ela encolheu?)");
+        for (ssize_t gravados = 0; gravados < n;) {
+            const ssize_t m = pwrite(destino, buffer.data() + gravados, static_cast<size_t>(n - gravados),
+                static_cast<off_t>(parte.deslocamento + copiados + static_cast<size_t>(gravados)));
+            if (m < 0 && errno == EINTR) continue;
+            if (m <= 0) falhar("Erro ao gravar a parte");
+            gravados += m;
+        }
+        copiados += static_cast<size_t>(n);
+    }
+    close(origem);
+#endif
+}
+
+/**
+ * @brief Remonta o arquivo original a partir das partes de um diretório, copiando várias partes ao mesmo tempo.
+ *
+ * @param nome_diretorio A pasta com parte_001.txt, parte_002.txt, ...
+ * @param arquivo_saida O arquivo remontado (criado ou sobrescrito).
+ * @param numeroDeThreads Quantas threads copiam partes ao mesmo tempo (0 = número de CPUs).
+ * @param metodo Como copiar os bytes (MetodoDeJuncao::Automatico fora do benchmark).
+ * @param silencioso Se verdadeiro, não imprime o resumo (usado pelo benchmark).
+ * @return double O tempo total, em segundos.
+ * @throw std::runtime_error Se a sequência de partes for inválida ou a cópia falhar.
+ *
+ * Para alunos iniciantes: é o caminho inverso de dividirArquivoParalelo. listarPartes já diz onde cada
+ * parte começa no arquivo final, então as partes não precisam ser copiadas em ordem: cada thread pega a
+ * próxima parte livre (contador atômico) e grava na faixa dela. Antes de copiar, o arquivo de saída é
+ * reservado inteiro com fallocate: o sistema de arquivos escolhe os blocos de uma vez (menos fragmentação)
+ * e um disco cheio é detectado antes de gastar tempo copiando.
+ */
+double juntarPartes(const std::string& nome_diretorio, const std::string& arquivo_saida, unsigned numeroDeThreads,
+    MetodoDeJuncao metodo = MetodoDeJuncao::Automatico, bool silencioso = false) {
+    if (numeroDeThreads == 0) {
+        numeroDeThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::vector<ParteEncontrada> partes = listarPartes(nome_diretorio);
+    const size_t total = partes.back().deslocamento + partes.back().tamanho;
+    for (const ParteEncontrada& parte : partes) {
+        if (std::filesystem::exists(arquivo_saida) && std::filesystem::equivalent(parte.caminho, arquivo_saida)) {
+            throw std::runtime_error("O arquivo de saida e uma das partes: " + arquivo_saida);
+        }
+    }
+
+#ifdef _WIN32
+    HANDLE saida = CreateFileA(arquivo_saida.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (saida == INVALID_HANDLE_VALUE) throw std::runtime_error("Erro ao criar o arquivo: " + arquivo_saida);
+    LARGE_INTEGER fim{};
+    fim.QuadPart = static_cast<LONGLONG>(total);
+    if (!SetFilePointerEx(saida, fim, nullptr, FILE_BEGIN) || !SetEndOfFile(saida)) {
+        CloseHandle(saida);
+        throw std::runtime_error("Nao foi possivel reservar " + std::to_string(total) + " bytes para " + arquivo_saida);
+    }
+    const intptr_t descritor = reinterpret_cast<intptr_t>(saida);
+#else
+    const int saida = open(arquivo_saida.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (saida < 0) throw std::runtime_error("Erro ao criar o arquivo: " + arquivo_saida);
+    int reservou = -1;
+#ifdef __linux__
+    if (total > 0) {
+        reservou = fallocate(saida, 0, 0, static_cast<off_t>(total));
+        // errno só vale quando o fallocate rodou e falhou; os outros erros (ex.: EOPNOTSUPP) caem no ftruncate
+        if (reservou != 0 && errno == ENOSPC) {
+            close(saida);
+            throw std::runtime_error("Sem espaco para " + std::to_string(total) + " bytes em " + arquivo_saida);
+        }
+    }
+#endif
+    if (reservou != 0 && ftruncate(saida, static_cast<off_t>(total)) != 0) { // sem fallocate: só o tamanho
+        close(saida);
+        throw std::runtime_error("Nao foi possivel reservar " + std::to_string(total) + " bytes para " + arquivo_saida);
+    }
+    const intptr_t descritor = saida;
+#endif
+
+    std::atomic<size_t> proxima{ 0 };
+    std::exception_ptr primeiroErro;
+    std::atomic<bool> falhou{ false };
+    auto trabalhador = [&]() {
+        for (size_t i = proxima.fetch_add(1); i < partes.size() && !falhou; i = proxima.fetch_add(1)) {
+            try {
+                copiarParte(partes[i], descritor, metodo);
+            }
+            catch (...) {
+                if (!falhou.exchange(true)) primeiroErro = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    const size_t quantas = std::min<size_t>(numeroDeThreads, partes.size());
+    for (size_t t = 1; t < quantas; ++t) threads.emplace_back(trabalhador);
+    trabalhador(); // a thread principal também trabalha
+    for (std::thread& t : threads) t.join();
+#ifdef _WIN32
+    const bool fechou = CloseHandle(saida) != 0;
+#else
+    const bool fechou = close(saida) == 0;
+#endif
+    if (primeiroErro) std::rethrow_exception(primeiroErro);
+    if (!fechou) throw std::runtime_error("Erro ao gravar o arquivo: " + arquivo_saida);
+    const double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    if (!silencioso) {
+        std::cout << partes.size() << " partes de '" << nome_diretorio << "' juntadas em '" << arquivo_saida
+            << "' por " << quantas << " thread(s)." << std::endl;
+        std::cout << std::fixed << std::setprecision(3)
+            << total << " bytes em " << segundos * 1000.0 << " ms: "
+            << (segundos > 0.0 ? static_cast<double>(total) / 1e9 / segundos : 0.0) << " GB/s" << std::endl;
+    }
+    return segundos;
+}
+
+/**
+ * @brief Junta as partes do jeito ingênuo: uma de cada vez, com ifstream/ofstream e um buffer de 64 KB.
+ *
+ * Serve de referência para o benchmark: todo byte sobe para a memória do programa e desce de novo.
+ */
+double juntarPartesIngenuo(const std::string& nome_diretorio, const std::string& arquivo_saida) {
+    const auto t0 = std::chrono::steady_clock::now();
+    std::ofstream saida(arquivo_saida, std::ios::binary);
+    if (!saida.is_open()) throw std::runtime_error("Erro ao criar o arquivo: " + arquivo_saida);
+    std::vector<char> buffer(64 * 1024);
+    for (const ParteEncontrada& parte : listarPartes(nome_diretorio)) {
+        std::ifstream entrada(parte.caminho, std::ios::binary);
+        while (entrada.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) || entrada.gcount() > 0) {
+            saida.write(buffer.data(), entrada.gcount());
+        }
+    }
+    saida.close();
+    if (!saida) throw std::runtime_error("Erro ao gravar o arquivo: " + arquivo_saida);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/**
+ * @brief Ida e volta: divide um arquivo, junta as partes com cada método e confere se o resultado é idêntico.
+ *
+ * Para alunos iniciantes: cada configuração roda 3 vezes e vale o menor tempo. Depois de cada junção, o
+ * arquivo remontado é comparado byte a byte com o original (os dois mapeados em memória), então um
+ * método rápido mas errado aparece como FALHOU, não como vitória. Como no --bench-gravacao, rode uma
+ * vez em disco e outra em tmpfs (/dev/shm) para separar o custo das cópias do custo do disco.
+ */
+void benchJuncao(const std::string& caminho, int numeroDePartes, const std::string& nome_diretorio, const std::string& arquivo_saida) {
+    const auto tamanho = std::filesystem::file_size(caminho);
+    const double divisao = dividirArquivoParalelo(caminho, numeroDePartes, nome_diretorio, 0, true);
+    const size_t partes = listarPartes(nome_diretorio).size();
+
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Arquivo: " << caminho << " (" << tamanho << " bytes), " << partes << " partes, "
+        << std::thread::hardware_concurrency() << " CPUs" << std::endl;
+    std::cout << std::left << std::setw(34) << "divisao (paralela)" << std::right << std::setw(10) << divisao * 1000.0 << " ms  "
+        << static_cast<double>(tamanho) / 1e9 / divisao << " GB/s" << std::endl;
+
+    auto medir = [&](const std::string& nome, auto&& juntar) {
+        double melhor = 0.0;
+        for (int r = 0; r < 3; ++r) {
+            const double s = juntar();
+            melhor = (r == 0) ? s : std::min(melhor, s);
+        }
+        ArquivoMapeado original(caminho);
+        ArquivoMapeado remontado(arquivo_saida);
+        const bool igual = original.conteudo() == remontado.conteudo();
+        std::cout << std::left << std::setw(34) << nome << std::right << std::setw(10) << melhor * 1000.0 << " ms  "
+            << static_cast<double>(tamanho) / 1e9 / melhor << " GB/s  ida e volta " << (divisao + melhor) * 1000.0 << " ms  "
+            << (igual ? "OK" : "FALHOU") << std::endl;
+        if (!igual) throw std::runtime_error("O arquivo remontado difere do original: " + arquivo_saida);
+    };
+    medir("ingenuo (ifstream/ofstream)", [&] { return juntarPartesIngenuo(nome_diretorio, arquivo_saida); });
+    medir("pread/pwrite, 1 thread", [&] { return juntarPartes(nome_diretorio, arquivo_saida, 1, MetodoDeJuncao::LeituraEscrita, true); });
+#ifdef __linux__
+    medir("splice, 1 thread", [&] { return juntarPartes(nome_diretorio, arquivo_saida, 1, MetodoDeJuncao::Splice, true); });
+#endif
+    const unsigned maximo = std::max(2u, 2 * std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= maximo; threads *= 2) {
+        medir("automatico, " + std::to_string(threads) + " thread(s)",
+            [&] { return juntarPartes(nome_diretorio, arquivo_saida, threads, MetodoDeJuncao::Automatico, true); });
+    }
+}
+
+/**
+ * @brief Diz se o argumento é uma URL (http:// ou https://) ou o caminho de um arquivo local.
+ */
+bool ehUrl(const std::string& argumento) {
+    return argumento.rfind("http://", 0) == 0 || argumento.rfind("https://", 0) == 0;
+}
 
 /**
  * @brief Função principal do programa, que processa argumentos de linha de comando e chama a função de download.
@@ -228,25 +1071,83 @@ void baixarEDividirESalvar(const std::wstring& url, int numeroDePartes, const st
  *
  * Para alunos iniciantes: Todo programa C++ começa aqui, no main(). Ele verifica se você passou os argumentos certos
  * quando roda o programa (ex: no prompt de comando: programa.exe https://exemplo.com 10 pasta_saida).
- * Os argumentos são: 1. URL do texto, 2. Número de partes, 3. Nome da pasta.
- * Se faltar, mostra como usar e sai. Senão, converte a URL para wide string e chama a função principal.
+ * Os argumentos são: 1. URL do texto (ou caminho de um arquivo local), 2. Número de partes, 3. Nome da pasta,
+ * 4. (opcional, só para arquivo local) número de threads para gravar as partes em paralelo (0 = número de CPUs).
+ * Se faltar, mostra como usar e sai. Se for uma URL, converte para wide string e chama a função de download;
+ * senão, divide o arquivo local com dividirArquivoLocal.
  * Usa try-catch para capturar erros e imprimir mensagens amigáveis.
  */
 int main(int argc, char* argv[]) {
+    if (argc >= 5 && std::string(argv[1]) == "--bench-paralelo") {
+        try {
+            benchParalelo(argv[2], std::stoi(argv[3]), argv[4]);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Erro: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc >= 5 && std::string(argv[1]) == "--bench-gravacao") {
+        try {
+            benchGravacao(argv[2], std::stoi(argv[3]), argv[4]);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Erro: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc >= 4 && std::string(argv[1]) == "--juntar") {
+        try {
+            juntarPartes(argv[2], argv[3], argc >= 5 ? static_cast<unsigned>(std::stoul(argv[4])) : 0u);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Erro: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc >= 6 && std::string(argv[1]) == "--bench-juncao") {
+        try {
+            benchJuncao(argv[2], std::stoi(argv[3]), argv[4], argv[5]);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Erro: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
     if (argc < 4) {
-        std::cerr << "Uso: " << argv[0] << " <URL> <numero_de_partes> <nome_diretorio>" << std::endl;
+        std::cerr << "Uso: " << argv[0] << " <URL|arquivo_local> <numero_de_partes> <nome_diretorio> [numero_de_threads]" << std::endl;
+        std::cerr << "     " << argv[0] << " --bench-paralelo <arquivo_local> <numero_de_partes> <nome_diretorio>" << std::endl;
+        std::cerr << "     " << argv[0] << " --bench-gravacao <arquivo_local> <numero_de_partes> <nome_diretorio>" << std::endl;
+        std::cerr << "     " << argv[0] << " --juntar <nome_diretorio> <arquivo_saida> [numero_de_threads]" << std::endl;
+        std::cerr << "     " << argv[0] << " --bench-juncao <arquivo_local> <numero_de_partes> <nome_diretorio> <arquivo_saida>" << std::endl;
         return 1;
     }
 
-    // Converter URL char* para wstring
-    std::wstring url;
-    url.assign(argv[1], argv[1] + std::strlen(argv[1]));
-
+    std::string origem = argv[1];
     int numeroDePartes = std::stoi(argv[2]);
     std::string nome_diretorio = argv[3];
 
     try {
-        baixarEDividirESalvar(url, numeroDePartes, nome_diretorio);
+        if (ehUrl(origem)) {
+#ifdef _WIN32
+            // Converter URL char* para wstring
+            std::wstring url;
+            url.assign(argv[1], argv[1] + std::strlen(argv[1]));
+            baixarEDividirESalvar(url, numeroDePartes, nome_diretorio);
+#else
+            throw std::runtime_error("O download de URLs usa WinINet e so esta disponivel no Windows.");
+#endif
+        }
+        else if (argc >= 5) {
+            dividirArquivoParalelo(origem, numeroDePartes, nome_diretorio, static_cast<unsigned>(std::stoul(argv[4])));
+        }
+        else {
+            dividirArquivoLocal(origem, numeroDePartes, nome_diretorio);
+        }
     }
     catch (const std::exception& e) {
         std::cerr << "Erro: " << e.what() << std::endl;
@@ -4,11 +4,22 @@
  *
  * Abre um segmento de memria compartilhada existente e os objetos de
  * sincronizao para ler mensagens enviadas pelo programa escritor.
+ *
+ * No Linux (e demais sistemas POSIX) abre o segmento `shm_open` do escritor e consome as mensagens
+ * do anel SPSC (../Writer/AnelCompartilhado.h), imprimindo-as direto do segmento (espiar/liberar), sem cpia.
+ * Com `--difusao`, entra como um dos leitores da difuso do escritor (`Writer --difusao`); vrios leitores
+ * podem rodar ao mesmo tempo e cada um recebe todas as mensagens.
  */
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include <iostream>
+#include <string>
 #include "shared_struct.h" // Inclui a definio da struct e constantes
+#include "../Writer/AnelCompartilhado.h"
+
+#ifdef _WIN32
 
 void PrintError(const std::string& functionName) {
     DWORD error = GetLastError();
@@ -95,4 +106,55 @@ int main() {
     CloseHandle(hEventEmpty);
 
     return 0;
-}
\ No newline at end of file
+}
+#else
+/**
+ * @brief Imprime as mensagens da difuso at o escritor encerrar ou descartar este leitor.
+ *
+ * As mensagens so copiadas (receber) antes de impressas: o escritor descarta leitores lentos e pode
+ * sobrescrever uma mensagem enquanto ela  lida, e s a cpia conferida por liberar()  confivel.
+ */
+void leitorDaDifusao() {
+    auto segmento = ipc::SegmentoCompartilhado::abrir(SHM_BROADCAST_NAME);
+    ipc::LeitorDaDifusao leitor(segmento.dados(), segmento.tamanho());
+
+    std::cout << "Programa leitor (difusao) iniciado. Aguardando mensagens..." << std::endl;
+    for (std::string mensagem; leitor.receber(mensagem);) {
+        std::cout << "Mensagem recebida: " << mensagem << std::endl;
+    }
+    if (leitor.foiDescartado()) {
+        std::cout << "O escritor descartou este leitor por ser lento demais. Encerrando o leitor." << std::endl;
+    }
+    else {
+        std::cout << "Sinal de encerramento recebido. Encerrando o leitor." << std::endl;
+    }
+}
+
+/**
+ * @brief Funo principal do programa leitor (POSIX): imprime as mensagens do anel at o escritor encerrar.
+ * @return int Retorna 0 em caso de sucesso, 1 em caso de erro.
+ */
+int main(int argc, char* argv[]) {
+    try {
+        if (argc >= 2 && std::string(argv[1]) == "--difusao") {
+            leitorDaDifusao();
+            return 0;
+        }
+
+        auto segmento = ipc::SegmentoCompartilhado::abrir(SHM_RING_NAME);
+        auto anel = ipc::AnelSpsc::anexar(segmento.dados(), segmento.tamanho());
+
+        std::cout << "Programa leitor iniciado. Aguardando mensagens..." << std::endl;
+        for (std::string_view mensagem; anel.espiar(mensagem);) {
+            std::cout << "Mensagem recebida: " << mensagem << std::endl;
+            anel.liberar();
+        }
+        std::cout << "Sinal de encerramento recebido. Encerrando o leitor." << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Erro: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+#endif
\ No newline at end of file
@@ -38,4 +38,15 @@ const wchar_t* MUTEX_NAME = L"MySharedMemoryMutex";
 const wchar_t* EVENT_FULL_NAME = L"MySharedMemoryEventFull";
 
 /// @brief Nome do Evento que sinaliza que o buffer est vazio (pronto para o escritor).
-const wchar_t* EVENT_EMPTY_NAME = L"MySharedMemoryEventEmpty";
\ No newline at end of file
+const wchar_t* EVENT_EMPTY_NAME = L"MySharedMemoryEventEmpty";
+
+// --- Nomes e tamanhos da verso POSIX (Linux) ---
+
+/// @brief Nome do segmento POSIX (shm_open) com o anel de mensagens (AnelCompartilhado.h).
+const char* SHM_RING_NAME = "/MySharedMemoryRing";
+
+/// @brief Nome do segmento POSIX (shm_open) com a difuso para vrios leitores (AnelDifusao).
+const char* SHM_BROADCAST_NAME = "/MySharedMemoryBroadcast";
+
+/// @brief Capacidade da rea de dados do anel, em bytes (potncia de 2).
+const unsigned RING_CAPACITY = 1u << 20;
\ No newline at end of file
@@ -0,0 +1,125 @@
+/**
+ * @file VM-Process-Bench.cpp
+ * @brief Benchmark das configuraes do ncleo (`int32_t`/`int64_t` x `checked`/`unchecked`).
+ *
+ * Todas as configuraes executam os mesmos programas de teste. Antes da medio, as sadas
+ * de `checked` e `unchecked` com o mesmo tipo de valor so comparadas nesses programas e em
+ * programas aleatrios aprovados pelo verificador; depois cada configurao roda vrias vezes
+ * (sada descartada) e o melhor tempo  reportado em instrues por segundo, relativo a
+ * `int64_t/checked`.
+ *
+ * Uso: `VM-Process-Bench [repeticoes]` (padro: 5).
+ */
+
+#include "VM-Process.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+/**
+ * @struct BenchProgram
+ * @brief Programa de benchmark: nome e bytecode.
+ */
+struct BenchProgram {
+    std::string name;
+    std::vector<Byte> code;
+};
+
+/**
+ * @brief Monta o conjunto de programas medidos.
+ */
+static std::vector<BenchProgram> bench_programs() {
+    std::vector<BenchProgram> programs;
+    programs.push_back({ "lao (2M iteraes)", make_program_loop(1000, 2000) });
+    programs.push_back({ "aritmtica (600k iteraes)", make_program_arith(300, 2000) });
+    programs.push_back({ "PRINT (200k valores)", make_program_print(100, 2000) });
+    programs.push_back({ "lao JNZ/PUSH32 (2M iteraes)", make_program_loop_jnz(1000, 2000) });
+    programs.push_back({ "memria LOAD/STORE (2M iteraes)", make_program_memory(1000, 2000) });
+    programs.push_back({ "CALL/RET (1M chamadas)", make_program_call(1000000) });
+    return programs;
+}
+
+/**
+ * @brief Sada (ou mensagem de erro) de `program` na configurao `VM`.
+ */
+template <typename VM>
+static std::string capture(const std::vector<Byte>& program) {
+    std::ostringstream out;
+    try {
+        VM vm(program);
+        vm.run(out);
+    }
+    catch (const VMError& e) {
+        out << "[erro] " << e.what();
+    }
+    return out.str();
+}
+
+/**
+ * @brief Melhor tempo (ms) de `repeticoes` execues de `program` em `VM`; `steps` recebe as instrues executadas.
+ */
+template <typename VM>
+static double best_time_ms(const std::vector<Byte>& program, int repeticoes, std::uint64_t& steps) {
+    NullBuffer nullBuffer;
+    std::ostream sink(&nullBuffer);
+    VM vm(program);
+    double best = 0;
+    for (int i = 0; i < repeticoes; ++i) {
+        const auto t0 = std::chrono::steady_clock::now();
+        steps = vm.run(sink);
+        const auto t1 = std::chrono::steady_clock::now();
+        const double ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        if (i == 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+/**
+ * @brief Compara `checked` e `unchecked` (mesmo tipo de valor) sobre `program`.
+ * @return Nmero de divergncias (0 a 2).
+ */
+static int compare_policies(const std::vector<Byte>& program) {
+    int divergencias = 0;
+    if (capture<VM32Checked>(program) != capture<VM32Unchecked>(program)) ++divergencias;
+    if (capture<VM64Checked>(program) != capture<VM64Unchecked>(program)) ++divergencias;
+    return divergencias;
+}
+
+int main(int argc, char** argv) {
+    const int repeticoes = argc > 1 ? std::max(1, std::atoi(argv[1])) : 5;
+    int divergencias = 0;
+
+    std::mt19937_64 rng(42);
+    constexpr int kAleatorios = 500;
+    for (int i = 0; i < kAleatorios; ++i) divergencias += compare_policies(make_random_program(rng, 64));
+    std::cout << kAleatorios << " programas aleatrios: " << divergencias << " divergncia(s) entre checked e unchecked\n";
+
+    for (const BenchProgram& program : bench_programs()) {
+        std::cout << "=== " << program.name << " ===\n";
+        if (const int d = compare_policies(program.code); d != 0) {
+            std::cout << "  DIVERGNCIA entre checked e unchecked\n";
+            divergencias += d;
+        }
+
+        struct Result { std::string name; double ms; std::uint64_t steps; };
+        std::vector<Result> results;
+        double baseline = 0;
+        for_each_configuration([&]<typename VM>(std::type_identity<VM>) {
+            Result r{ VM::name(), 0, 0 };
+            r.ms = best_time_ms<VM>(program.code, repeticoes, r.steps);
+            if constexpr (std::is_same_v<VM, VM64Checked>) baseline = r.ms;
+            results.push_back(std::move(r));
+        });
+        for (const Result& r : results) {
+            std::cout << "  " << std::left << std::setw(18) << r.name << std::right
+                << std::fixed << std::setprecision(2) << std::setw(9) << r.ms << " ms  "
+                << std::setprecision(1) << std::setw(7) << (r.steps / r.ms / 1e3) << " M instr/s  "
+                << std::setprecision(2) << baseline / r.ms << "x\n";
+        }
+    }
+    std::cout << (divergencias == 0 ? "Sadas idnticas entre checked e unchecked.\n"
+                                    : "H divergncias entre as polticas!\n");
+    return divergencias == 0 ? 0 : 1;
+}
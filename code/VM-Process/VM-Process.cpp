@@ -1,74 +1,67 @@
-#include <iostream>
-#include <vector>
-#include <cstdint>
-#include <stdexcept>
-#include <functional>
+/**
+ * @file VM-Process.cpp
+ * @brief Demonstrao da VM-Process: os mesmos programas em todas as configuraes do ncleo.
+ *
+ * Para cada configurao (`int32_t`/`int64_t` x `checked`/`unchecked`) executa os programas de
+ * teste do ncleo e mostra como cada poltica reporta um programa invlido: `Checked` falha na
+ * instruo culpada, durante a execuo; `Unchecked` recusa o programa na carga, pelo verificador.
+ */
 
-class VirtualMachine {
-public:
-    explicit VirtualMachine(const std::vector<uint8_t>& program)
-        : memory(program), ip(0) {
-    }
-
-    void run() {
-        while (ip < memory.size()) {
-            Opcode op = static_cast<Opcode>(memory[ip++]);
-            execute(op);
-        }
-    }
-
-private:
-    std::vector<uint8_t> memory;
-    std::vector<int> stack;
-    size_t ip;
-
-    void execute(Opcode op) {
-        switch (op) {
-        case Opcode::HALT:
-            ip = memory.size(); // fora sada do loop
-            break;
-
-        case Opcode::PUSH: {
-            if (ip >= memory.size())
-                throw std::runtime_error("Falta operando para PUSH");
-            uint8_t value = memory[ip++];
-            stack.push_back(static_cast<int>(value));
-            break;
-        }
+#include "VM-Process.h"
 
-        case Opcode::POP:
-            checkStack(1, "POP");
-            stack.pop_back();
-            break;
+#include <sstream>
 
-        case Opcode::ADD: binaryOp(<a href = "int a, int b" target = "_blank" rel = "noopener noreferrer nofollow">< / a> { return a + b; }, "ADD"); break;
-        case Opcode::SUB: binaryOp(<a href = "int a, int b" target = "_blank" rel = "noopener noreferrer nofollow">< / a> { return a - b; }, "SUB"); break;
-        case Opcode::MUL: binaryOp(<a href = "int a, int b" target = "_blank" rel = "noopener noreferrer nofollow">< / a> { return a * b; }, "MUL"); break;
-        case Opcode::DIV: binaryOp(<a href = "int a, int b" target = "_blank" rel = "noopener noreferrer nofollow">< / a> {
-            if (b == 0) throw std::runtime_error("Diviso por zero");
-            return a / b;
-        }, "DIV"); break;
+/**
+ * @brief Executa `program` na configurao `VM`, imprimindo a sada ou o erro.
+ */
+template <typename VM>
+static void run_program(const char* title, const std::vector<Byte>& program) {
+    std::cout << "--- " << VM::name() << ": " << title << " ---\n";
+    try {
+        VM vm(program);
+        const std::uint64_t steps = vm.run(std::cout);
+        std::cout << "(" << steps << " instrues)\n";
+    }
+    catch (const VMError& e) {
+        std::cout << "Erro na VM: " << e.what() << "\n";
+    }
+}
 
-        case Opcode::PRINT:
-            checkStack(1, "PRINT");
-            std::cout << "Output: " << stack.back() << std::endl;
-            stack.pop_back();
-            break;
+int main() {
+    const std::vector<Byte> programa1 = make_program1();
+    const std::vector<Byte> contagem = make_program2_countdown();
 
-        default:
-            throw std::runtime_error("Opcode desconhecido: " + std::to_string(static_cast<uint8_t>(op)));
-        }
-    }
+    // 2^31 d a volta em 32 bits (INT32_MIN), e INT32_MIN / -1 tambm, sem trap da CPU;
+    // em 64 bits os dois resultados so exatos.
+    const std::vector<Byte> estouro = assembler::assemble_text(
+        "PUSH16 0x8000\n"
+        "PUSH16 0x8000\n"
+        "MUL\n"
+        "PUSH 2\n"
+        "MUL\n"
+        "DUP\n"
+        "PRINT\n"
+        "PUSH 0\n"
+        "PUSH 1\n"
+        "SUB\n"
+        "DIV\n"
+        "PRINT\n"
+        "HALT\n");
 
-    void checkStack(size_t n, const std::string& op) const {
-        if (stack.size() < n)
-            throw std::runtime_error("Pilha insuficiente para " + op + " (necessrio: " + std::to_string(n) + ")");
-    }
+    // ADD com um nico valor na pilha.
+    const std::vector<Byte> invalido = assembler::assemble_text(
+        "PUSH 1\n"
+        "PRINT\n"
+        "PUSH 2\n"
+        "ADD\n"
+        "HALT\n");
 
-    void binaryOp(std::function<int(int, int)> func, const std::string& name) {
-        checkStack(2, name);
-        int b = stack.back(); stack.pop_back();
-        int a = stack.back(); stack.pop_back();
-        stack.push_back(func(a, b));
-    }
-};
\ No newline at end of file
+    for_each_configuration([&]<typename VM>(std::type_identity<VM>) {
+        run_program<VM>("Programa 1 - (10 + 5) * 2", programa1);
+        run_program<VM>("Programa 2 - contagem regressiva", contagem);
+        run_program<VM>("Programa 3 - 2^31 e 2^31 / -1", estouro);
+        run_program<VM>("Programa 4 - stack underflow", invalido);
+        std::cout << "\n";
+    });
+    return 0;
+}
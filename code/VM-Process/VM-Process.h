@@ -1,74 +1,54 @@
+/**
+ * @file VM-Process.h
+ * @brief VM de pilha compacta construda sobre o ncleo compartilhado `VMCore.h`.
+ *
+ * A linguagem (opcodes, verificador, montador e programas de teste)  a mesma da VM-Process1;
+ * aqui a mquina  apenas uma instanciao de `Interpreter<Value, Checks>`:
+ * - `Value`: `std::int32_t` ou `std::int64_t`, com aritmtica de *wraparound* na largura escolhida;
+ * - `Checks`: `Checked` (verificaes a cada instruo) ou `Unchecked` (verificador na carga,
+ *   lao sem verificaes).
+ *
+ * Usado pelo programa de demonstrao (`VM-Process.cpp`) e pelo benchmark (`VM-Process-Bench.cpp`).
+ */
+
+#pragma once
+
+#include "../VM-Process1/VMCore.h"
+
 #include <iostream>
+#include <streambuf>
+#include <string>
 #include <vector>
-#include <cstdint>
-#include <stdexcept>
-#include <functional>
-
-class VirtualMachine {
-public:
-    explicit VirtualMachine(const std::vector<uint8_t>& program)
-        : memory(program), ip(0) {
-    }
-
-    void run() {
-        while (ip < memory.size()) {
-            Opcode op = static_cast<Opcode>(memory[ip++]);
-            execute(op);
-        }
-    }
-
-private:
-    std::vector<uint8_t> memory;
-    std::vector<int> stack;
-    size_t ip;
-
-    void execute(Opcode op) {
-        switch (op) {
-        case Opcode::HALT:
-            ip = memory.size(); // fora sada do loop
-            break;
-
-        case Opcode::PUSH: {
-            if (ip >= memory.size())
-                throw std::runtime_error("Falta operando para PUSH");
-            uint8_t value = memory[ip++];
-            stack.push_back(static_cast<int>(value));
-            break;
-        }
-
-        case Opcode::POP:
-            checkStack(1, "POP");
-            stack.pop_back();
-            break;
-
-        case Opcode::ADD: binaryOp(<a href = "int a, int b" target = "_blank" rel = "noopener noreferrer nofollow">< / a> { return a + b; }, "ADD"); break;
-        case Opcode::SUB: binaryOp(<a href = "int a, int b" target = "_blank" rel = "noopener noreferrer nofollow">< / a> { return a - b; }, "SUB"); break;
-        case Opcode::MUL: binaryOp(<a href = "int a, int b" target = "_blank" rel = "noopener noreferrer nofollow">< / a> { return a * b; }, "MUL"); break;
-        case Opcode::DIV: binaryOp(<a href = "int a, int b" target = "_blank" rel = "noopener noreferrer nofollow">< / a> {
-            if (b == 0) throw std::runtime_error("Diviso por zero");
-            return a / b;
-        }, "DIV"); break;
-
-        case Opcode::PRINT:
-            checkStack(1, "PRINT");
-            std::cout << "Output: " << stack.back() << std::endl;
-            stack.pop_back();
-            break;
-
-        default:
-            throw std::runtime_error("Opcode desconhecido: " + std::to_string(static_cast<uint8_t>(op)));
-        }
-    }
-
-    void checkStack(size_t n, const std::string& op) const {
-        if (stack.size() < n)
-            throw std::runtime_error("Pilha insuficiente para " + op + " (necessrio: " + std::to_string(n) + ")");
-    }
 
-    void binaryOp(std::function<int(int, int)> func, const std::string& name) {
-        checkStack(2, name);
-        int b = stack.back(); stack.pop_back();
-        int a = stack.back(); stack.pop_back();
-        stack.push_back(func(a, b));
-    }
-};
\ No newline at end of file
+/**
+ * @brief Mquina virtual da VM-Process: o interpretador do ncleo com tipo e poltica escolhidos.
+ */
+template <std::signed_integral Value, CheckPolicy Checks>
+using VirtualMachine = Interpreter<Value, Checks>;
+
+using VM32Checked = VirtualMachine<std::int32_t, Checked>;     ///< Valores de 32 bits, verificao por instruo.
+using VM32Unchecked = VirtualMachine<std::int32_t, Unchecked>; ///< Valores de 32 bits, verificao na carga.
+using VM64Checked = VirtualMachine<std::int64_t, Checked>;     ///< Valores de 64 bits, verificao por instruo.
+using VM64Unchecked = VirtualMachine<std::int64_t, Unchecked>; ///< Valores de 64 bits, verificao na carga.
+
+/**
+ * @brief `std::streambuf` que descarta tudo o que recebe (sada de `PRINT` nos benchmarks).
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return traits_type::not_eof(c); }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+/**
+ * @brief Chama `f` com um objeto-tag de cada configurao, na ordem 32/64 bits x checked/unchecked.
+ *
+ * Permite escrever uma nica vez o cdigo que roda "todas as configuraes sobre o mesmo programa".
+ */
+template <typename F>
+void for_each_configuration(F&& f) {
+    f(std::type_identity<VM32Checked>{});
+    f(std::type_identity<VM32Unchecked>{});
+    f(std::type_identity<VM64Checked>{});
+    f(std::type_identity<VM64Unchecked>{});
+}
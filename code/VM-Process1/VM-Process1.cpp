@@ -11,7 +11,11 @@
  * - Validao de opcodes em tempo de compilao (quando possvel) e execuo.
  * - Tratamento de erros atravs de excees tipadas (`VMError`).
  * - Suporte a *Endianness* configurvel (Big-Endian ou Little-Endian).
- * - Modo de depurao integrado.
+ * - Modo de depurao integrado e *profiler* opcional (`VM_PROFILE`).
+ * - Dois modos de despacho: `switch` clssico e *threaded code* (goto computado no GCC/Clang,
+ *   tabela de handlers nos demais compiladores), selecionados em `VirtualMachine::Config`.
+ * - Tipos, opcodes, verificador, montador e programas de teste vm de `VMCore.h`, ncleo
+ *   *header-only* compartilhado com a VM-Process.
  *
  * Destaques de C++23 e Modern C++:
  * - Uso extensivo de `constexpr` para validao e estruturas de dados imutveis.
@@ -32,367 +36,2473 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
-#include <functional>
+#include <memory>
 #include <algorithm>
 #include <optional>
 #include <iomanip>
+#include <chrono>
+#include <string_view>
+#include <utility>
+#include <random>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <charconv>
+#include <span>
+#include <fstream>
+#include <cctype>
+#include <filesystem>
+#include <tuple>
+#include <exception>
+
+#include "VMCore.h"
+
+// =========================== Configuraes e Tipos ===========================
 
- // =========================== Configuraes e Tipos ===========================
-
- /**
-  * @brief Tipo base para um byte de memria (8 bits).
-  */
-using Byte = uint8_t;
+/**
+ * @brief Tipo base para os valores na pilha da VM.
+ * @note Utiliza `std::int64_t` para garantir preciso em clculos inteiros em arquiteturas de 64 bits.
+ */
+using Int = std::int64_t;
 
 /**
- * @brief Tipo para representar uma palavra de 16 bits (usado em endereos e literais maiores).
+ * @brief Estratgia de despacho usada pelo lao principal da VM.
  */
-using Word16 = uint16_t;
+enum class Dispatch {
+    Switch,   ///< Lao clssico: peek, validao linear do opcode e `switch` em `execute()`.
+    Threaded, ///< *Threaded code*: programa validado na carga e despacho por tabela de 256 entradas.
+    Fast,     ///< Ncleo sem verificaes, topo da pilha em registrador; exige o verificador na carga.
+    Jit,      ///< Traduo para cdigo nativo x86-64 (recai em `Fast` em hosts sem suporte).
+    Register  ///< Mquina de registradores: instrues de trs endereos traduzidas do bytecode verificado.
+};
+
+// =========================== Pr-decodificao ===========================
 
 /**
- * @brief Tipo base para os valores na pilha da VM.
- * @note Utiliza `std::int64_t` para garantir preciso em clculos inteiros em arquiteturas de 64 bits.
+ * @enum MicroOp
+ * @brief Conjunto de instrues interno, executado pelo ncleo `Fast`.
+ *
+ * Diferente de `Opcode`, no descreve bytes na memria: `PUSH`, `PUSH16`, `PUSH32` e `PUSH64`
+ * viram um nico `MicroOp::PUSH` com o valor j decodificado, `JMP32`/`JZ32` viram `JMP`/`JZ`, e
+ * os saltos carregam o ndice da instruo de destino em vez de um endereo. Os valores so
+ * densos (0..N-1) para indexar a tabela de despacho.
+ *
+ * As ltimas entradas so *superinstrues*, criadas por `fuse_superinstructions` a partir de
+ * pares frequentes de instrues; cada uma custa um nico despacho.
  */
-using Int = std::int64_t;
+enum class MicroOp : Byte {
+    HALT, PUSH, POP, ADD, SUB, MUL, DIV, PRINT, DUP, SWAP, JMP, JZ,
+    JNZ, JLT, LOAD, STORE, CALL, RET,
+    ADDI,     ///< `PUSH k; ADD`  -> topo += k.
+    SUBI,     ///< `PUSH k; SUB`  -> topo -= k.
+    MULI,     ///< `PUSH k; MUL`  -> topo *= k.
+    DIVI,     ///< `PUSH k; DIV`  -> topo /= k (apenas k != 0, para preservar o erro de diviso por zero).
+    DUPJZ,    ///< `DUP; JZ alvo` -> salta se o topo for zero, sem desempilh-lo.
+    DUPPRINT  ///< `DUP; PRINT`   -> imprime o topo sem desempilh-lo.
+};
 
 /**
- * @brief Tipo para endereamento de memria (ndice no vetor de bytes).
+ * @struct DecodedInstr
+ * @brief Instruo pr-decodificada, de largura fixa (16 bytes).
  */
-using Address = std::size_t;
+struct DecodedInstr {
+    MicroOp op;        ///< Operao.
+    std::uint32_t pc;  ///< Endereo da instruo no bytecode original (erros e inspeo).
+    Int arg;           ///< Valor de `PUSH`/`xxxI`, clula de `LOAD`/`STORE` ou ndice da instruo de destino dos saltos e de `CALL`.
+};
 
 /**
- * @brief Enumerao para configurao da ordem dos bytes (Endianness).
+ * @brief Indica se a micro-operao salta para o ndice guardado em `arg`.
  */
-enum class Endianness { Big, Little };
+[[nodiscard]] constexpr bool is_jump(MicroOp op) noexcept {
+    return op == MicroOp::JMP || op == MicroOp::JZ || op == MicroOp::JNZ || op == MicroOp::JLT
+        || op == MicroOp::CALL || op == MicroOp::DUPJZ;
+}
 
 /**
- * @class VMError
- * @brief Exceo especfica da Mquina Virtual.
+ * @brief Traduz o bytecode verificado para um array de `DecodedInstr`.
  *
- * Herda de `std::runtime_error` para encapsular erros de execuo, como:
- * - Stack underflow.
- * - Opcode invlido.
- * - Acesso invlido  memria.
- * - Diviso por zero.
+ * Todo o trabalho que o lao de execuo faria a cada instruo executada  feito aqui uma
+ * nica vez: remontagem dos operandos (a *endianness* s importa neste ponto) e converso dos
+ * endereos de salto em ndices do array.
+ *
+ * @param code Bytecode j aprovado por `verify_program`.
+ * @param info Resultado do verificador para `code`.
+ * @param endianness Ordem de bytes dos operandos.
+ * @return As instrues, na mesma ordem do bytecode (a instruo do endereo 0  a de ndice 0).
  */
-class VMError : public std::runtime_error {
-public:
-    /**
-     * @brief Construtor da exceo.
-     * @param msg Mensagem de erro detalhada.
-     */
-    explicit VMError(std::string msg) : std::runtime_error("VM_ERROR: " + std::move(msg)) {}
-};
+[[nodiscard]] inline std::vector<DecodedInstr> decode_program(std::span<const Byte> code,
+    const ProgramInfo& info, Endianness endianness) {
+    std::vector<std::uint32_t> indexOf(code.size(), 0);
+    std::vector<DecodedInstr> out;
+    for (Address pc = 0; pc < code.size(); ++pc) {
+        if (!info.instructionStart[pc]) continue;
+        indexOf[pc] = static_cast<std::uint32_t>(out.size());
+
+        const Opcode op = static_cast<Opcode>(code[pc]);
+        DecodedInstr d{ MicroOp::HALT, static_cast<std::uint32_t>(pc), 0 };
+        switch (op) {
+        case Opcode::HALT:   d.op = MicroOp::HALT;  break;
+        case Opcode::PUSH:
+        case Opcode::PUSH16:
+        case Opcode::PUSH32:
+        case Opcode::PUSH64: d.op = MicroOp::PUSH;  d.arg = push_value(code, pc, endianness); break;
+        case Opcode::POP:    d.op = MicroOp::POP;   break;
+        case Opcode::ADD:    d.op = MicroOp::ADD;   break;
+        case Opcode::SUB:    d.op = MicroOp::SUB;   break;
+        case Opcode::MUL:    d.op = MicroOp::MUL;   break;
+        case Opcode::DIV:    d.op = MicroOp::DIV;   break;
+        case Opcode::PRINT:  d.op = MicroOp::PRINT; break;
+        case Opcode::DUP:    d.op = MicroOp::DUP;   break;
+        case Opcode::SWAP:   d.op = MicroOp::SWAP;  break;
+        case Opcode::JMP:
+        case Opcode::JMP32:  d.op = MicroOp::JMP;   d.arg = branch_target(code, pc, endianness); break;
+        case Opcode::JZ:
+        case Opcode::JZ32:   d.op = MicroOp::JZ;    d.arg = branch_target(code, pc, endianness); break;
+        case Opcode::JNZ:    d.op = MicroOp::JNZ;   d.arg = branch_target(code, pc, endianness); break;
+        case Opcode::JLT:    d.op = MicroOp::JLT;   d.arg = branch_target(code, pc, endianness); break;
+        case Opcode::CALL:   d.op = MicroOp::CALL;  d.arg = branch_target(code, pc, endianness); break;
+        case Opcode::RET:    d.op = MicroOp::RET;   break;
+        case Opcode::LOAD:   d.op = MicroOp::LOAD;  d.arg = decode_word(code[pc + 1], code[pc + 2], endianness); break;
+        case Opcode::STORE:  d.op = MicroOp::STORE; d.arg = decode_word(code[pc + 1], code[pc + 2], endianness); break;
+        }
+        out.push_back(d);
+    }
+    // Segunda passada: endereos de salto -> ndices (o verificador garante que so incios de instruo).
+    for (DecodedInstr& d : out) {
+        if (is_jump(d.op)) d.arg = indexOf[static_cast<Address>(d.arg)];
+    }
+    return out;
+}
 
 /**
- * @enum Opcode
- * @brief Conjunto de instrues suportadas pela VM.
+ * @brief Otimizador *peephole*: funde pares de instrues frequentes em superinstrues.
+ *
+ * Padres reconhecidos (ver `MicroOp`): `PUSH k` seguido de `ADD`/`SUB`/`MUL`/`DIV` e `DUP`
+ * seguido de `JZ`/`PRINT`. No lao de contagem regressiva (`DUP; PRINT; PUSH 1; SUB; DUP; JZ; JMP`)
+ * isso reduz 7 despachos por iterao para 4.
+ *
+ * Um par s  fundido se a segunda instruo no for destino de salto nem de `CALL`: caso
+ * contrrio um salto entraria no meio da superinstruo. A semntica, incluindo os `VMError`,  idntica: `DIV`
+ * por uma constante zero no  fundido, para que o erro continue vindo do `DIV` original.
  *
- * Utiliza `enum class` herdando de `Byte` para garantir que cada instruo ocupe exatamente 1 byte
- * e para evitar converses implcitas indesejadas.
+ * @param code Programa pr-decodificado; os ndices de salto so renumerados.
+ * @return O programa com as superinstrues.
  */
-enum class Opcode : Byte {
-    HALT = 0x00,   ///< Para a execuo da VM.
-    PUSH = 0x01,   ///< Empilha um valor de 8 bits: `PUSH <uint8_t>`.
-    POP = 0x02,    ///< Desempilha o valor do topo e o descarta.
-    ADD = 0x03,    ///< Soma os dois valores do topo: $a + b$.
-    SUB = 0x04,    ///< Subtrai os dois valores do topo: $a - b$.
-    MUL = 0x05,    ///< Multiplica os dois valores do topo: $a \times b$.
-    DIV = 0x06,    ///< Divide os dois valores do topo: $a / b$.
-    PRINT = 0x07,  ///< Imprime o valor do topo da pilha na sada padro.
+[[nodiscard]] inline std::vector<DecodedInstr> fuse_superinstructions(const std::vector<DecodedInstr>& code) {
+    const std::size_t n = code.size();
+    std::vector<bool> isTarget(n, false);
+    for (const DecodedInstr& d : code) {
+        if (is_jump(d.op)) isTarget[static_cast<std::size_t>(d.arg)] = true;
+    }
+
+    auto fusedOp = [](const DecodedInstr& a, const DecodedInstr& b) -> std::optional<MicroOp> {
+        if (a.op == MicroOp::PUSH) {
+            switch (b.op) {
+            case MicroOp::ADD: return MicroOp::ADDI;
+            case MicroOp::SUB: return MicroOp::SUBI;
+            case MicroOp::MUL: return MicroOp::MULI;
+            case MicroOp::DIV: if (a.arg != 0) return MicroOp::DIVI; break;
+            default: break;
+            }
+        }
+        if (a.op == MicroOp::DUP) {
+            if (b.op == MicroOp::JZ) return MicroOp::DUPJZ;
+            if (b.op == MicroOp::PRINT) return MicroOp::DUPPRINT;
+        }
+        return std::nullopt;
+    };
+
+    std::vector<std::uint32_t> newIndex(n, 0);
+    std::vector<DecodedInstr> out;
+    out.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        newIndex[i] = static_cast<std::uint32_t>(out.size());
+        if (i + 1 < n && !isTarget[i + 1]) {
+            if (auto op = fusedOp(code[i], code[i + 1])) {
+                // O operando vem do PUSH (imediato) ou do JZ (alvo); DUPPRINT no usa `arg`.
+                const Int arg = (code[i].op == MicroOp::PUSH) ? code[i].arg : code[i + 1].arg;
+                out.push_back(DecodedInstr{ *op, code[i].pc, arg });
+                newIndex[i + 1] = newIndex[i];
+                ++i;
+                continue;
+            }
+        }
+        out.push_back(code[i]);
+    }
+    for (DecodedInstr& d : out) {
+        if (is_jump(d.op)) d.arg = newIndex[static_cast<std::size_t>(d.arg)];
+    }
+    return out;
+}
 
-    DUP = 0x08,    ///< Duplica o valor no topo da pilha.
-    SWAP = 0x09,   ///< Troca os dois valores no topo da pilha.
-    PUSH16 = 0x0A, ///< Empilha um valor de 16 bits: `PUSH16 <uint16_t>`.
-    JMP = 0x0B,    ///< Salto incondicional para endereo: `JMP <uint16_t addr>`.
-    JZ = 0x0C      ///< Salto condicional se zero: `JZ <uint16_t addr>`.
+// =========================== Mquina de registradores ===========================
+
+/**
+ * @enum RegOp
+ * @brief Instrues de trs endereos executadas pelo modo `Dispatch::Register`.
+ *
+ * Operam sobre um banco de registradores `r[]` em vez da pilha: `ADD a, b, c` faz
+ * `r[a] = r[b] + r[c]`. Os saltos carregam o ndice da instruo de destino em `imm`.
+ */
+enum class RegOp : Byte {
+    HALT,
+    LOADI, ///< r[a] = imm
+    MOV,   ///< r[a] = r[b]
+    SWAP,  ///< troca r[a] e r[b]
+    ADD,   ///< r[a] = r[b] + r[c]
+    SUB,   ///< r[a] = r[b] - r[c]
+    MUL,   ///< r[a] = r[b] * r[c]
+    DIV,   ///< r[a] = r[b] / r[c] (erro se r[c] == 0)
+    ADDI,  ///< r[a] = r[b] + imm
+    SUBI,  ///< r[a] = r[b] - imm
+    MULI,  ///< r[a] = r[b] * imm
+    DIVI,  ///< r[a] = r[b] / imm (imm != 0)
+    PRINT, ///< imprime r[a]
+    JMP,   ///< salta para imm
+    JZ,    ///< salta para imm se r[a] == 0
+    JNZ,   ///< salta para imm se r[a] != 0
+    JLT,   ///< salta para imm se r[a] < r[b]
+    LOAD,  ///< r[a] = data[imm]
+    STORE, ///< data[imm] = r[a]
+    CALL,  ///< empilha o ndice de retorno e salta para imm
+    RET,   ///< retorna ao ndice guardado pelo `CALL` correspondente
+    NOP    ///< Usado s durante a traduo (vem de `POP`); nunca chega ao programa final.
 };
 
 /**
- * @brief Lista constante de opcodes vlidos para validao rpida.
- *
- * @note O uso de `constexpr std::array` permite que essa lista seja construda em tempo de compilao,
- * otimizando a verificao de segurana sem custo de tempo de execuo para inicializao.
- */
-constexpr std::array<Byte, 13> kValidOpcodes = {
-    static_cast<Byte>(Opcode::HALT),
-    static_cast<Byte>(Opcode::PUSH),
-    static_cast<Byte>(Opcode::POP),
-    static_cast<Byte>(Opcode::ADD),
-    static_cast<Byte>(Opcode::SUB),
-    static_cast<Byte>(Opcode::MUL),
-    static_cast<Byte>(Opcode::DIV),
-    static_cast<Byte>(Opcode::PRINT),
-    static_cast<Byte>(Opcode::DUP),
-    static_cast<Byte>(Opcode::SWAP),
-    static_cast<Byte>(Opcode::PUSH16),
-    static_cast<Byte>(Opcode::JMP),
-    static_cast<Byte>(Opcode::JZ)
+ * @struct RegInstr
+ * @brief Instruo de registradores, de largura fixa (16 bytes).
+ */
+struct RegInstr {
+    RegOp op;          ///< Operao.
+    std::uint8_t a;    ///< Registrador de destino (ou testado por `PRINT`/`JZ`/`JNZ`).
+    std::uint8_t b;    ///< Primeiro operando.
+    std::uint8_t c;    ///< Segundo operando.
+    std::uint32_t pc;  ///< Endereo da instruo de pilha correspondente no bytecode (erros).
+    Int imm;           ///< Imediato, clula de `LOAD`/`STORE` ou ndice da instruo de destino.
 };
 
+/// @brief Tamanho mximo do banco de registradores (ndices de 8 bits).
+constexpr std::size_t kMaxRegisters = 256;
+
+/**
+ * @brief Indica se a instruo de registradores salta para o ndice guardado em `imm`.
+ */
+[[nodiscard]] constexpr bool is_jump(RegOp op) noexcept {
+    return op == RegOp::JMP || op == RegOp::JZ || op == RegOp::JNZ || op == RegOp::JLT || op == RegOp::CALL;
+}
+
 /**
- * @brief Verifica se um byte corresponde a um Opcode vlido.
+ * @brief Traduz um programa de pilha verificado para instrues de registradores.
  *
- * @param b O byte a ser verificado.
- * @return `true` se o byte for um opcode vlido, `false` caso contrrio.
+ * Como o verificador provou a profundidade da pilha antes de cada instruo, o slot `i` da
+ * pilha vira o registrador `r[i]` e cada instruo de pilha vira no mximo uma instruo de
+ * trs endereos: `PUSH k` -> `LOADI r[d], k`; `ADD` -> `ADD r[d-2], r[d-2], r[d-1]`;
+ * `DUP` -> `MOV r[d], r[d-1]`; `POP` desaparece. Em seguida um *peephole* (repetido at no
+ * haver mudana) elimina despachos:
+ * - `LOADI x, k; OP a, b, x`        -> `OPI a, b, k` (exceto `DIV` por zero);
+ * - `LOADI x, k1; OPI x, x, k2`     -> `LOADI x, k1 op k2` (dobra de constantes);
+ * - `MOV x, y; OP a, b, x`          -> `OP a, b, y` (exceto `DIV`, que pode falhar);
+ * - `MOV x, y; OPI x, x, k`         -> `OPI x, y, k`;
+ * - `MOV x, y; JZ/JNZ/PRINT/STORE x` -> a mesma instruo sobre `y`;
+ * - `JZ x, L; JMP M` com `L` logo aps o `JMP` -> `JNZ x, M`.
+ * Um par s  fundido se o registrador escrito pela primeira instruo estiver morto (fora da
+ * pilha) depois da segunda, ento nos limites das instrues restantes `r[0 .. profundidade)` 
+ * exatamente a pilha, inclusive quando um `DIV` falha: os erros e o estado final coincidem com
+ * os do interpretador de pilha.
  *
- * @note Destaque C++23:
- * - `[[nodiscard]]`: O compilador emitir um aviso se o retorno desta funo for ignorado.
- * - `constexpr`: Permite que esta verificao seja feita em tempo de compilao se o argumento for constante.
- * - `noexcept`: Garante que esta funo no lana excees.
+ * `CALL`/`RET` no precisam de tratamento especial: o verificador garante que cada funo 
+ * sempre chamada com a mesma profundidade, ento o corpo usa sempre os mesmos registradores.
+ *
+ * @param code Programa pr-decodificado, sem superinstrues.
+ * @param info Resultado do verificador.
+ * @return O programa de registradores; vazio se a pilha passar de `kMaxRegisters` (o modo
+ * `Register` recai ento no ncleo `Fast`).
  */
-[[nodiscard]] constexpr bool is_valid_opcode(Byte b) noexcept {
-    for (Byte v : kValidOpcodes) if (v == b) return true;
-    return false;
+[[nodiscard]] inline std::vector<RegInstr> translate_to_registers(const std::vector<DecodedInstr>& code,
+    const ProgramInfo& info) {
+    if (info.maxStackDepth > kMaxRegisters) return {};
+
+    std::vector<RegInstr> out;
+    out.reserve(code.size());
+    for (const DecodedInstr& ins : code) {
+        const int depth = info.depthAt[ins.pc];
+        RegInstr r{ RegOp::NOP, 0, 0, 0, ins.pc, 0 };
+        if (depth < 0) { // inalcanvel: mantm o ndice para no renumerar os saltos
+            out.push_back(r);
+            continue;
+        }
+        const auto top = static_cast<std::uint8_t>(depth - 1); // d-1 (no usado quando d == 0)
+        const auto below = static_cast<std::uint8_t>(depth - 2);
+        switch (ins.op) {
+        case MicroOp::HALT:  r.op = RegOp::HALT; break;
+        case MicroOp::PUSH:  r = { RegOp::LOADI, static_cast<std::uint8_t>(depth), 0, 0, ins.pc, ins.arg }; break;
+        case MicroOp::POP:   break;
+        case MicroOp::ADD:   r = { RegOp::ADD, below, below, top, ins.pc, 0 }; break;
+        case MicroOp::SUB:   r = { RegOp::SUB, below, below, top, ins.pc, 0 }; break;
+        case MicroOp::MUL:   r = { RegOp::MUL, below, below, top, ins.pc, 0 }; break;
+        case MicroOp::DIV:   r = { RegOp::DIV, below, below, top, ins.pc, 0 }; break;
+        case MicroOp::PRINT: r = { RegOp::PRINT, top, 0, 0, ins.pc, 0 }; break;
+        case MicroOp::DUP:   r = { RegOp::MOV, static_cast<std::uint8_t>(depth), top, 0, ins.pc, 0 }; break;
+        case MicroOp::SWAP:  r = { RegOp::SWAP, top, below, 0, ins.pc, 0 }; break;
+        case MicroOp::JMP:   r = { RegOp::JMP, 0, 0, 0, ins.pc, ins.arg }; break;
+        case MicroOp::JZ:    r = { RegOp::JZ, top, 0, 0, ins.pc, ins.arg }; break;
+        case MicroOp::JNZ:   r = { RegOp::JNZ, top, 0, 0, ins.pc, ins.arg }; break;
+        case MicroOp::JLT:   r = { RegOp::JLT, below, top, 0, ins.pc, ins.arg }; break;
+        case MicroOp::LOAD:  r = { RegOp::LOAD, static_cast<std::uint8_t>(depth), 0, 0, ins.pc, ins.arg }; break;
+        case MicroOp::STORE: r = { RegOp::STORE, top, 0, 0, ins.pc, ins.arg }; break;
+        case MicroOp::CALL:  r = { RegOp::CALL, 0, 0, 0, ins.pc, ins.arg }; break;
+        case MicroOp::RET:   r.op = RegOp::RET; break;
+        default:
+            throw VMError("Tradutor: micro-operao no suportada (o tradutor recebe o programa sem fuso)");
+        }
+        out.push_back(r);
+    }
+
+    auto immediateForm = [](RegOp op) -> std::optional<RegOp> {
+        switch (op) {
+        case RegOp::ADD: return RegOp::ADDI;
+        case RegOp::SUB: return RegOp::SUBI;
+        case RegOp::MUL: return RegOp::MULI;
+        case RegOp::DIV: return RegOp::DIVI;
+        default: return std::nullopt;
+        }
+    };
+    auto isImmediate = [](RegOp op) {
+        return op == RegOp::ADDI || op == RegOp::SUBI || op == RegOp::MULI || op == RegOp::DIVI;
+    };
+    auto fold = [](RegOp op, Int k1, Int k2) -> Int {
+        switch (op) {
+        case RegOp::ADDI: return wrap_add(k1, k2);
+        case RegOp::SUBI: return wrap_sub(k1, k2);
+        case RegOp::MULI: return wrap_mul(k1, k2);
+        default:          return wrap_div(k1, k2); // DIVI: k2 != 0
+        }
+    };
+    // Profundidade da pilha depois da instruo de pilha em cada endereo: um registrador
+    // r >= depthAfter[pc] no faz parte da pilha (est morto) depois dessa instruo.
+    std::vector<int> depthAfter(info.depthAt.size(), 0);
+    for (const DecodedInstr& ins : code) {
+        int delta = 0;
+        switch (ins.op) {
+        case MicroOp::PUSH: case MicroOp::DUP: case MicroOp::LOAD: delta = 1; break;
+        case MicroOp::HALT: case MicroOp::SWAP: case MicroOp::JMP: case MicroOp::CALL: case MicroOp::RET: delta = 0; break;
+        case MicroOp::JLT: delta = -2; break;
+        default: delta = -1; break; // POP, aritmtica, PRINT, JZ, JNZ, STORE
+        }
+        depthAfter[ins.pc] = info.depthAt[ins.pc] + delta;
+    }
+    auto deadAfter = [&](std::uint8_t reg, const RegInstr& r) { return reg >= depthAfter[r.pc]; };
+
+    // Funde o par (x, y) em uma instruo; std::nullopt se no houver padro. O registrador
+    // escrito por `x` e eliminado precisa estar morto depois de `y` e no ser lido de outra forma.
+    auto combine = [&](const RegInstr& x, const RegInstr& y, std::size_t next) -> std::optional<RegInstr> {
+        const bool binary = y.op == RegOp::ADD || y.op == RegOp::SUB || y.op == RegOp::MUL || y.op == RegOp::DIV;
+        if (x.op == RegOp::LOADI && binary && y.c == x.a && y.b != x.a && deadAfter(x.a, y)
+            && !(y.op == RegOp::DIV && x.imm == 0)) {
+            return RegInstr{ *immediateForm(y.op), y.a, y.b, 0, y.pc, x.imm };
+        }
+        if (x.op == RegOp::LOADI && isImmediate(y.op) && y.a == x.a && y.b == x.a) {
+            return RegInstr{ RegOp::LOADI, x.a, 0, 0, y.pc, fold(y.op, x.imm, y.imm) };
+        }
+        if (x.op == RegOp::MOV && binary && y.op != RegOp::DIV && y.c == x.a && y.b != x.a && deadAfter(x.a, y)) {
+            return RegInstr{ y.op, y.a, y.b, x.b, y.pc, 0 };
+        }
+        if (x.op == RegOp::MOV && isImmediate(y.op) && y.a == x.a && y.b == x.a) {
+            return RegInstr{ y.op, y.a, x.b, 0, y.pc, y.imm };
+        }
+        const bool unary = y.op == RegOp::JZ || y.op == RegOp::JNZ || y.op == RegOp::PRINT || y.op == RegOp::STORE;
+        if (x.op == RegOp::MOV && unary && y.a == x.a && deadAfter(x.a, y)) {
+            return RegInstr{ y.op, x.b, 0, 0, y.pc, y.imm };
+        }
+        if (x.op == RegOp::JZ && y.op == RegOp::JMP && static_cast<std::size_t>(x.imm) == next) {
+            return RegInstr{ RegOp::JNZ, x.a, 0, 0, x.pc, y.imm };
+        }
+        return std::nullopt;
+    };
+
+    for (bool changed = true; changed;) {
+        changed = false;
+        const std::size_t n = out.size();
+        std::vector<bool> isTarget(n, false);
+        for (const RegInstr& r : out) {
+            if (is_jump(r.op)) isTarget[static_cast<std::size_t>(r.imm)] = true;
+        }
+
+        // Marca como NOP a segunda instruo de cada par fundido (que no  destino de salto).
+        for (std::size_t i = 0; i + 1 < n; ++i) {
+            if (out[i].op == RegOp::NOP || isTarget[i + 1]) continue;
+            if (auto merged = combine(out[i], out[i + 1], i + 2)) {
+                out[i] = *merged;
+                out[i + 1].op = RegOp::NOP;
+                changed = true;
+                ++i;
+            }
+        }
+
+        // Remove os NOPs; um salto para um NOP passa a apontar para a instruo seguinte.
+        std::vector<std::uint32_t> newIndex(n + 1, 0);
+        std::vector<RegInstr> compact;
+        compact.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            newIndex[i] = static_cast<std::uint32_t>(compact.size());
+            if (out[i].op != RegOp::NOP) compact.push_back(out[i]);
+        }
+        newIndex[n] = static_cast<std::uint32_t>(compact.size());
+        for (RegInstr& r : compact) {
+            if (is_jump(r.op)) r.imm = newIndex[static_cast<std::size_t>(r.imm)];
+        }
+        out = std::move(compact);
+    }
+    return out;
 }
 
-// =========================== VirtualMachine Class ===========================
+// =========================== JIT x86-64 ===========================
 
 /**
- * @class VirtualMachine
- * @brief Representa a mquina virtual, contendo memria, pilha e lgica de execuo.
+ * @brief Indica se o host suporta o JIT de modelo (*template JIT*) para x86-64.
+ *
+ * O cdigo gerado segue a conveno de chamada System V (Linux, BSDs) e a memria executvel
+ *  obtida com `mmap`. Nos demais hosts (Windows, ARM...) o modo `Dispatch::Jit` recai no
+ * interpretador `Fast`.
  */
-class VirtualMachine {
-public:
-    /**
-     * @struct Config
-     * @brief Estrutura de configurao da VM.
-     */
-    struct Config {
-        Endianness endianness = Endianness::Big; ///< Define a ordem dos bytes para leitura de palavras (16 bits).
-        bool debug = false;                      ///< Se true, imprime o estado da pilha e IP a cada instruo.
-    };
+#ifndef VM_HAS_X64_JIT
+#if defined(__x86_64__) && defined(__unix__)
+#define VM_HAS_X64_JIT 1
+#else
+#define VM_HAS_X64_JIT 0
+#endif
+#endif
+
+#if VM_HAS_X64_JIT
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+#endif
 
-    /**
-     * @brief Construtor da Mquina Virtual.
-     *
-     * Inicializa a memria com o programa fornecido e define o Instruction Pointer (IP) como 0.
-     *
-     * @param program Vetor de bytes contendo o bytecode a ser executado.
-     * @param cfg Configuraes da VM (opcional).
-     */
-    explicit VirtualMachine(std::vector<Byte> program, Config cfg = {})
-        : memory_{ std::move(program) }, cfg_{ cfg }, ip_{ 0 }, running_{ true }
-    {
-        // nada extra
-    }
+/**
+ * @namespace jit
+ * @brief Tradutor de bytecode verificado para cdigo de mquina x86-64.
+ *
+ * Cada instruo vira um modelo fixo de cdigo nativo. Como o verificador provou a profundidade
+ * da pilha antes de cada instruo (`ProgramInfo::depthAt`), a posio de cada operando 
+ * conhecida em tempo de compilao: o slot `i` da pilha vive no registrador `kSlotRegs[i]`
+ * (os 5 primeiros) ou na clula `i` do *frame*. No existe ponteiro de pilha em tempo de
+ * execuo; `ADD` com os dois operandos em registradores  um nico `add`.
+ *
+ * O segmento de dados de `LOAD`/`STORE` fica no *frame*, logo aps a pilha, em deslocamentos
+ * constantes. `CALL`/`RET` usam `call`/`ret` nativos (o preditor de retorno da CPU acerta os
+ * destinos); um contador no *frame* impe `kMaxCallDepth`.
+ */
+namespace jit {
+    /// @brief Cdigos de retorno da funo gerada.
+    enum class Exit : std::int64_t {
+        Halt = 0,             ///< `HALT` executado.
+        DivideByZero = 1,     ///< `DIV` com divisor zero.
+        CallStackOverflow = 2, ///< `CALL` alm de `kMaxCallDepth`.
+        PrintFailed = 3        ///< O helper de `PRINT` falhou (o *sink* lanou uma exceo).
+    };
 
     /**
-     * @brief Executa o ciclo principal da VM (Fetch-Decode-Execute).
-     *
-     * O loop continua at que:
-     * 1. A instruo `HALT` seja encontrada.
-     * 2. Uma exceo `VMError` seja lanada (erro de execuo).
-     * 3. O IP ultrapasse o tamanho da memria.
+     * @brief Layout do *frame* (um array de `Int`) recebido pela funo gerada em `rdi`.
      *
-     * @throws VMError Se ocorrer um erro fatal durante a execuo.
+     * Ao sair, a funo grava a profundidade da pilha e o endereo da instruo corrente, e
+     * descarrega os registradores nas suas clulas, para que a VM reconstrua `stack_` e `ip_`.
      */
-    void run() {
-        try {
-            while (running_) {
-                if (ip_ >= memory_.size()) {
-                    throw VMError("IP fora dos limites da memria: " + std::to_string(ip_));
-                }
-
-                const Byte raw = fetchByteNoAdvance(); // peek para validar antes de consumir
-                if (!is_valid_opcode(raw)) {
-                    std::ostringstream oss;
-                    oss << "Opcode invlido lido em IP=" << ip_ << " : 0x"
-                        << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(raw);
-                    throw VMError(oss.str());
-                }
-
-                const Opcode op = static_cast<Opcode>(fetchByte()); // agora consome
-                execute(op);
+    enum FrameSlot : std::int32_t {
+        kFrameContext = 0,   ///< Ponteiro opaco repassado ao helper de `PRINT`.
+        kFrameDepth = 1,     ///< Profundidade da pilha na sada.
+        kFramePc = 2,        ///< Endereo (no bytecode) da instruo em que a execuo parou.
+        kFrameCalls = 3,     ///< Chamadas (`CALL`) em andamento.
+        kFrameRsp = 4,       ///< `rsp` na entrada, restaurado na sada (mesmo de dentro de uma funo).
+        kFrameSlots = 5      ///< Primeira clula da pilha.
+    };
 
-                if (cfg_.debug) debugDumpState(op);
-            }
-        }
-        catch (...) {
-            // relana a exceo para o chamador aps imprimir contexto
-            std::cerr << "[VM] Exceo em execuo. estado final: ip=" << ip_
-                << " stack_size=" << stack_.size() << std::endl;
-            throw;
-        }
-    }
+    /// @brief Slots da pilha mantidos em registradores (todos *callee-saved* na System V).
+    constexpr std::size_t kRegSlots = 5;
 
-private:
-    std::vector<Byte> memory_; ///< Memria de programa (Bytecode).
-    std::vector<Int> stack_;   ///< Pilha de operandos.
-    Config cfg_;               ///< Configuraes da instncia.
-    Address ip_;               ///< Instruction Pointer (Apontador de Instruo).
-    bool running_;             ///< Flag de controle do loop principal.
+    /// @brief Assinatura do helper chamado por `PRINT`: devolve 0 em caso de sucesso, ou outro valor
+    /// para encerrar a execuo com `Exit::PrintFailed`.
+    using PrintHelper = std::int64_t (*)(void* context, Int value) noexcept;
 
-    // =================== Helpers de fetch ===================
+    /// @brief Assinatura da funo gerada.
+    using EntryPoint = std::int64_t (*)(Int* frame);
 
     /**
-     * @brief L o byte atual apontado pelo IP sem avanar o ponteiro.
-     * @return O byte lido.
-     * @throws VMError Se o IP estiver fora dos limites.
-     * @note `[[nodiscard]]` incentiva o uso do valor retornado.
+     * @brief ndice, no *frame*, da clula 0 do segmento de dados (logo aps a pilha).
      */
-    [[nodiscard]] Byte fetchByteNoAdvance() const {
-        if (ip_ >= memory_.size()) throw VMError("fetchByteNoAdvance: IP fora do intervalo");
-        return memory_[ip_];
+    [[nodiscard]] inline std::size_t frame_data(const ProgramInfo& info) noexcept {
+        return kFrameSlots + std::max(info.maxStackDepth, kRegSlots);
     }
 
     /**
-     * @brief L o byte atual e avana o IP.
-     * @return O byte lido.
-     * @throws VMError Se o IP estiver fora dos limites.
+     * @brief Nmero de clulas do *frame* necessrias para um programa.
      */
-    [[nodiscard]] Byte fetchByte() {
-        if (ip_ >= memory_.size()) throw VMError("fetchByte: IP fora do intervalo");
-        return memory_[ip_++];
+    [[nodiscard]] inline std::size_t frame_size(const ProgramInfo& info) noexcept {
+        return frame_data(info) + info.dataSlots;
     }
 
+#if VM_HAS_X64_JIT
     /**
-     * @brief L uma palavra de 16 bits (2 bytes) e avana o IP em 2 posies.
+     * @class Code
+     * @brief Regio de memria executvel (RAII sobre `mmap`/`munmap`).
      *
-     * Respeita a configurao de *Endianness* definida em `cfg_`.
-     *
-     * @return A palavra de 16 bits combinada.
-     * @throws VMError Se houver menos de 2 bytes disponveis.
+     * A regio  escrita enquanto tem permisso de leitura/escrita e s ento passa a
+     * leitura/execuo (W^X): nunca  gravvel e executvel ao mesmo tempo.
      */
-    [[nodiscard]] Word16 fetchWord() {
-        // Le 2 bytes de memory_ respeitando endianness da config
-        if (ip_ + 1 >= memory_.size()) throw VMError("fetchWord: leitura fora dos limites");
-        Byte b0 = memory_[ip_];
-        Byte b1 = memory_[ip_ + 1];
-        ip_ += 2;
-        if (cfg_.endianness == Endianness::Big) {
-            return static_cast<Word16>((static_cast<Word16>(b0) << 8) | static_cast<Word16>(b1));
+    class Code {
+    public:
+        Code() = default;
+        Code(const Code&) = delete;
+        Code& operator=(const Code&) = delete;
+        Code(Code&& o) noexcept : mem_{ std::exchange(o.mem_, nullptr) }, size_{ std::exchange(o.size_, 0) } {}
+        Code& operator=(Code&& o) noexcept {
+            if (this != &o) {
+                release();
+                mem_ = std::exchange(o.mem_, nullptr);
+                size_ = std::exchange(o.size_, 0);
+            }
+            return *this;
         }
-        else {
-            return static_cast<Word16>((static_cast<Word16>(b1) << 8) | static_cast<Word16>(b0));
+        ~Code() { release(); }
+
+        /**
+         * @brief Copia o cdigo gerado para uma regio nova e a torna executvel.
+         * @return `false` se o sistema recusar o mapeamento (ex.: poltica W^X estrita).
+         */
+        [[nodiscard]] bool load(const std::vector<Byte>& bytes) {
+            release();
+            const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+            const std::size_t size = (bytes.size() + page - 1) / page * page;
+            void* mem = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mem == MAP_FAILED) return false;
+            std::memcpy(mem, bytes.data(), bytes.size());
+            if (mprotect(mem, size, PROT_READ | PROT_EXEC) != 0) {
+                munmap(mem, size);
+                return false;
+            }
+            mem_ = mem;
+            size_ = size;
+            return true;
         }
-    }
 
-    // =================== Stack checks & ops ===================
+        [[nodiscard]] EntryPoint entry() const noexcept { return reinterpret_cast<EntryPoint>(mem_); }
+        [[nodiscard]] explicit operator bool() const noexcept { return mem_ != nullptr; }
 
-    /**
-     * @brief Garante que a pilha tenha um nmero mnimo de elementos.
-     * @param n Quantidade necessria de elementos.
-     * @param opName Nome da operao que solicitou a verificao (para log).
-     * @throws VMError Se a pilha no tiver elementos suficientes (Stack Underflow).
-     */
-    void ensureStackHas(std::size_t n, std::string_view opName) const {
-        if (stack_.size() < n) {
-            std::ostringstream oss;
-            oss << "Pilha insuficiente para " << opName
-                << " (necessrio: " << n << ", disponvel: " << stack_.size() << ")";
-            throw VMError(oss.str());
+    private:
+        void release() noexcept {
+            if (mem_) munmap(mem_, size_);
+            mem_ = nullptr;
+            size_ = 0;
         }
-    }
+
+        void* mem_ = nullptr;
+        std::size_t size_ = 0;
+    };
 
     /**
-     * @brief Executa uma operao binria genrica.
-     *
-     * Desempilha dois valores ($b$, depois $a$), aplica a funo $f(a, b)$ e 
-     * empilha o resultado.
+     * @class Emitter
+     * @brief Codificador mnimo das instrues x86-64 usadas pelos modelos.
      *
-     * @param func Lambda ou funo que aceita dois `Int` e retorna um `Int`.
-     * @param name Nome da operao (para mensagens de erro).
+     * Registradores so identificados pelo nmero da codificao (rax=0 ... r15=15). Todas as
+     * operaes so de 64 bits (prefixo REX.W).
      */
-    void binaryOp(const std::function<Int(Int, Int)>& func, std::string_view name) {
-        ensureStackHas(2, name);
-        Int b = stack_.back(); stack_.pop_back();
-        Int a = stack_.back(); stack_.pop_back();
-        Int r = func(a, b);
-        stack_.push_back(r);
-    }
+    class Emitter {
+    public:
+        enum Reg : int { RAX = 0, RCX = 1, RDX = 2, RBX = 3, RSP = 4, RBP = 5, RSI = 6, RDI = 7,
+                         R12 = 12, R13 = 13, R14 = 14, R15 = 15 };
 
+        std::vector<Byte> bytes;
 
+        [[nodiscard]] std::size_t size() const noexcept { return bytes.size(); }
 
-    // =================== Execuo do opcode ===================
+        void byte(int b) { bytes.push_back(static_cast<Byte>(b)); }
+        void imm32(std::int32_t v) {
+            for (int i = 0; i < 4; ++i) byte((static_cast<std::uint32_t>(v) >> (8 * i)) & 0xFF);
+        }
+        void imm64(std::int64_t v) {
+            for (int i = 0; i < 8; ++i) byte((static_cast<std::uint64_t>(v) >> (8 * i)) & 0xFF);
+        }
+
+        /// @brief Prefixo REX.W com as extenses dos campos `reg` e `rm` do ModRM.
+        void rexW(int reg, int rm) { byte(0x48 | ((reg >> 3) << 2) | (rm >> 3)); }
+        void modrmReg(int reg, int rm) { byte(0xC0 | ((reg & 7) << 3) | (rm & 7)); }
+        /// @brief ModRM para `[rbp + disp32]`.
+        void modrmFrame(int reg, std::int32_t disp) {
+            byte(0x80 | ((reg & 7) << 3) | RBP);
+            imm32(disp);
+        }
+
+        void push(int r) { if (r >= 8) byte(0x41); byte(0x50 + (r & 7)); }
+        void pop(int r) { if (r >= 8) byte(0x41); byte(0x58 + (r & 7)); }
+        void ret() { byte(0xC3); }
+        void ud2() { byte(0x0F); byte(0x0B); }
+
+        void movRR(int dst, int src) { if (dst == src) return; rexW(src, dst); byte(0x89); modrmReg(src, dst); }
+        void load(int dst, std::int32_t disp) { rexW(dst, RBP); byte(0x8B); modrmFrame(dst, disp); }
+        void store(std::int32_t disp, int src) { rexW(src, RBP); byte(0x89); modrmFrame(src, disp); }
+        void movRI(int dst, std::int64_t v) {
+            if (v >= INT32_MIN && v <= INT32_MAX) {
+                rexW(0, dst); byte(0xC7); modrmReg(0, dst); imm32(static_cast<std::int32_t>(v));
+            }
+            else {
+                rexW(0, dst); byte(0xB8 + (dst & 7)); imm64(v);
+            }
+        }
+        /// @brief `mov qword [rbp + disp], imm32` (com extenso de sinal).
+        void storeImm(std::int32_t disp, std::int32_t v) { rexW(0, RBP); byte(0xC7); modrmFrame(0, disp); imm32(v); }
+
+        void add(int dst, int src) { rexW(src, dst); byte(0x01); modrmReg(src, dst); }
+        void sub(int dst, int src) { rexW(src, dst); byte(0x29); modrmReg(src, dst); }
+        void imul(int dst, int src) { rexW(dst, src); byte(0x0F); byte(0xAF); modrmReg(dst, src); }
+        void test(int a, int b) { rexW(b, a); byte(0x85); modrmReg(b, a); }
+        /// @brief `cmp a, b` (flags de `a - b`).
+        void cmp(int a, int b) { rexW(b, a); byte(0x39); modrmReg(b, a); }
+        /// @brief `cmp qword [rbp + disp], imm32`.
+        void cmpFrameImm(std::int32_t disp, std::int32_t v) { rexW(0, RBP); byte(0x81); modrmFrame(7, disp); imm32(v); }
+        void incFrame(std::int32_t disp) { rexW(0, RBP); byte(0xFF); modrmFrame(0, disp); }
+        void decFrame(std::int32_t disp) { rexW(0, RBP); byte(0xFF); modrmFrame(1, disp); }
+        void cmpImm8(int r, std::int8_t v) { rexW(0, r); byte(0x83); modrmReg(7, r); byte(static_cast<Byte>(v)); }
+        void neg(int r) { rexW(0, r); byte(0xF7); modrmReg(3, r); }
+        void cqo() { byte(0x48); byte(0x99); }
+        void idiv(int r) { rexW(0, r); byte(0xF7); modrmReg(7, r); }
+        void subRspImm8(std::int8_t v) { byte(0x48); byte(0x83); byte(0xEC); byte(static_cast<Byte>(v)); }
+        void addRspImm8(std::int8_t v) { byte(0x48); byte(0x83); byte(0xC4); byte(static_cast<Byte>(v)); }
+        void callReg(int r) { if (r >= 8) byte(0x41); byte(0xFF); byte(0xD0 | (r & 7)); }
+
+        /// @brief `jmp rel32`; devolve a posio do deslocamento para ser corrigido depois.
+        [[nodiscard]] std::size_t jmp() { byte(0xE9); imm32(0); return size() - 4; }
+        /// @brief `call rel32`; devolve a posio do deslocamento para ser corrigido depois.
+        [[nodiscard]] std::size_t call() { byte(0xE8); imm32(0); return size() - 4; }
+        /// @brief `jcc rel32` (`cc` = 0x3 para JAE, 0x4 para JZ/JE, 0x5 para JNZ/JNE, 0xC para JL).
+        [[nodiscard]] std::size_t jcc(int cc) { byte(0x0F); byte(0x80 | cc); imm32(0); return size() - 4; }
+        /// @brief Faz o salto cujo deslocamento est em `at` apontar para `target`.
+        void patch(std::size_t at, std::size_t target) {
+            const auto rel = static_cast<std::int32_t>(static_cast<std::int64_t>(target) - static_cast<std::int64_t>(at + 4));
+            for (int i = 0; i < 4; ++i) bytes[at + i] = static_cast<Byte>((static_cast<std::uint32_t>(rel) >> (8 * i)) & 0xFF);
+        }
+    };
 
     /**
-     * @brief Despacha e executa uma nica instruo baseada no Opcode.
-     * @param op O Opcode a ser executado.
+     * @brief Traduz um programa verificado e pr-decodificado (sem superinstrues) para x86-64.
+     *
+     * Conveno da funo gerada: `int64_t f(Int* frame)`; `rbp` aponta para o *frame* durante
+     * toda a execuo; `rax`, `rcx` e `rdx` so temporrios. `PRINT` chama `print(frame[0], v)` e
+     * sai por `Exit::PrintFailed` se ele devolver um valor diferente de 0; os slots em registradores
+     * sobrevivem  chamada por serem *callee-saved*. Erros saem por
+     * *stubs* que gravam profundidade e instruo no *frame* e retornam o `Exit` correspondente:
+     * nenhuma exceo C++ atravessa o cdigo gerado.
+     *
+     * Cada funo (alvo de `CALL`) ganha uma entrada que desconta os 8 bytes do endereo de
+     * retorno (`sub rsp, 8`), mantendo `rsp` alinhado em 16 nas chamadas de `PRINT`; saltos
+     * dentro da funo usam o rtulo seguinte. O eplogo restaura `rsp` do *frame*, ento um
+     * erro pode sair de qualquer profundidade de chamadas.
+     *
+     * @param code Instrues pr-decodificadas (sem fuso).
+     * @param info Resultado do verificador (profundidade antes de cada instruo).
+     * @param print Helper chamado por `PRINT`.
+     * @return Os bytes do cdigo de mquina.
      */
-    void execute(Opcode op) {
-        switch (op) {
-        case Opcode::HALT:
-            running_ = false;
-            return;
-
-        case Opcode::PUSH: {
-            Byte v = fetchByte();
-            stack_.push_back(static_cast<Int>(v));
-            return;
+    [[nodiscard]] inline std::vector<Byte> compile(const std::vector<DecodedInstr>& code,
+        const ProgramInfo& info, PrintHelper print) {
+        using E = Emitter;
+        static constexpr std::array<int, kRegSlots> kSlotRegs = { E::RBX, E::R12, E::R13, E::R14, E::R15 };
+        constexpr std::array<int, 6> kSaved = { E::RBX, E::RBP, E::R12, E::R13, E::R14, E::R15 };
+
+        E e;
+        auto cell = [](std::size_t i) { return static_cast<std::int32_t>((kFrameSlots + i) * sizeof(Int)); };
+        auto frameCell = [](FrameSlot s) { return static_cast<std::int32_t>(s * sizeof(Int)); };
+        auto dataCell = [&](Int k) { return static_cast<std::int32_t>((frame_data(info) + static_cast<std::size_t>(k)) * sizeof(Int)); };
+        auto inReg = [](std::size_t slot) { return slot < kRegSlots; };
+        // Copia o slot para um registrador qualquer / grava um registrador no slot.
+        auto get = [&](int dst, std::size_t slot) {
+            if (inReg(slot)) e.movRR(dst, kSlotRegs[slot]); else e.load(dst, cell(slot));
+        };
+        auto put = [&](std::size_t slot, int src) {
+            if (inReg(slot)) e.movRR(kSlotRegs[slot], src); else e.store(cell(slot), src);
+        };
+
+        // Prlogo: salva os callee-saved (6 pushes + 8 = pilha alinhada em 16 para as chamadas).
+        for (int r : kSaved) e.push(r);
+        e.subRspImm8(8);
+        e.movRR(E::RBP, E::RDI);
+        e.store(frameCell(kFrameRsp), E::RSP);
+        e.storeImm(frameCell(kFrameCalls), 0);
+
+        std::vector<bool> isFunction(code.size(), false);
+        for (const DecodedInstr& ins : code) {
+            if (ins.op == MicroOp::CALL) isFunction[static_cast<std::size_t>(ins.arg)] = true;
+        }
+        std::vector<std::size_t> entry(code.size(), 0);
+
+        struct Fixup { std::size_t at; std::size_t target; };
+        struct Stub { std::size_t at; int depth; std::uint32_t pc; Exit exit; };
+        std::vector<std::size_t> label(code.size(), 0);
+        std::vector<Fixup> fixups;
+        std::vector<Fixup> calls;
+        std::vector<Stub> stubs;
+        std::vector<std::size_t> toEpilogue;
+
+        for (std::size_t i = 0; i < code.size(); ++i) {
+            if (isFunction[i]) {
+                const std::size_t skip = e.jmp(); // quem chega sem CALL entra pelo rtulo
+                entry[i] = e.size();
+                e.subRspImm8(8);
+                e.patch(skip, e.size());
+            }
+            label[i] = e.size();
+            const DecodedInstr& ins = code[i];
+            const int depth = info.depthAt[ins.pc];
+            if (depth < 0) { e.ud2(); continue; } // inalcanvel
+            const auto d = static_cast<std::size_t>(depth);
+
+            switch (ins.op) {
+            case MicroOp::HALT:
+                stubs.push_back(Stub{ 0, depth, ins.pc, Exit::Halt });
+                stubs.back().at = e.jmp();
+                break;
+            case MicroOp::PUSH:
+                if (inReg(d)) e.movRI(kSlotRegs[d], ins.arg);
+                else { e.movRI(E::RAX, ins.arg); e.store(cell(d), E::RAX); }
+                break;
+            case MicroOp::POP:
+                break;
+            case MicroOp::ADD:
+            case MicroOp::SUB:
+            case MicroOp::MUL: {
+                const bool regs = inReg(d - 1); // d-2 < d-1 < 5
+                const int a = regs ? kSlotRegs[d - 2] : E::RAX;
+                const int b = regs ? kSlotRegs[d - 1] : E::RCX;
+                if (!regs) { get(E::RAX, d - 2); get(E::RCX, d - 1); }
+                if (ins.op == MicroOp::ADD) e.add(a, b);
+                else if (ins.op == MicroOp::SUB) e.sub(a, b);
+                else e.imul(a, b);
+                if (!regs) put(d - 2, E::RAX);
+                break;
+            }
+            case MicroOp::DIV: {
+                get(E::RAX, d - 2);
+                get(E::RCX, d - 1);
+                e.test(E::RCX, E::RCX);
+                stubs.push_back(Stub{ 0, depth - 2, ins.pc, Exit::DivideByZero }); // sai sem os operandos, como os interpretadores
+                stubs.back().at = e.jcc(0x4);
+                // idiv gera #DE em INT64_MIN / -1; a / -1 == -a (com *wraparound*).
+                e.cmpImm8(E::RCX, -1);
+                const std::size_t notMinusOne = e.jcc(0x5);
+                e.neg(E::RAX);
+                const std::size_t done = e.jmp();
+                e.patch(notMinusOne, e.size());
+                e.cqo();
+                e.idiv(E::RCX);
+                e.patch(done, e.size());
+                put(d - 2, E::RAX);
+                break;
+            }
+            case MicroOp::PRINT:
+                e.load(E::RDI, frameCell(kFrameContext));
+                get(E::RSI, d - 1);
+                e.movRI(E::RAX, static_cast<std::int64_t>(reinterpret_cast<std::uintptr_t>(print)));
+                e.callReg(E::RAX);
+                e.test(E::RAX, E::RAX);
+                stubs.push_back(Stub{ 0, depth, ins.pc, Exit::PrintFailed });
+                stubs.back().at = e.jcc(0x5);
+                break;
+            case MicroOp::DUP:
+                if (inReg(d - 1) && inReg(d)) e.movRR(kSlotRegs[d], kSlotRegs[d - 1]);
+                else { get(E::RAX, d - 1); put(d, E::RAX); }
+                break;
+            case MicroOp::SWAP:
+                get(E::RAX, d - 1);
+                get(E::RCX, d - 2);
+                put(d - 1, E::RCX);
+                put(d - 2, E::RAX);
+                break;
+            case MicroOp::JMP:
+                fixups.push_back(Fixup{ e.jmp(), static_cast<std::size_t>(ins.arg) });
+                break;
+            case MicroOp::JZ:
+                if (inReg(d - 1)) e.test(kSlotRegs[d - 1], kSlotRegs[d - 1]);
+                else { get(E::RAX, d - 1); e.test(E::RAX, E::RAX); }
+                fixups.push_back(Fixup{ e.jcc(0x4), static_cast<std::size_t>(ins.arg) });
+                break;
+            case MicroOp::JNZ:
+                if (inReg(d - 1)) e.test(kSlotRegs[d - 1], kSlotRegs[d - 1]);
+                else { get(E::RAX, d - 1); e.test(E::RAX, E::RAX); }
+                fixups.push_back(Fixup{ e.jcc(0x5), static_cast<std::size_t>(ins.arg) });
+                break;
+            case MicroOp::JLT:
+                if (inReg(d - 1)) e.cmp(kSlotRegs[d - 2], kSlotRegs[d - 1]);
+                else { get(E::RAX, d - 2); get(E::RCX, d - 1); e.cmp(E::RAX, E::RCX); }
+                fixups.push_back(Fixup{ e.jcc(0xC), static_cast<std::size_t>(ins.arg) });
+                break;
+            case MicroOp::LOAD:
+                if (inReg(d)) e.load(kSlotRegs[d], dataCell(ins.arg));
+                else { e.load(E::RAX, dataCell(ins.arg)); e.store(cell(d), E::RAX); }
+                break;
+            case MicroOp::STORE:
+                if (inReg(d - 1)) e.store(dataCell(ins.arg), kSlotRegs[d - 1]);
+                else { get(E::RAX, d - 1); e.store(dataCell(ins.arg), E::RAX); }
+                break;
+            case MicroOp::CALL:
+                e.cmpFrameImm(frameCell(kFrameCalls), static_cast<std::int32_t>(kMaxCallDepth));
+                stubs.push_back(Stub{ 0, depth, ins.pc, Exit::CallStackOverflow });
+                stubs.back().at = e.jcc(0x3);
+                e.incFrame(frameCell(kFrameCalls));
+                calls.push_back(Fixup{ e.call(), static_cast<std::size_t>(ins.arg) });
+                break;
+            case MicroOp::RET:
+                e.decFrame(frameCell(kFrameCalls));
+                e.addRspImm8(8);
+                e.ret();
+                break;
+            default:
+                throw VMError("JIT: micro-operao no suportada (o JIT recebe o programa sem fuso)");
+            }
+        }
+        for (const Fixup& f : fixups) e.patch(f.at, label[f.target]);
+        for (const Fixup& f : calls) e.patch(f.at, entry[f.target]);
+
+        // Stubs de sada: registram onde a execuo parou e seguem para o eplogo.
+        for (const Stub& s : stubs) {
+            e.patch(s.at, e.size());
+            e.storeImm(frameCell(kFrameDepth), s.depth);
+            e.storeImm(frameCell(kFramePc), static_cast<std::int32_t>(s.pc));
+            e.movRI(E::RAX, static_cast<std::int64_t>(s.exit));
+            toEpilogue.push_back(e.jmp());
         }
 
-        case Opcode::POP:
-            ensureStackHas(1, "POP");
-            stack_.pop_back();
-            return;
+        // Eplogo: descarrega os slots em registradores no frame e restaura os callee-saved.
+        for (std::size_t at : toEpilogue) e.patch(at, e.size());
+        e.load(E::RSP, frameCell(kFrameRsp));
+        for (std::size_t s = 0; s < kRegSlots; ++s) e.store(cell(s), kSlotRegs[s]);
+        e.addRspImm8(8);
+        for (auto it = kSaved.rbegin(); it != kSaved.rend(); ++it) e.pop(*it);
+        e.ret();
+        return std::move(e.bytes);
+    }
+#endif
+}
 
-        case Opcode::ADD:
-            binaryOp([](Int a, Int b) { return a + b; }, "ADD");
-            return;
+// =========================== Profiler ===========================
 
-        case Opcode::SUB:
-            binaryOp([](Int a, Int b) { return a - b; }, "SUB");
-            return;
+/**
+ * @brief Liga o cdigo de perfil da VM (`Config::profile`).
+ *
+ * Com `VM_PROFILE=0` (padro) os ganchos no lao de execuo no so compilados: o custo do
+ * profiler  zero e `Config::profile`  ignorado.
+ */
+#ifndef VM_PROFILE
+#define VM_PROFILE 0
+#endif
 
-        case Opcode::MUL:
-            binaryOp([](Int a, Int b) { return a * b; }, "MUL");
-            return;
+#if VM_PROFILE
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
-        case Opcode::DIV:
-            binaryOp([](Int a, Int b) {
-                if (b == 0) throw VMError("Diviso por zero");
-                return a / b;
-                }, "DIV");
-            return;
+/**
+ * @brief Contador de ciclos: `rdtsc` em x86; nos demais hosts, nanossegundos de `steady_clock`.
+ */
+[[nodiscard]] inline std::uint64_t read_cycles() noexcept {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
 
-        case Opcode::PRINT:
-            ensureStackHas(1, "PRINT");
-            std::cout << stack_.back() << '\n';
-            stack_.pop_back();
-            return;
+/**
+ * @class Profiler
+ * @brief Contagens e ciclos por opcode e histograma de pontos quentes por IP.
+ *
+ * Toda instruo  contada no seu opcode. Uma a cada `sampleEvery` instrues  tambm
+ * amostrada: seu IP entra no histograma e a sua execuo  medida com `rdtsc`. Com
+ * `sampleEvery = 1` o histograma  exato; valores maiores reduzem o custo das leituras do
+ * contador de ciclos, e os ciclos por opcode passam a ser estimados pela mdia das amostras.
+ */
+class Profiler {
+public:
+    Profiler(std::size_t programSize, std::uint32_t sampleEvery)
+        : every_{ std::max<std::uint32_t>(sampleEvery, 1) }, countdown_{ every_ }, ipHits_(programSize, 0)
+    {
+    }
 
-            // --- Extenses implementadas ---
-        case Opcode::DUP:
-            ensureStackHas(1, "DUP");
-            stack_.push_back(stack_.back());
-            return;
+    /**
+     * @brief Registra o incio da instruo `op` em `ip`.
+     * @return `true` se esta instruo  uma amostra (deve ser seguida de `end`).
+     */
+    [[nodiscard]] bool begin(Address ip, Byte op) noexcept {
+        ++counts_[op];
+        if (--countdown_ != 0) return false;
+        countdown_ = every_;
+        ++ipHits_[ip];
+        start_ = read_cycles();
+        return true;
+    }
 
-        case Opcode::SWAP: {
-            ensureStackHas(2, "SWAP");
-            std::swap(stack_[stack_.size() - 1], stack_[stack_.size() - 2]);
-            return;
-        }
+    /// @brief Encerra a medio da amostra iniciada por `begin`.
+    void end(Byte op) noexcept {
+        cycles_[op] += read_cycles() - start_;
+        ++samples_[op];
+    }
 
-        case Opcode::PUSH16: {
-            Word16 w = fetchWord();
-            stack_.push_back(static_cast<Int>(w));
-            return;
+    /**
+     * @brief Imprime a tabela por opcode e as `top` instrues mais quentes, com desmontagem.
+     */
+    void report(std::ostream& out, std::span<const Byte> code, Endianness endianness, std::size_t top) const {
+        std::uint64_t total = 0;
+        std::uint64_t amostras = 0;
+        double ciclosTotais = 0.0;
+        std::array<double, 256> estimados{};
+        for (std::size_t op = 0; op < 256; ++op) {
+            total += counts_[op];
+            amostras += samples_[op];
+            if (samples_[op] == 0) continue;
+            estimados[op] = static_cast<double>(cycles_[op]) / static_cast<double>(samples_[op]) * static_cast<double>(counts_[op]);
+            ciclosTotais += estimados[op];
         }
-
-        case Opcode::JMP: {
-            Word16 addr = fetchWord();
-            if (addr >= memory_.size()) {
-                throw VMError("JMP: endereo invlido: " + std::to_string(addr));
-            }
-            ip_ = static_cast<Address>(addr);
-            return;
+        if (total == 0) return;
+
+        const auto flags = out.flags();
+        out << "[VM PROFILE] " << total << " instrucoes, " << amostras << " amostras (1 a cada " << every_ << ")\n"
+            << std::left << std::setw(8) << "opcode" << std::right << std::setw(14) << "execucoes"
+            << std::setw(8) << "%" << std::setw(16) << "ciclos" << std::setw(8) << "%" << std::setw(12) << "ciclos/op" << "\n";
+        for (std::size_t op = 0; op < 256; ++op) {
+            if (counts_[op] == 0) continue;
+            out << std::left << std::setw(8) << opcode_name(static_cast<Opcode>(op)) << std::right
+                << std::setw(14) << counts_[op]
+                << std::setw(7) << std::fixed << std::setprecision(1) << 100.0 * static_cast<double>(counts_[op]) / static_cast<double>(total) << "%"
+                << std::setw(16) << std::setprecision(0) << estimados[op]
+                << std::setw(7) << std::setprecision(1) << (ciclosTotais > 0.0 ? 100.0 * estimados[op] / ciclosTotais : 0.0) << "%"
+                << std::setw(12) << (samples_[op] ? static_cast<double>(cycles_[op]) / static_cast<double>(samples_[op]) : 0.0) << "\n";
         }
 
-        case Opcode::JZ: {
-            Word16 addr = fetchWord();
-            ensureStackHas(1, "JZ");
-            Int value = stack_.back(); stack_.pop_back();
-            if (value == 0) {
-                if (addr >= memory_.size()) throw VMError("JZ: endereo invlido: " + std::to_string(addr));
-                ip_ = static_cast<Address>(addr);
-            }
+        std::vector<std::size_t> ips;
+        for (std::size_t ip = 0; ip < ipHits_.size(); ++ip) {
+            if (ipHits_[ip]) ips.push_back(ip);
+        }
+        const std::size_t n = std::min(top, ips.size());
+        std::partial_sort(ips.begin(), ips.begin() + static_cast<std::ptrdiff_t>(n), ips.end(),
+            [&](std::size_t a, std::size_t b) { return ipHits_[a] != ipHits_[b] ? ipHits_[a] > ipHits_[b] : a < b; });
+        out << "top " << n << " instrucoes (amostras por IP):\n";
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::size_t ip = ips[i];
+            std::ostringstream endereco;
+            endereco << "0x" << std::hex << std::uppercase << std::setw(4) << std::setfill('0') << ip;
+            out << "  " << endereco.str() << "  " << std::left << std::setw(14) << disassemble(code, ip, endianness)
+                << std::right << std::setw(12) << ipHits_[ip]
+                << std::setw(7) << std::setprecision(1) << 100.0 * static_cast<double>(ipHits_[ip]) / static_cast<double>(amostras) << "%\n";
+        }
+        out.flags(flags);
+    }
+
+private:
+    std::uint32_t every_;       ///< Perodo de amostragem, em instrues.
+    std::uint32_t countdown_;   ///< Instrues at a prxima amostra.
+    std::uint64_t start_ = 0;   ///< Ciclos no incio da amostra corrente.
+    std::array<std::uint64_t, 256> counts_{};  ///< Execues por opcode.
+    std::array<std::uint64_t, 256> cycles_{};  ///< Ciclos medidos por opcode (somente amostras).
+    std::array<std::uint64_t, 256> samples_{}; ///< Amostras por opcode.
+    std::vector<std::uint64_t> ipHits_;        ///< Amostras por endereo.
+};
+#endif
+
+// =========================== Sada ===========================
+
+/**
+ * @class OutputSink
+ * @brief Destino dos valores impressos por `PRINT`.
+ *
+ * A VM formata os valores no seu prprio buffer e entrega ao *sink* blocos de texto j
+ * prontos (uma ou mais linhas completas), nunca um valor por vez.
+ */
+class OutputSink {
+public:
+    virtual ~OutputSink() = default;
+
+    /**
+     * @brief Recebe um bloco de linhas completas.
+     */
+    virtual void write(std::string_view text) = 0;
+};
+
+/**
+ * @class StreamSink
+ * @brief Escreve em um `std::ostream` (por padro, `std::cout`).
+ */
+class StreamSink final : public OutputSink {
+public:
+    explicit StreamSink(std::ostream& out) : out_{ out } {}
+
+    void write(std::string_view text) override {
+        out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+private:
+    std::ostream& out_;
+};
+
+/**
+ * @class NullSink
+ * @brief Descarta a sada (benchmarks: mede execuo e formatao, sem E/S).
+ */
+class NullSink final : public OutputSink {
+public:
+    void write(std::string_view) override {}
+};
+
+/**
+ * @brief *Sink* padro, ligado a `std::cout`.
+ */
+[[nodiscard]] inline OutputSink& stdout_sink() {
+    static StreamSink sink{ std::cout };
+    return sink;
+}
+
+// =========================== Arquivo de bytecode ===========================
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @class MappedFile
+ * @brief Arquivo mapeado em memria somente para leitura (RAII sobre `mmap` / `MapViewOfFile`).
+ *
+ * As pginas vm do *page cache* do sistema: qualquer nmero de VMs (e de processos) que
+ * mapeie o mesmo arquivo compartilha uma nica cpia fsica do bytecode.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Mapeia o arquivo inteiro.
+     * @throws VMError Se o arquivo no puder ser aberto ou mapeado, ou se estiver vazio.
+     */
+    explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+        const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw VMError("No foi possvel abrir " + path);
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+            CloseHandle(file);
+            throw VMError("Arquivo vazio ou ilegvel: " + path);
+        }
+        const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file); // o mapeamento mantm o arquivo aberto
+        if (!mapping) throw VMError("No foi possvel mapear " + path);
+        const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping); // a viso mantm o mapeamento
+        if (!view) throw VMError("No foi possvel mapear " + path);
+        data_ = static_cast<const Byte*>(view);
+        size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw VMError("No foi possvel abrir " + path);
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            throw VMError("Arquivo vazio ou ilegvel: " + path);
+        }
+        void* view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd); // o mapeamento mantm o arquivo aberto
+        if (view == MAP_FAILED) throw VMError("No foi possvel mapear " + path);
+        data_ = static_cast<const Byte*>(view);
+        size_ = static_cast<std::size_t>(st.st_size);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        munmap(const_cast<Byte*>(data_), size_);
+#endif
+    }
+
+    [[nodiscard]] std::span<const Byte> bytes() const noexcept { return { data_, size_ }; }
+
+private:
+    const Byte* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+/**
+ * @namespace bytecode_file
+ * @brief Continer versionado de bytecode em disco (`.vmb`).
+ *
+ * Layout (inteiros em *little-endian*, independentemente do host):
+ *
+ * | offset | tamanho | campo                                                        |
+ * |--------|---------|--------------------------------------------------------------|
+ * | 0      | 4       | assinatura `"VMBC"`                                          |
+ * | 4      | 2       | verso do formato (`kVersion`)                               |
+ * | 6      | 2       | flags (`kFlagVerified`, `kFlagLittleEndian`)                 |
+ * | 8      | 4       | offset da seo de cdigo                                    |
+ * | 12     | 4       | tamanho da seo de cdigo                                   |
+ * | 16     | 4       | profundidade mxima da pilha (vlida com `kFlagVerified`)    |
+ * | 20     | 4       | FNV-1a de 32 bits da seo de cdigo                         |
+ * | 24     | 8       | reservado (zero)                                             |
+ *
+ * A seo de cdigo comea em um offset mltiplo de 8, para que o bytecode mapeado fique
+ * alinhado. Leitores rejeitam verses maiores que a sua; campos novos usam a rea reservada.
+ */
+namespace bytecode_file {
+    constexpr std::array<char, 4> kMagic = { 'V', 'M', 'B', 'C' };
+    constexpr std::uint16_t kVersion = 1;
+    constexpr std::size_t kHeaderSize = 32;
+    constexpr std::uint16_t kFlagVerified = 1u << 0;     ///< O gravador executou `verify_program`.
+    constexpr std::uint16_t kFlagLittleEndian = 1u << 1; ///< Operandos (de todas as larguras) em *little-endian*.
+
+    /// @brief Cabealho decodificado.
+    struct Header {
+        std::uint16_t version = kVersion;
+        std::uint16_t flags = 0;
+        std::uint32_t codeOffset = kHeaderSize;
+        std::uint32_t codeSize = 0;
+        std::uint32_t maxStackDepth = 0;
+        std::uint32_t checksum = 0;
+
+        [[nodiscard]] bool verified() const noexcept { return (flags & kFlagVerified) != 0; }
+        [[nodiscard]] Endianness endianness() const noexcept {
+            return (flags & kFlagLittleEndian) ? Endianness::Little : Endianness::Big;
+        }
+    };
+
+    /// @brief FNV-1a de 32 bits (detecta arquivos truncados ou corrompidos).
+    [[nodiscard]] inline std::uint32_t checksum(std::span<const Byte> data) noexcept {
+        std::uint32_t h = 2166136261u;
+        for (Byte b : data) h = (h ^ b) * 16777619u;
+        return h;
+    }
+
+    /**
+     * @brief Serializa um programa no formato `.vmb`.
+     *
+     * @param code Bytecode.
+     * @param endianness Ordem de bytes dos operandos de `code`.
+     * @param info Resultado do verificador; se presente, o arquivo  marcado como verificado.
+     */
+    [[nodiscard]] inline std::vector<Byte> serialize(std::span<const Byte> code, Endianness endianness,
+        const ProgramInfo* info) {
+        Header h;
+        h.flags = static_cast<std::uint16_t>((info ? kFlagVerified : 0)
+            | (endianness == Endianness::Little ? kFlagLittleEndian : 0));
+        h.codeSize = static_cast<std::uint32_t>(code.size());
+        h.maxStackDepth = info ? static_cast<std::uint32_t>(info->maxStackDepth) : 0;
+        h.checksum = checksum(code);
+
+        std::vector<Byte> out(kHeaderSize + code.size(), 0);
+        auto put = [&](std::size_t at, std::uint64_t value, std::size_t bytes) {
+            for (std::size_t i = 0; i < bytes; ++i) out[at + i] = static_cast<Byte>(value >> (8 * i));
+        };
+        std::copy(kMagic.begin(), kMagic.end(), out.begin());
+        put(4, h.version, 2);
+        put(6, h.flags, 2);
+        put(8, h.codeOffset, 4);
+        put(12, h.codeSize, 4);
+        put(16, h.maxStackDepth, 4);
+        put(20, h.checksum, 4);
+        std::copy(code.begin(), code.end(), out.begin() + kHeaderSize);
+        return out;
+    }
+
+    /**
+     * @brief Valida o cabealho e localiza a seo de cdigo.
+     *
+     * @param file Contedo do arquivo (tipicamente um `MappedFile`).
+     * @param header Recebe o cabealho decodificado.
+     * @return A seo de cdigo, apontando para dentro de `file` (sem cpia).
+     * @throws VMError Se a assinatura, a verso, os limites ou o *checksum* forem invlidos.
+     */
+    [[nodiscard]] inline std::span<const Byte> parse(std::span<const Byte> file, Header& header) {
+        auto get = [&](std::size_t at, std::size_t bytes) {
+            std::uint64_t value = 0;
+            for (std::size_t i = 0; i < bytes; ++i) value |= static_cast<std::uint64_t>(file[at + i]) << (8 * i);
+            return value;
+        };
+        if (file.size() < kHeaderSize || !std::equal(kMagic.begin(), kMagic.end(), file.begin())) {
+            throw VMError("Arquivo de bytecode: assinatura VMBC ausente");
+        }
+        header.version = static_cast<std::uint16_t>(get(4, 2));
+        header.flags = static_cast<std::uint16_t>(get(6, 2));
+        header.codeOffset = static_cast<std::uint32_t>(get(8, 4));
+        header.codeSize = static_cast<std::uint32_t>(get(12, 4));
+        header.maxStackDepth = static_cast<std::uint32_t>(get(16, 4));
+        header.checksum = static_cast<std::uint32_t>(get(20, 4));
+        if (header.version == 0 || header.version > kVersion) {
+            throw VMError("Arquivo de bytecode: verso " + std::to_string(header.version) + " no suportada");
+        }
+        if (header.codeOffset < kHeaderSize || header.codeOffset > file.size()
+            || header.codeSize > file.size() - header.codeOffset) {
+            throw VMError("Arquivo de bytecode: seo de cdigo fora do arquivo");
+        }
+        const auto code = file.subspan(header.codeOffset, header.codeSize);
+        if (checksum(code) != header.checksum) throw VMError("Arquivo de bytecode: checksum invlido");
+        return code;
+    }
+
+    /**
+     * @brief Grava um programa em disco no formato `.vmb`.
+     * @throws VMError Se o arquivo no puder ser escrito.
+     */
+    inline void write(const std::string& path, std::span<const Byte> code, Endianness endianness,
+        const ProgramInfo* info) {
+        const auto bytes = serialize(code, endianness, info);
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!out) throw VMError("No foi possvel gravar " + path);
+    }
+}
+
+/**
+ * @struct BytecodeImage
+ * @brief Programa carregado de um arquivo `.vmb` mapeado em memria.
+ *
+ * O cdigo no  copiado: `code` aponta para dentro do mapeamento, que vive enquanto houver
+ * uma referncia  imagem (ou a um `PreparedProgram` construdo a partir dela).
+ */
+struct BytecodeImage {
+    MappedFile file;               ///< Mapeamento somente leitura do arquivo.
+    bytecode_file::Header header;  ///< Cabealho validado.
+    std::span<const Byte> code;    ///< Seo de cdigo, dentro de `file`.
+
+    explicit BytecodeImage(const std::string& path)
+        : file{ path }, code{ bytecode_file::parse(file.bytes(), header) }
+    {
+    }
+
+    /**
+     * @brief Abre e valida um arquivo `.vmb`.
+     * @throws VMError Se o arquivo for invlido.
+     */
+    [[nodiscard]] static std::shared_ptr<const BytecodeImage> open(const std::string& path) {
+        return std::make_shared<const BytecodeImage>(path);
+    }
+};
+
+// =========================== Programa preparado ===========================
+
+/**
+ * @struct PreparedProgram
+ * @brief Programa pronto para execuo: bytecode, fatos do verificador e instrues pr-decodificadas.
+ *
+ *  imutvel depois de construdo e pode ser compartilhado (via `std::shared_ptr<const ...>`)
+ * por qualquer nmero de VMs, inclusive em threads diferentes: o estado mutvel de uma
+ * execuo (IP, pilha, contadores) fica inteiramente na `VirtualMachine`.
+ */
+struct PreparedProgram {
+    std::span<const Byte> bytecode;      ///< Bytecode original (em `storage` ou em `image`).
+    std::vector<Byte> storage;           ///< Dono do bytecode montado em memria.
+    std::shared_ptr<const BytecodeImage> image; ///< Dono do bytecode mapeado de um arquivo `.vmb`.
+    Endianness endianness = Endianness::Big; ///< Ordem de bytes usada na decodificao.
+    std::optional<ProgramInfo> info;     ///< Resultado do verificador (quando executado).
+    std::vector<DecodedInstr> decoded;   ///< Instrues pr-decodificadas (modos `Fast`/`Jit`).
+    std::vector<RegInstr> registers;     ///< Programa de registradores (modo `Register`).
+#if VM_HAS_X64_JIT
+    std::shared_ptr<const jit::Code> jit; ///< Cdigo nativo do modo `Jit` (nulo se a traduo no foi possvel).
+#endif
+};
+
+// =========================== VirtualMachine Class ===========================
+
+/**
+ * @class VirtualMachine
+ * @brief Representa a mquina virtual, contendo memria, pilha e lgica de execuo.
+ */
+class VirtualMachine {
+public:
+    /**
+     * @struct Config
+     * @brief Estrutura de configurao da VM.
+     */
+    struct Config {
+        Endianness endianness = Endianness::Big; ///< Define a ordem dos bytes para leitura de palavras (16 bits).
+        bool debug = false;                      ///< Se true, imprime o estado da pilha e IP a cada instruo.
+        Dispatch dispatch = Dispatch::Switch;    ///< Estratgia de despacho (o modo debug sempre usa `Switch`).
+        bool verify = false;                     ///< Executa o verificador na construo (sempre ligado em `Fast`).
+        bool fuse = true;                        ///< No modo `Fast`, funde pares frequentes em superinstrues.
+        OutputSink* output = nullptr;            ///< Destino de `PRINT` (no possudo); nulo = `std::cout`.
+        std::size_t outputBuffer = 64 * 1024;    ///< Bytes acumulados antes de entregar ao *sink*; 0 = um `write` por `PRINT`.
+        bool profile = false;                    ///< Perfil de execuo impresso em `std::cerr` ao final de `run()` (exige `VM_PROFILE=1`).
+        std::uint32_t profileSampleEvery = 1;    ///< Perfil: amostra (IP + ciclos) 1 a cada N instrues.
+        std::size_t profileTop = 10;             ///< Perfil: nmero de instrues quentes listadas.
+    };
+
+    /**
+     * @brief Construtor da Mquina Virtual.
+     *
+     * Inicializa a memria com o programa fornecido e define o Instruction Pointer (IP) como 0.
+     * No modo `Dispatch::Threaded` o programa  validado aqui, uma nica vez. No modo
+     * `Dispatch::Fast` (ou com `cfg.verify`) ele passa pelo verificador completo (`verify_program`).
+     * No modo `Dispatch::Jit` o programa verificado tambm  traduzido para cdigo nativo; se o
+     * host no tiver suporte, a VM executa o ncleo `Fast` (ver `jitActive()`).
+     *
+     * @param program Vetor de bytes contendo o bytecode a ser executado.
+     * @param cfg Configuraes da VM (opcional).
+     * @throws VMError Se o programa for rejeitado pela validao ou pelo verificador.
+     */
+    VirtualMachine(std::vector<Byte> program, Config cfg)
+        : VirtualMachine(prepare(std::move(program), cfg), cfg, nullptr)
+    {
+    }
+
+    /**
+     * @brief Constri uma VM sobre um programa j preparado e compartilhado.
+     *
+     * Nada  verificado, decodificado nem compilado aqui: o custo de construo  o de
+     * inicializar o estado da execuo (no modo `Jit`, s o *frame* da funo nativa, que 
+     * de cada VM; o cdigo nativo  o do programa).  o construtor usado pelo `VMPool`.
+     *
+     * @param program Programa preparado por `prepare()` com a mesma configurao.
+     * @param cfg Configuraes da VM.
+     * @param stack rea de pelo menos `program->info->maxStackDepth + 1` inteiros para a pilha do
+     * modo `Fast`, de propriedade do chamador (ex.: uma `StackArena`); se nula, a VM aloca a sua.
+     * @throws VMError Se o programa no tiver sido preparado para o modo pedido.
+     */
+    VirtualMachine(std::shared_ptr<const PreparedProgram> program, Config cfg, Int* stack)
+        : program_{ std::move(program) }, memory_{ program_->bytecode }, info_{ program_->info },
+        decoded_{ program_->decoded }, cfg_{ cfg }, ip_{ 0 }, running_{ true },
+        output_{ cfg.output ? *cfg.output : stdout_sink() },
+        // no modo debug a sada no  acumulada, para no se misturar fora de ordem com o dump
+        outputCapacity_{ cfg.debug ? 0 : cfg.outputBuffer }
+    {
+        data_.resize(info_ ? info_->dataSlots : data_slots(memory_, cfg_.endianness));
+        if (usesDecoded(cfg_)) {
+            if (!info_ || decoded_.empty()) {
+                throw VMError("Programa no preparado para o modo " + std::string(cfg_.dispatch == Dispatch::Jit ? "jit" : "fast"));
+            }
+#if VM_HAS_X64_JIT
+            if (cfg_.dispatch == Dispatch::Jit && program_->jit) jitFrame_.assign(jit::frame_size(*info_), 0);
+#endif
+            // +1: a posio 0  um slot descartvel usado quando a pilha est vazia (ver runFast).
+            if (!stack) {
+                fastStack_ = std::make_unique<Int[]>(info_->maxStackDepth + 1);
+                stack = fastStack_.get();
+            }
+            fastBase_ = stack;
+        }
+        else if (cfg_.dispatch == Dispatch::Threaded && !info_) {
+            validateProgram();
+        }
+#if VM_PROFILE
+        if (cfg_.profile) profiler_ = std::make_unique<Profiler>(memory_.size(), cfg_.profileSampleEvery);
+#endif
+    }
+
+    /**
+     * @brief Construtor com a configurao padro.
+     *
+     * @note Equivale a um argumento padro `Config cfg = {}`, que o GCC rejeita quando a struct
+     * aninhada tem inicializadores de membros e a classe externa ainda est incompleta.
+     */
+    explicit VirtualMachine(std::vector<Byte> program)
+        : VirtualMachine(std::move(program), Config{})
+    {
+    }
+
+    /**
+     * @brief Verifica e pr-decodifica um programa uma nica vez, para ser compartilhado.
+     *
+     * Faz o trabalho de carga que depende apenas do bytecode: o verificador (modos `Fast`/`Jit`
+     * ou `cfg.verify`), a pr-decodificao, a fuso de superinstrues (`cfg.fuse`) e, no modo
+     * `Jit`, a traduo para cdigo nativo.
+     *
+     * @param program Bytecode.
+     * @param cfg Configurao com que o programa ser executado.
+     * @return Programa imutvel, pronto para o construtor com `PreparedProgram`.
+     * @throws VMError Se o programa for rejeitado pelo verificador.
+     */
+    [[nodiscard]] static std::shared_ptr<const PreparedProgram> prepare(std::vector<Byte> program, const Config& cfg) {
+        auto prepared = std::make_shared<PreparedProgram>();
+        prepared->storage = std::move(program);
+        prepared->bytecode = prepared->storage;
+        prepared->endianness = cfg.endianness;
+        analyze(*prepared, cfg);
+        return prepared;
+    }
+
+    /**
+     * @brief Prepara um programa carregado de um arquivo `.vmb`, sem copiar o bytecode.
+     *
+     * Todas as VMs criadas a partir do resultado leem o cdigo direto do mapeamento. O programa
+     * passa pelo verificador como qualquer outro: a marca `kFlagVerified` e o checksum podem ser
+     * recalculados por quem adultera o arquivo, ento no provam nada sobre a pilha nem sobre o
+     * pareamento de `CALL`/`RET`. Quando o verificador roda, a profundidade mxima gravada por um
+     * arquivo marcado como verificado precisa coincidir com a calculada.
+     *
+     * @param image Arquivo aberto com `BytecodeImage::open`.
+     * @param cfg Configurao com que o programa ser executado.
+     * @throws VMError Se a *endianness* do arquivo diferir de `cfg.endianness`, se o programa for
+     * rejeitado ou se a profundidade do cabealho divergir da do verificador.
+     */
+    [[nodiscard]] static std::shared_ptr<const PreparedProgram> prepare(std::shared_ptr<const BytecodeImage> image, const Config& cfg) {
+        if (image->header.endianness() != cfg.endianness) {
+            throw VMError("Arquivo de bytecode: endianness diferente da configurao da VM");
+        }
+        auto prepared = std::make_shared<PreparedProgram>();
+        prepared->bytecode = image->code;
+        prepared->endianness = cfg.endianness;
+        prepared->image = std::move(image);
+        analyze(*prepared, cfg);
+        const auto& header = prepared->image->header;
+        if (prepared->info && header.verified() && header.maxStackDepth != prepared->info->maxStackDepth) {
+            throw VMError("Arquivo de bytecode: o cabealho declara pilha mxima " + std::to_string(header.maxStackDepth)
+                + ", o verificador calculou " + std::to_string(prepared->info->maxStackDepth));
+        }
+        return prepared;
+    }
+
+    /**
+     * @brief Executa o ciclo principal da VM (Fetch-Decode-Execute).
+     *
+     * O loop continua at que:
+     * 1. A instruo `HALT` seja encontrada.
+     * 2. Uma exceo `VMError` seja lanada (erro de execuo).
+     * 3. O IP ultrapasse o tamanho da memria.
+     *
+     * @throws VMError Se ocorrer um erro fatal durante a execuo.
+     */
+    void run() {
+        try {
+            // debug e perfil usam o lao switch, que observa cada instruo do bytecode
+            const bool observed = cfg_.debug || profiling();
+            if (cfg_.dispatch == Dispatch::Threaded && !observed) {
+                runThreaded();
+            }
+            else if (cfg_.dispatch == Dispatch::Jit && !observed && jitActive()) {
+                runJit();
+            }
+            else if (cfg_.dispatch == Dispatch::Register && !observed && !program_->registers.empty()) {
+                runRegister();
+            }
+            else if (usesDecoded(cfg_) && !observed) {
+                runFast();
+            }
+            else {
+                while (running_) {
+                    if (ip_ >= memory_.size()) {
+                        throw VMError("IP fora dos limites da memria: " + std::to_string(ip_));
+                    }
+
+                    const Byte raw = fetchByteNoAdvance(); // peek para validar antes de consumir
+                    if (!is_valid_opcode(raw)) throw invalidOpcodeError(ip_, raw);
+
+                    const Opcode op = static_cast<Opcode>(fetchByte()); // agora consome
+                    ++steps_;
+#if VM_PROFILE
+                    if (profiler_ && profiler_->begin(ip_ - 1, raw)) {
+                        execute(op);
+                        profiler_->end(raw);
+                    }
+                    else {
+                        execute(op);
+                    }
+#else
+                    execute(op);
+#endif
+
+                    if (cfg_.debug) debugDumpState(op);
+                }
+            }
+        }
+        catch (...) {
+            // relana a exceo para o chamador aps imprimir contexto (e o que o programa j imprimiu)
+            flushOutput();
+            std::cerr << "[VM] Exceo em execuo. estado final: ip=" << ip_
+                << " stack_size=" << stack_.size() << std::endl;
+            reportProfile();
+            throw;
+        }
+        flushOutput();
+        reportProfile();
+    }
+
+    /**
+     * @brief Indica se esta VM coleta perfil (`Config::profile` com `VM_PROFILE=1`).
+     */
+    [[nodiscard]] bool profiling() const noexcept {
+#if VM_PROFILE
+        return profiler_ != nullptr;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Entrega ao *sink* a sada ainda acumulada no buffer da VM.
+     *
+     * Chamado automaticamente ao final de `run()` (por `HALT` ou erro) e no destrutor.
+     */
+    void flushOutput() {
+        char* const begin = outputBuffer_.get();
+        if (outputPos_ == begin) return;
+        const auto n = static_cast<std::size_t>(outputPos_ - begin);
+        outputPos_ = begin;
+        output_.write(std::string_view(begin, n));
+    }
+
+    VirtualMachine(const VirtualMachine&) = delete;
+    VirtualMachine& operator=(const VirtualMachine&) = delete;
+
+    ~VirtualMachine() {
+        try {
+            flushOutput();
+        }
+        catch (...) {
+            // um destrutor no deve lanar; a sada pendente  perdida
+        }
+    }
+
+    /**
+     * @brief Nmero de instrues executadas desde a construo da VM.
+     * @return Contador de instrues despachadas (usado nos benchmarks). No modo `Fast` com
+     * `Config::fuse`, cada superinstruo conta como um nico despacho.
+     */
+    [[nodiscard]] std::uint64_t instructionsExecuted() const noexcept { return steps_; }
+
+    /**
+     * @brief Fatos provados pelo verificador, se ele foi executado na construo.
+     */
+    [[nodiscard]] const std::optional<ProgramInfo>& programInfo() const noexcept { return info_; }
+
+    /**
+     * @brief Indica se o programa est sendo executado como cdigo nativo.
+     * @return `true` no modo `Dispatch::Jit` em um host suportado; `false` quando a VM recaiu
+     * no interpretador. O cdigo nativo no conta instrues (`instructionsExecuted()` fica em 0).
+     */
+    [[nodiscard]] bool jitActive() const noexcept {
+#if VM_HAS_X64_JIT
+        return cfg_.dispatch == Dispatch::Jit && program_->jit != nullptr;
+#else
+        return false;
+#endif
+    }
+
+private:
+    std::shared_ptr<const PreparedProgram> program_; ///< Programa (imutvel, possivelmente compartilhado).
+    std::span<const Byte> memory_;    ///< Memria de programa (Bytecode), somente leitura.
+    const std::optional<ProgramInfo>& info_; ///< Resultado do verificador (quando executado).
+    const std::vector<DecodedInstr>& decoded_; ///< Programa pr-decodificado executado pelo modo `Fast`.
+    std::vector<Int> stack_;   ///< Pilha de operandos.
+    std::vector<Int> data_;    ///< Segmento de dados de `LOAD`/`STORE` (no modo `Jit`, fica no *frame*).
+    std::vector<Address> calls_; ///< Pilha de retorno de `CALL`/`RET` (modos `Switch` e `Threaded`).
+    Config cfg_;               ///< Configuraes da instncia.
+    Address ip_;               ///< Instruction Pointer (Apontador de Instruo).
+    bool running_;             ///< Flag de controle do loop principal.
+    std::uint64_t steps_ = 0;  ///< Instrues executadas.
+    std::unique_ptr<Int[]> fastStack_; ///< Pilha prpria do modo `Fast`, quando o chamador no fornece uma.
+    Int* fastBase_ = nullptr;          ///< Pilha de capacidade fixa do modo `Fast` (profundidade mxima verificada + 1).
+    std::vector<Int> jitFrame_;        ///< *Frame* da funo nativa: contexto, estado de sada e slots da pilha.
+    std::exception_ptr jitError_;      ///< Exceo do *sink* capturada por `jitPrint`, relanada por `runJit`.
+    OutputSink& output_;               ///< Destino de `PRINT`.
+    std::size_t outputCapacity_;       ///< Capacidade til do buffer de sada (0 = sem acmulo).
+    std::unique_ptr<char[]> outputBuffer_; ///< Texto formatado ainda no entregue ao *sink* (alocado no 1 `PRINT`).
+    char* outputPos_ = nullptr;        ///< Fim do texto acumulado em `outputBuffer_`.
+    char* outputEnd_ = nullptr;        ///< Fim de `outputBuffer_`.
+#if VM_PROFILE
+    std::unique_ptr<Profiler> profiler_; ///< Coletor de perfil (quando `cfg_.profile`).
+#endif
+
+    /// @brief Imprime o perfil coletado em `std::cerr` (nada se o perfil estiver desligado).
+    void reportProfile() const {
+#if VM_PROFILE
+        if (profiler_) profiler_->report(std::cerr, memory_, cfg_.endianness, cfg_.profileTop);
+#endif
+    }
+
+    /// @brief Maior linha produzida por `PRINT`: sinal, 19 dgitos e '\n'.
+    static constexpr std::size_t kMaxLine = 21;
+
+    /**
+     * @brief Implementao de `PRINT` em todos os modos: formata com `std::to_chars` no buffer
+     * da VM e s chama o *sink* quando o buffer enche.
+     */
+    void print(Int value) {
+        if (outputEnd_ - outputPos_ < static_cast<std::ptrdiff_t>(kMaxLine)) makeOutputRoom();
+        outputPos_ = std::to_chars(outputPos_, outputPos_ + kMaxLine, value).ptr;
+        *outputPos_++ = '\n';
+        if (outputCapacity_ == 0) flushOutput();
+    }
+
+    /**
+     * @brief Caminho lento de `print`: aloca o buffer (programas que no imprimem no pagam por
+     * ele, o que importa no `VMPool`) ou o esvazia no *sink*.
+     */
+    void makeOutputRoom() {
+        if (!outputBuffer_) {
+            const std::size_t size = std::max(outputCapacity_, kMaxLine);
+            outputBuffer_.reset(new char[size]); // sem inicializao
+            outputPos_ = outputBuffer_.get();
+            outputEnd_ = outputPos_ + size;
             return;
         }
+        flushOutput();
+    }
+
+    /**
+     * @brief Verifica, pr-decodifica e traduz o programa.
+     */
+    static void analyze(PreparedProgram& prepared, const Config& cfg) {
+        if (usesDecoded(cfg) || cfg.verify) {
+            prepared.info = verify_program(prepared.bytecode, cfg.endianness);
+        }
+        if (prepared.info && usesDecoded(cfg)) {
+            prepared.decoded = decode_program(prepared.bytecode, *prepared.info, cfg.endianness);
+            if (cfg.dispatch == Dispatch::Register) {
+                prepared.registers = translate_to_registers(prepared.decoded, *prepared.info);
+            }
+#if VM_HAS_X64_JIT
+            // o JIT traduz a decodificao sem superinstrues, antes da fuso
+            if (cfg.dispatch == Dispatch::Jit) prepared.jit = compileJit(prepared.decoded, *prepared.info);
+#endif
+            if (cfg.fuse) prepared.decoded = fuse_superinstructions(prepared.decoded);
+        }
+    }
+
+    /// @brief Indica se a configurao executa as instrues pr-decodificadas.
+    [[nodiscard]] static bool usesDecoded(const Config& cfg) noexcept {
+        return cfg.dispatch == Dispatch::Fast || cfg.dispatch == Dispatch::Jit || cfg.dispatch == Dispatch::Register;
+    }
+
+    // =================== Validao na carga ===================
+
+    /**
+     * @brief Percorre o programa linearmente, instruo por instruo, validando cada opcode
+     * e verificando se os operandos cabem na memria.
+     *
+     * Usado pelo modo threaded para trocar a busca em `kValidOpcodes` a cada passo por uma
+     * nica varredura na carga. Bytes alcanados apenas por saltos para o meio de uma instruo
+     * continuam protegidos: na tabela de despacho eles caem no handler de opcode invlido.
+     *
+     * @throws VMError Na primeira instruo invlida ou truncada encontrada.
+     */
+    void validateProgram() const {
+        Address pc = 0;
+        while (pc < memory_.size()) {
+            const Byte raw = memory_[pc];
+            if (!is_valid_opcode(raw)) throw invalidOpcodeError(pc, raw);
+            const std::size_t len = 1 + operand_size(static_cast<Opcode>(raw));
+            if (pc + len > memory_.size()) {
+                throw VMError("Instruo truncada em IP=" + std::to_string(pc));
+            }
+            pc += len;
+        }
+    }
+
+    /**
+     * @brief Monta a exceo padro de opcode invlido (mesma mensagem em todos os modos).
+     */
+    [[nodiscard]] static VMError invalidOpcodeError(Address at, Byte raw) {
+        std::ostringstream oss;
+        oss << "Opcode invlido lido em IP=" << at << " : 0x"
+            << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(raw);
+        return VMError(oss.str());
+    }
+
+    // =================== Helpers de fetch ===================
+
+    /**
+     * @brief L o byte atual apontado pelo IP sem avanar o ponteiro.
+     * @return O byte lido.
+     * @throws VMError Se o IP estiver fora dos limites.
+     * @note `[[nodiscard]]` incentiva o uso do valor retornado.
+     */
+    [[nodiscard]] Byte fetchByteNoAdvance() const {
+        if (ip_ >= memory_.size()) throw VMError("fetchByteNoAdvance: IP fora do intervalo");
+        return memory_[ip_];
+    }
+
+    /**
+     * @brief L o byte atual e avana o IP.
+     * @return O byte lido.
+     * @throws VMError Se o IP estiver fora dos limites.
+     */
+    [[nodiscard]] Byte fetchByte() {
+        if (ip_ >= memory_.size()) throw VMError("fetchByte: IP fora do intervalo");
+        return memory_[ip_++];
+    }
+
+    /**
+     * @brief L uma palavra de 16 bits (2 bytes) e avana o IP em 2 posies.
+     *
+     * Respeita a configurao de *Endianness* definida em `cfg_`.
+     *
+     * @return A palavra de 16 bits combinada.
+     * @throws VMError Se houver menos de 2 bytes disponveis.
+     */
+    [[nodiscard]] Word16 fetchWord() {
+        // Le 2 bytes de memory_ respeitando endianness da config
+        if (ip_ + 1 >= memory_.size()) throw VMError("fetchWord: leitura fora dos limites");
+        Byte b0 = memory_[ip_];
+        Byte b1 = memory_[ip_ + 1];
+        ip_ += 2;
+        return decode_word(b0, b1, cfg_.endianness);
+    }
+
+    /**
+     * @brief L um operando de `sizeof(T)` bytes e avana o IP.
+     * @throws VMError Se o operando no couber na memria.
+     */
+    template <std::integral T>
+    [[nodiscard]] T fetchOperand() {
+        if (memory_.size() - ip_ < sizeof(T)) throw VMError("fetchOperand: leitura fora dos limites");
+        const T value = decode_operand<T>(memory_.data() + ip_, cfg_.endianness);
+        ip_ += sizeof(T);
+        return value;
+    }
+
+    /**
+     * @brief Clula `k` do segmento de dados.
+     * @throws VMError Se `k` estiver alm das clulas do programa.
+     */
+    [[nodiscard]] Int& dataCell(Word16 k, std::string_view opName) {
+        if (k >= data_.size()) {
+            throw VMError(std::string(opName) + ": clula " + std::to_string(k)
+                + " fora do segmento de dados (" + std::to_string(data_.size()) + " clulas)");
+        }
+        return data_[k];
+    }
+
+    /// @brief Desvia para `addr`, conferindo se ele est dentro do programa.
+    void branchTo(Address addr, std::string_view opName) {
+        if (addr >= memory_.size()) throw VMError(std::string(opName) + ": endereo invlido: " + std::to_string(addr));
+        ip_ = addr;
+    }
+
+    // =================== Stack checks & ops ===================
+
+    /**
+     * @brief Garante que a pilha tenha um nmero mnimo de elementos.
+     * @param n Quantidade necessria de elementos.
+     * @param opName Nome da operao que solicitou a verificao (para log).
+     * @throws VMError Se a pilha no tiver elementos suficientes (Stack Underflow).
+     */
+    void ensureStackHas(std::size_t n, std::string_view opName) const {
+        if (stack_.size() < n) {
+            std::ostringstream oss;
+            oss << "Pilha insuficiente para " << opName
+                << " (necessrio: " << n << ", disponvel: " << stack_.size() << ")";
+            throw VMError(oss.str());
+        }
+    }
+
+    /**
+     * @brief Executa uma operao binria genrica.
+     *
+     * Desempilha dois valores ($b$, depois $a$), aplica a funo $f(a, b)$ e 
+     * empilha o resultado.
+     *
+     * @param func Lambda ou funo que aceita dois `Int` e retorna um `Int`.
+     * @param name Nome da operao (para mensagens de erro).
+     *
+     * @note O tipo da lambda  parmetro de template (e no `std::function`), ento cada chamada
+     *  instanciada com a operao concreta e o compilador a expande em linha, sem alocao nem
+     * chamada indireta.
+     */
+    template <typename F>
+    void binaryOp(F&& func, std::string_view name) {
+        ensureStackHas(2, name);
+        Int b = stack_.back(); stack_.pop_back();
+        Int a = stack_.back(); stack_.pop_back();
+        Int r = func(a, b);
+        stack_.push_back(r);
+    }
+
+    // =================== Semntica de cada opcode ===================
+    //
+    // Cada instruo  implementada uma nica vez aqui; `execute()` (modo switch) e
+    // `runThreaded()` chamam as mesmas funes, garantindo comportamento idntico.
+
+    void opHalt() { running_ = false; }
+
+    void opPush() {
+        Byte v = fetchByte();
+        stack_.push_back(static_cast<Int>(v));
+    }
+
+    void opPop() {
+        ensureStackHas(1, "POP");
+        stack_.pop_back();
+    }
+
+    void opAdd() { binaryOp([](Int a, Int b) { return wrap_add(a, b); }, "ADD"); }
+    void opSub() { binaryOp([](Int a, Int b) { return wrap_sub(a, b); }, "SUB"); }
+    void opMul() { binaryOp([](Int a, Int b) { return wrap_mul(a, b); }, "MUL"); }
+
+    void opDiv() {
+        binaryOp([](Int a, Int b) {
+            if (b == 0) throw VMError("Diviso por zero");
+            return wrap_div(a, b);
+            }, "DIV");
+    }
+
+    void opPrint() {
+        ensureStackHas(1, "PRINT");
+        print(stack_.back());
+        stack_.pop_back();
+    }
+
+    void opDup() {
+        ensureStackHas(1, "DUP");
+        stack_.push_back(stack_.back());
+    }
+
+    void opSwap() {
+        ensureStackHas(2, "SWAP");
+        std::swap(stack_[stack_.size() - 1], stack_[stack_.size() - 2]);
+    }
+
+    void opPush16() {
+        Word16 w = fetchWord();
+        stack_.push_back(static_cast<Int>(w));
+    }
+
+    void opJmp() {
+        Word16 addr = fetchWord();
+        if (addr >= memory_.size()) {
+            throw VMError("JMP: endereo invlido: " + std::to_string(addr));
+        }
+        ip_ = static_cast<Address>(addr);
+    }
+
+    void opJz() {
+        Word16 addr = fetchWord();
+        ensureStackHas(1, "JZ");
+        Int value = stack_.back(); stack_.pop_back();
+        if (value == 0) {
+            if (addr >= memory_.size()) throw VMError("JZ: endereo invlido: " + std::to_string(addr));
+            ip_ = static_cast<Address>(addr);
+        }
+    }
+
+    void opPush32() { stack_.push_back(static_cast<Int>(fetchOperand<std::int32_t>())); }
+    void opPush64() { stack_.push_back(fetchOperand<std::int64_t>()); }
+
+    void opLoad() {
+        const Int value = dataCell(fetchWord(), "LOAD");
+        stack_.push_back(value);
+    }
+
+    void opStore() {
+        Int& cell = dataCell(fetchWord(), "STORE");
+        ensureStackHas(1, "STORE");
+        cell = stack_.back();
+        stack_.pop_back();
+    }
+
+    void opJlt() {
+        const Address addr = fetchOperand<std::uint32_t>();
+        ensureStackHas(2, "JLT");
+        const Int b = stack_.back(); stack_.pop_back();
+        const Int a = stack_.back(); stack_.pop_back();
+        if (a < b) branchTo(addr, "JLT");
+    }
+
+    void opJnz() {
+        const Address addr = fetchOperand<std::uint32_t>();
+        ensureStackHas(1, "JNZ");
+        const Int value = stack_.back(); stack_.pop_back();
+        if (value != 0) branchTo(addr, "JNZ");
+    }
+
+    void opCall() {
+        const Address addr = fetchOperand<std::uint32_t>();
+        if (calls_.size() == kMaxCallDepth) {
+            throw VMError("Pilha de chamadas cheia: limite de " + std::to_string(kMaxCallDepth) + " CALLs aninhados");
+        }
+        calls_.push_back(ip_);
+        branchTo(addr, "CALL");
+    }
+
+    void opRet() {
+        if (calls_.empty()) throw VMError("RET sem CALL correspondente em IP=" + std::to_string(ip_ - 1));
+        ip_ = calls_.back();
+        calls_.pop_back();
+    }
+
+    void opJmp32() { branchTo(fetchOperand<std::uint32_t>(), "JMP32"); }
+
+    void opJz32() {
+        const Address addr = fetchOperand<std::uint32_t>();
+        ensureStackHas(1, "JZ32");
+        const Int value = stack_.back(); stack_.pop_back();
+        if (value == 0) branchTo(addr, "JZ32");
+    }
+
+    // =================== Execuo do opcode ===================
+
+    /**
+     * @brief Despacha e executa uma nica instruo baseada no Opcode.
+     * @param op O Opcode a ser executado.
+     */
+    void execute(Opcode op) {
+        switch (op) {
+        case Opcode::HALT:   opHalt();   return;
+        case Opcode::PUSH:   opPush();   return;
+        case Opcode::POP:    opPop();    return;
+        case Opcode::ADD:    opAdd();    return;
+        case Opcode::SUB:    opSub();    return;
+        case Opcode::MUL:    opMul();    return;
+        case Opcode::DIV:    opDiv();    return;
+        case Opcode::PRINT:  opPrint();  return;
+
+            // --- Extenses implementadas ---
+        case Opcode::DUP:    opDup();    return;
+        case Opcode::SWAP:   opSwap();   return;
+        case Opcode::PUSH16: opPush16(); return;
+        case Opcode::JMP:    opJmp();    return;
+        case Opcode::JZ:     opJz();     return;
+        case Opcode::PUSH32: opPush32(); return;
+        case Opcode::PUSH64: opPush64(); return;
+        case Opcode::LOAD:   opLoad();   return;
+        case Opcode::STORE:  opStore();  return;
+        case Opcode::JLT:    opJlt();    return;
+        case Opcode::JNZ:    opJnz();    return;
+        case Opcode::CALL:   opCall();   return;
+        case Opcode::RET:    opRet();    return;
+        case Opcode::JMP32:  opJmp32();  return;
+        case Opcode::JZ32:   opJz32();   return;
+
+        default:
+            throw VMError("Opcode desconhecido em execute()");
+        }
+    }
+
+    // =================== Despacho threaded ===================
+
+    /// @brief Assinatura dos handlers do modo *call threading*.
+    using Handler = void (*)(VirtualMachine&);
+
+    /// @brief Adapta uma funo-membro `opXxx` para a assinatura `Handler`.
+    template <void (VirtualMachine::*Op)()>
+    static void handler(VirtualMachine& vm) { (vm.*Op)(); }
+
+    /// @brief Handler das 243 entradas da tabela que no so opcodes vlidos.
+    static void invalidHandler(VirtualMachine& vm) {
+        --vm.steps_;
+        --vm.ip_;
+        throw invalidOpcodeError(vm.ip_, vm.memory_[vm.ip_]);
+    }
+
+    /**
+     * @brief Constri, em tempo de compilao, a tabela de handlers indexada pelo byte do opcode.
+     */
+    [[nodiscard]] static constexpr std::array<Handler, 256> makeHandlerTable() {
+        std::array<Handler, 256> t{};
+        for (auto& h : t) h = &invalidHandler;
+        t[static_cast<Byte>(Opcode::HALT)] = &handler<&VirtualMachine::opHalt>;
+        t[static_cast<Byte>(Opcode::PUSH)] = &handler<&VirtualMachine::opPush>;
+        t[static_cast<Byte>(Opcode::POP)] = &handler<&VirtualMachine::opPop>;
+        t[static_cast<Byte>(Opcode::ADD)] = &handler<&VirtualMachine::opAdd>;
+        t[static_cast<Byte>(Opcode::SUB)] = &handler<&VirtualMachine::opSub>;
+        t[static_cast<Byte>(Opcode::MUL)] = &handler<&VirtualMachine::opMul>;
+        t[static_cast<Byte>(Opcode::DIV)] = &handler<&VirtualMachine::opDiv>;
+        t[static_cast<Byte>(Opcode::PRINT)] = &handler<&VirtualMachine::opPrint>;
+        t[static_cast<Byte>(Opcode::DUP)] = &handler<&VirtualMachine::opDup>;
+        t[static_cast<Byte>(Opcode::SWAP)] = &handler<&VirtualMachine::opSwap>;
+        t[static_cast<Byte>(Opcode::PUSH16)] = &handler<&VirtualMachine::opPush16>;
+        t[static_cast<Byte>(Opcode::JMP)] = &handler<&VirtualMachine::opJmp>;
+        t[static_cast<Byte>(Opcode::JZ)] = &handler<&VirtualMachine::opJz>;
+        t[static_cast<Byte>(Opcode::PUSH32)] = &handler<&VirtualMachine::opPush32>;
+        t[static_cast<Byte>(Opcode::PUSH64)] = &handler<&VirtualMachine::opPush64>;
+        t[static_cast<Byte>(Opcode::LOAD)] = &handler<&VirtualMachine::opLoad>;
+        t[static_cast<Byte>(Opcode::STORE)] = &handler<&VirtualMachine::opStore>;
+        t[static_cast<Byte>(Opcode::JLT)] = &handler<&VirtualMachine::opJlt>;
+        t[static_cast<Byte>(Opcode::JNZ)] = &handler<&VirtualMachine::opJnz>;
+        t[static_cast<Byte>(Opcode::CALL)] = &handler<&VirtualMachine::opCall>;
+        t[static_cast<Byte>(Opcode::RET)] = &handler<&VirtualMachine::opRet>;
+        t[static_cast<Byte>(Opcode::JMP32)] = &handler<&VirtualMachine::opJmp32>;
+        t[static_cast<Byte>(Opcode::JZ32)] = &handler<&VirtualMachine::opJz32>;
+        return t;
+    }
+
+    /**
+     * @brief Lao de execuo *threaded*.
+     *
+     * O opcode lido  usado diretamente como ndice de uma tabela de 256 entradas; entradas que
+     * no correspondem a um opcode vlido levam a um handler que lana o mesmo `VMError` do modo
+     * switch. Assim a validao por instruo custa zero: ela j foi feita na carga
+     * (`validateProgram()`) e, para saltos ao meio de uma instruo, pela prpria tabela.
+     *
+     * - GCC/Clang: *direct threading* com goto computado; cada handler termina com seu prprio
+     *   salto indireto, o que d ao preditor de desvios um histrico por opcode.
+     * - Demais compiladores: *call threading*, uma chamada indireta por instruo atravs de uma
+     *   tabela de ponteiros para funes (o MSVC no garante eliminao de chamadas de cauda,
+     *   ento encadear handlers por tail call poderia estourar a pilha nativa em laos longos).
+     */
+    void runThreaded() {
+        const Byte* const code = memory_.data();
+        const Address size = memory_.size();
+
+#if VM_HAS_COMPUTED_GOTO
+        std::array<void*, 256> table;
+        table.fill(&&op_invalid);
+        table[static_cast<Byte>(Opcode::HALT)] = &&op_halt;
+        table[static_cast<Byte>(Opcode::PUSH)] = &&op_push;
+        table[static_cast<Byte>(Opcode::POP)] = &&op_pop;
+        table[static_cast<Byte>(Opcode::ADD)] = &&op_add;
+        table[static_cast<Byte>(Opcode::SUB)] = &&op_sub;
+        table[static_cast<Byte>(Opcode::MUL)] = &&op_mul;
+        table[static_cast<Byte>(Opcode::DIV)] = &&op_div;
+        table[static_cast<Byte>(Opcode::PRINT)] = &&op_print;
+        table[static_cast<Byte>(Opcode::DUP)] = &&op_dup;
+        table[static_cast<Byte>(Opcode::SWAP)] = &&op_swap;
+        table[static_cast<Byte>(Opcode::PUSH16)] = &&op_push16;
+        table[static_cast<Byte>(Opcode::JMP)] = &&op_jmp;
+        table[static_cast<Byte>(Opcode::JZ)] = &&op_jz;
+        table[static_cast<Byte>(Opcode::PUSH32)] = &&op_push32;
+        table[static_cast<Byte>(Opcode::PUSH64)] = &&op_push64;
+        table[static_cast<Byte>(Opcode::LOAD)] = &&op_load;
+        table[static_cast<Byte>(Opcode::STORE)] = &&op_store;
+        table[static_cast<Byte>(Opcode::JLT)] = &&op_jlt;
+        table[static_cast<Byte>(Opcode::JNZ)] = &&op_jnz;
+        table[static_cast<Byte>(Opcode::CALL)] = &&op_call;
+        table[static_cast<Byte>(Opcode::RET)] = &&op_ret;
+        table[static_cast<Byte>(Opcode::JMP32)] = &&op_jmp32;
+        table[static_cast<Byte>(Opcode::JZ32)] = &&op_jz32;
+
+#define VM_DISPATCH()                                                                      \
+        do {                                                                               \
+            if (ip_ >= size) throw VMError("IP fora dos limites da memria: " + std::to_string(ip_)); \
+            ++steps_;                                                                      \
+            goto *table[code[ip_++]];                                                      \
+        } while (0)
+
+        VM_DISPATCH();
+
+    op_halt:   opHalt();   return;
+    op_push:   opPush();   VM_DISPATCH();
+    op_pop:    opPop();    VM_DISPATCH();
+    op_add:    opAdd();    VM_DISPATCH();
+    op_sub:    opSub();    VM_DISPATCH();
+    op_mul:    opMul();    VM_DISPATCH();
+    op_div:    opDiv();    VM_DISPATCH();
+    op_print:  opPrint();  VM_DISPATCH();
+    op_dup:    opDup();    VM_DISPATCH();
+    op_swap:   opSwap();   VM_DISPATCH();
+    op_push16: opPush16(); VM_DISPATCH();
+    op_jmp:    opJmp();    VM_DISPATCH();
+    op_jz:     opJz();     VM_DISPATCH();
+    op_push32: opPush32(); VM_DISPATCH();
+    op_push64: opPush64(); VM_DISPATCH();
+    op_load:   opLoad();   VM_DISPATCH();
+    op_store:  opStore();  VM_DISPATCH();
+    op_jlt:    opJlt();    VM_DISPATCH();
+    op_jnz:    opJnz();    VM_DISPATCH();
+    op_call:   opCall();   VM_DISPATCH();
+    op_ret:    opRet();    VM_DISPATCH();
+    op_jmp32:  opJmp32();  VM_DISPATCH();
+    op_jz32:   opJz32();   VM_DISPATCH();
+    op_invalid:
+        --steps_;
+        --ip_;
+        throw invalidOpcodeError(ip_, code[ip_]);
+
+#undef VM_DISPATCH
+#else
+        static constexpr std::array<Handler, 256> kHandlers = makeHandlerTable();
+        while (running_) {
+            if (ip_ >= size) throw VMError("IP fora dos limites da memria: " + std::to_string(ip_));
+            const Byte raw = code[ip_++];
+            ++steps_;
+            kHandlers[raw](*this);
+        }
+#endif
+    }
+
+    // =================== Ncleo Fast ===================
+
+    /**
+     * @brief Ncleo de execuo do modo `Dispatch::Fast`.
+     *
+     * Executa o array `decoded_` produzido por `decode_program` a partir de um programa aprovado
+     * por `verify_program`, o que permite:
+     * - nenhum teste de limites do IP, dos operandos, dos alvos de salto ou da pilha;
+     * - operandos e destinos de salto prontos em `DecodedInstr::arg`: nada de remontar palavras
+     *   de 16 bits nem consultar a *endianness* durante a execuo;
+     * - pilha em um array de capacidade fixa (`fastBase_`), dimensionado pela profundidade
+     *   mxima provada pelo verificador: sem `push_back`/`pop_back` nem realocaes;
+     * - topo da pilha (`tos`) em uma varivel local, que o compilador mantm em registrador.
+     *   Uma operao binria l apenas um operando da memria (`ADD` vira `tos = *--sp + tos`);
+     * - aritmtica escrita diretamente em cada handler, sem `binaryOp` nem lambdas;
+     * - `CALL` guarda o ponteiro da instruo de retorno em um array local; `RET` no confere
+     *   nada alm do que o verificador provou (toda funo  alcanada s por `CALL`).
+     *
+     * Layout: os elementos abaixo do topo ficam em `base[1] .. sp[-1]` e a profundidade 
+     * `sp - base`. Empilhar com a pilha vazia grava o `tos` (sem significado) em `base[0]`, o
+     * slot descartvel, o que evita um teste de pilha vazia no caminho quente.
+     *
+     * Ao terminar (por `HALT` ou exceo) o estado local  copiado de volta para `ip_`, `steps_`
+     * e `stack_`, de modo que as mensagens de erro e a inspeo da VM continuam corretas. Em caso
+     * de exceo, `ip_` aponta para a instruo que falhou.
+     */
+    void runFast() {
+        const DecodedInstr* const code = decoded_.data();
+        Int* const base = fastBase_;
+        Int* sp = base;
+        Int tos = 0;
+        const DecodedInstr* ip = code;
+        std::uint64_t steps = 0;
+        Int* const data = data_.data();
+        std::vector<const DecodedInstr*> calls(info_->hasCalls ? kMaxCallDepth : 0);
+        const DecodedInstr** callTop = calls.data();
+        const DecodedInstr** const callEnd = calls.data() + calls.size();
+
+        auto sync = [&](Address at) {
+            ip_ = at;
+            steps_ += steps;
+            stack_.clear();
+            if (sp > base) {
+                stack_.assign(base + 1, sp);
+                stack_.push_back(tos);
+            }
+        };
+
+        try {
+#if VM_HAS_COMPUTED_GOTO
+            // Mesma ordem de `MicroOp`.
+            void* const table[] = {
+                &&f_halt, &&f_push, &&f_pop, &&f_add, &&f_sub, &&f_mul,
+                &&f_div, &&f_print, &&f_dup, &&f_swap, &&f_jmp, &&f_jz,
+                &&f_jnz, &&f_jlt, &&f_load, &&f_store, &&f_call, &&f_ret,
+                &&f_addi, &&f_subi, &&f_muli, &&f_divi, &&f_dupjz, &&f_dupprint
+            };
+#define VM_OP(lower, upper) f_##lower
+#define VM_NEXT() do { ++steps; goto *table[static_cast<Byte>((ip++)->op)]; } while (0)
+            VM_NEXT();
+#else
+#define VM_OP(lower, upper) case MicroOp::upper
+#define VM_NEXT() break
+            for (;;) {
+                ++steps;
+                switch ((ip++)->op) {
+#endif
+            // Ao entrar em um handler, `ip` j aponta para a instruo seguinte; `ip[-1]`  a corrente.
+            VM_OP(halt, HALT):
+                sync(ip[-1].pc + 1);
+                running_ = false;
+                return;
+            VM_OP(push, PUSH):
+                *sp++ = tos;
+                tos = ip[-1].arg;
+                VM_NEXT();
+            VM_OP(pop, POP):
+                tos = *--sp;
+                VM_NEXT();
+            VM_OP(add, ADD):
+                tos = wrap_add(*--sp, tos);
+                VM_NEXT();
+            VM_OP(sub, SUB):
+                tos = wrap_sub(*--sp, tos);
+                VM_NEXT();
+            VM_OP(mul, MUL):
+                tos = wrap_mul(*--sp, tos);
+                VM_NEXT();
+            VM_OP(div, DIV):
+                if (tos == 0) {
+                    // como nos modos Switch/Threaded, o erro sai com os dois operandos j desempilhados
+                    --sp;
+                    tos = *--sp;
+                    throw VMError("Diviso por zero");
+                }
+                tos = wrap_div(*--sp, tos);
+                VM_NEXT();
+            VM_OP(print, PRINT):
+                print(tos);
+                tos = *--sp;
+                VM_NEXT();
+            VM_OP(dup, DUP):
+                *sp++ = tos;
+                VM_NEXT();
+            VM_OP(swap, SWAP):
+                std::swap(tos, sp[-1]);
+                VM_NEXT();
+            VM_OP(jmp, JMP):
+                ip = code + ip[-1].arg;
+                VM_NEXT();
+            VM_OP(jz, JZ): {
+                const Int value = tos;
+                tos = *--sp;
+                if (value == 0) ip = code + ip[-1].arg;
+                VM_NEXT();
+            }
+            VM_OP(jnz, JNZ): {
+                const Int value = tos;
+                tos = *--sp;
+                if (value != 0) ip = code + ip[-1].arg;
+                VM_NEXT();
+            }
+            VM_OP(jlt, JLT): {
+                const Int b = tos;
+                const Int a = *--sp;
+                tos = *--sp;
+                if (a < b) ip = code + ip[-1].arg;
+                VM_NEXT();
+            }
+            VM_OP(load, LOAD):
+                *sp++ = tos;
+                tos = data[ip[-1].arg];
+                VM_NEXT();
+            VM_OP(store, STORE):
+                data[ip[-1].arg] = tos;
+                tos = *--sp;
+                VM_NEXT();
+            VM_OP(call, CALL):
+                if (callTop == callEnd) {
+                    throw VMError("Pilha de chamadas cheia: limite de " + std::to_string(kMaxCallDepth) + " CALLs aninhados");
+                }
+                *callTop++ = ip;
+                ip = code + ip[-1].arg;
+                VM_NEXT();
+            VM_OP(ret, RET):
+                ip = *--callTop;
+                VM_NEXT();
+
+            // --- Superinstrues ---
+            VM_OP(addi, ADDI):
+                tos = wrap_add(tos, ip[-1].arg);
+                VM_NEXT();
+            VM_OP(subi, SUBI):
+                tos = wrap_sub(tos, ip[-1].arg);
+                VM_NEXT();
+            VM_OP(muli, MULI):
+                tos = wrap_mul(tos, ip[-1].arg);
+                VM_NEXT();
+            VM_OP(divi, DIVI):
+                tos = wrap_div(tos, ip[-1].arg);
+                VM_NEXT();
+            VM_OP(dupjz, DUPJZ):
+                if (tos == 0) ip = code + ip[-1].arg;
+                VM_NEXT();
+            VM_OP(dupprint, DUPPRINT):
+                print(tos);
+                VM_NEXT();
+#if !VM_HAS_COMPUTED_GOTO
+                }
+            }
+#endif
+#undef VM_OP
+#undef VM_NEXT
+        }
+        catch (...) {
+            sync(ip[-1].pc);
+            throw;
+        }
+    }
+
+    // =================== Ncleo de registradores ===================
+
+    /**
+     * @brief Ncleo de execuo do modo `Dispatch::Register`.
+     *
+     * Executa o programa de `translate_to_registers` sobre o banco de registradores (a mesma
+     * rea de `fastBase_`, com um registrador por slot da pilha). Cada instruo l e escreve
+     * registradores diretamente, sem mover um ponteiro de pilha. Nos limites de instruo
+     * `r[0 .. profundidade)`  a pilha do programa original, de onde `stack_`  reconstruda
+     * ao terminar (por `HALT` ou exceo). `CALL`/`RET` usam um array local de retornos, como
+     * no ncleo `Fast`.
+     */
+    void runRegister() {
+        const RegInstr* const code = program_->registers.data();
+        Int* const r = fastBase_;
+        const RegInstr* ip = code;
+        std::uint64_t steps = 0;
+        Int* const data = data_.data();
+        std::vector<const RegInstr*> calls(info_->hasCalls ? kMaxCallDepth : 0);
+        const RegInstr** callTop = calls.data();
+        const RegInstr** const callEnd = calls.data() + calls.size();
+
+        int desempilhados = 0; // operandos consumidos pela instruo que falhou (DIV por zero)
+        auto sync = [&](Address at) {
+            ip_ = at;
+            steps_ += steps;
+            const int depth = info_->depthAt[ip[-1].pc] - desempilhados;
+            stack_.assign(r, r + depth);
+        };
+
+        try {
+#if VM_HAS_COMPUTED_GOTO
+            // Mesma ordem de `RegOp` (NOP nunca  executado).
+            void* const table[] = {
+                &&r_halt, &&r_loadi, &&r_mov, &&r_swap, &&r_add, &&r_sub, &&r_mul, &&r_div,
+                &&r_addi, &&r_subi, &&r_muli, &&r_divi, &&r_print, &&r_jmp, &&r_jz, &&r_jnz,
+                &&r_jlt, &&r_load, &&r_store, &&r_call, &&r_ret, &&r_halt
+            };
+#define VM_OP(lower, upper) r_##lower
+#define VM_NEXT() do { ++steps; goto *table[static_cast<Byte>((ip++)->op)]; } while (0)
+            VM_NEXT();
+#else
+#define VM_OP(lower, upper) case RegOp::upper
+#define VM_NEXT() break
+            for (;;) {
+                ++steps;
+                switch ((ip++)->op) {
+                case RegOp::NOP:
+#endif
+            // Ao entrar em um handler, `ip[-1]`  a instruo corrente.
+            VM_OP(halt, HALT):
+                sync(ip[-1].pc + 1);
+                running_ = false;
+                return;
+            VM_OP(loadi, LOADI):
+                r[ip[-1].a] = ip[-1].imm;
+                VM_NEXT();
+            VM_OP(mov, MOV):
+                r[ip[-1].a] = r[ip[-1].b];
+                VM_NEXT();
+            VM_OP(swap, SWAP):
+                std::swap(r[ip[-1].a], r[ip[-1].b]);
+                VM_NEXT();
+            VM_OP(add, ADD):
+                r[ip[-1].a] = wrap_add(r[ip[-1].b], r[ip[-1].c]);
+                VM_NEXT();
+            VM_OP(sub, SUB):
+                r[ip[-1].a] = wrap_sub(r[ip[-1].b], r[ip[-1].c]);
+                VM_NEXT();
+            VM_OP(mul, MUL):
+                r[ip[-1].a] = wrap_mul(r[ip[-1].b], r[ip[-1].c]);
+                VM_NEXT();
+            VM_OP(div, DIV):
+                if (r[ip[-1].c] == 0) {
+                    desempilhados = 2;
+                    throw VMError("Diviso por zero");
+                }
+                r[ip[-1].a] = wrap_div(r[ip[-1].b], r[ip[-1].c]);
+                VM_NEXT();
+            VM_OP(addi, ADDI):
+                r[ip[-1].a] = wrap_add(r[ip[-1].b], ip[-1].imm);
+                VM_NEXT();
+            VM_OP(subi, SUBI):
+                r[ip[-1].a] = wrap_sub(r[ip[-1].b], ip[-1].imm);
+                VM_NEXT();
+            VM_OP(muli, MULI):
+                r[ip[-1].a] = wrap_mul(r[ip[-1].b], ip[-1].imm);
+                VM_NEXT();
+            VM_OP(divi, DIVI):
+                r[ip[-1].a] = wrap_div(r[ip[-1].b], ip[-1].imm);
+                VM_NEXT();
+            VM_OP(print, PRINT):
+                print(r[ip[-1].a]);
+                VM_NEXT();
+            VM_OP(jmp, JMP):
+                ip = code + ip[-1].imm;
+                VM_NEXT();
+            VM_OP(jz, JZ):
+                if (r[ip[-1].a] == 0) ip = code + ip[-1].imm;
+                VM_NEXT();
+            VM_OP(jnz, JNZ):
+                if (r[ip[-1].a] != 0) ip = code + ip[-1].imm;
+                VM_NEXT();
+            VM_OP(jlt, JLT):
+                if (r[ip[-1].a] < r[ip[-1].b]) ip = code + ip[-1].imm;
+                VM_NEXT();
+            VM_OP(load, LOAD):
+                r[ip[-1].a] = data[ip[-1].imm];
+                VM_NEXT();
+            VM_OP(store, STORE):
+                data[ip[-1].imm] = r[ip[-1].a];
+                VM_NEXT();
+            VM_OP(call, CALL):
+                if (callTop == callEnd) {
+                    throw VMError("Pilha de chamadas cheia: limite de " + std::to_string(kMaxCallDepth) + " CALLs aninhados");
+                }
+                *callTop++ = ip;
+                ip = code + ip[-1].imm;
+                VM_NEXT();
+            VM_OP(ret, RET):
+                ip = *--callTop;
+                VM_NEXT();
+#if !VM_HAS_COMPUTED_GOTO
+                }
+            }
+#endif
+#undef VM_OP
+#undef VM_NEXT
+        }
+        catch (...) {
+            sync(ip[-1].pc);
+            throw;
+        }
+    }
+
+    // =================== Ncleo JIT ===================
+
+    /**
+     * @brief Helper chamado pelo cdigo nativo em `PRINT`.
+     *
+     * No pode lanar: uma exceo no tem como atravessar os quadros gerados pelo JIT. Se o
+     * *sink* lanar, a exceo fica em `jitError_` e o cdigo nativo sai por `Exit::PrintFailed`;
+     * `runJit` a relana, como nos demais modos.
+     *
+     * @param context A VM em execuo (gravada no *frame* por `runJit`).
+     * @return 0 em caso de sucesso; 1 se a impresso lanou uma exceo.
+     */
+    static std::int64_t jitPrint(void* context, Int value) noexcept {
+        auto* vm = static_cast<VirtualMachine*>(context);
+        try {
+            vm->print(value);
+            return 0;
+        }
+        catch (...) {
+            vm->jitError_ = std::current_exception();
+            return 1;
+        }
+    }
 
-        default:
-            throw VMError("Opcode desconhecido em execute()");
+#if VM_HAS_X64_JIT
+    /**
+     * @brief Traduz o programa para cdigo nativo (a partir de uma decodificao sem superinstrues).
+     *
+     * O cdigo no guarda nada de uma VM (o contexto de `PRINT` vem do *frame*), ento 
+     * compartilhado por todas as VMs do programa. Falhas do sistema (mapeamento executvel
+     * recusado) no so erros: o resultado  nulo e a VM usa o ncleo `Fast`.
+     */
+    [[nodiscard]] static std::shared_ptr<const jit::Code> compileJit(const std::vector<DecodedInstr>& code, const ProgramInfo& info) {
+        auto native = std::make_shared<jit::Code>();
+        if (!native->load(jit::compile(code, info, &VirtualMachine::jitPrint))) return nullptr;
+        return native;
+    }
+#endif
+
+    /**
+     * @brief Executa o cdigo nativo e reconstri `stack_` e `ip_` a partir do *frame*.
+     *
+     * Como no ncleo `Fast`, em caso de erro `ip_` aponta para a instruo que falhou.
+     */
+    void runJit() {
+#if VM_HAS_X64_JIT
+        Int* const frame = jitFrame_.data();
+        frame[jit::kFrameContext] = static_cast<Int>(reinterpret_cast<std::intptr_t>(this));
+        const auto exit = static_cast<jit::Exit>(program_->jit->entry()(frame));
+
+        const auto depth = static_cast<std::size_t>(frame[jit::kFrameDepth]);
+        stack_.assign(frame + jit::kFrameSlots, frame + jit::kFrameSlots + depth);
+        ip_ = static_cast<Address>(frame[jit::kFramePc]);
+        if (exit == jit::Exit::PrintFailed) std::rethrow_exception(std::exchange(jitError_, nullptr));
+        if (exit == jit::Exit::DivideByZero) throw VMError("Diviso por zero");
+        if (exit == jit::Exit::CallStackOverflow) {
+            throw VMError("Pilha de chamadas cheia: limite de " + std::to_string(kMaxCallDepth) + " CALLs aninhados");
         }
+        ip_ += 1; // aps o HALT, como nos demais modos
+        running_ = false;
+#endif
     }
 
     // =================== Debug / inspeo ===================
@@ -415,123 +2525,929 @@ private:
     }
 };
 
-// =========================== Helpers para montagem de bytecode ===========================
+// =========================== Execuo em lote ===========================
 
 /**
- * @namespace assembler
- * @brief Funes auxiliares para facilitar a construo manual de programas (bytecode).
+ * @class StackArena
+ * @brief Alocador por regio (*arena*) para as pilhas das VMs de uma thread.
  *
- * Fornece uma abstrao simples sobre o `std::vector<Byte>` para evitar inseres manuais propensas a erro.
+ * Cada *worker* do `VMPool` tem a sua arena: alocar  avanar um ndice e `reset()` libera tudo
+ * de uma vez, sem chamadas ao alocador global (e sem disputa entre threads) a cada programa.
+ * Os blocos so mantidos entre os `reset()`, ento depois do aquecimento no h alocaes.
  */
-namespace assembler {
+class StackArena {
+public:
     /**
-     * @brief Insere um opcode no vetor de bytecode.
+     * @param blockSize Tamanho mnimo, em inteiros, de cada bloco.
      */
-    inline void emit(std::vector<Byte>& out, Opcode op) {
-        out.push_back(static_cast<Byte>(op));
-    }
+    explicit StackArena(std::size_t blockSize = 1 << 14) : blockSize_{ blockSize } {}
 
     /**
-     * @brief Emite a instruo `PUSH` seguida de um valor de 8 bits.
+     * @brief Reserva `n` inteiros contguos, vlidos at o prximo `reset()`.
      */
-    inline void emit_push(std::vector<Byte>& out, Byte value) {
-        emit(out, Opcode::PUSH);
-        out.push_back(value);
+    [[nodiscard]] Int* allocate(std::size_t n) {
+        while (current_ < blocks_.size() && used_ + n > blocks_[current_].size) {
+            ++current_;
+            used_ = 0;
+        }
+        if (current_ == blocks_.size()) {
+            const std::size_t size = std::max(n, blockSize_);
+            blocks_.push_back(Block{ std::make_unique<Int[]>(size), size });
+        }
+        Int* const p = blocks_[current_].data.get() + used_;
+        used_ += n;
+        return p;
     }
 
-    /**
-     * @brief Emite a instruo `PUSH16` seguida de um valor de 16 bits (Big-Endian).
-     */
-    inline void emit_push16_be(std::vector<Byte>& out, Word16 value) {
-        emit(out, Opcode::PUSH16);
-        out.push_back(static_cast<Byte>((value >> 8) & 0xFF));
-        out.push_back(static_cast<Byte>(value & 0xFF));
+    /// @brief Descarta todas as reservas (os blocos continuam alocados).
+    void reset() noexcept {
+        current_ = 0;
+        used_ = 0;
     }
 
+private:
+    struct Block {
+        std::unique_ptr<Int[]> data;
+        std::size_t size;
+    };
+
+    std::vector<Block> blocks_;
+    std::size_t blockSize_;
+    std::size_t current_ = 0; ///< Bloco em uso.
+    std::size_t used_ = 0;    ///< Inteiros j reservados no bloco em uso.
+};
+
+/**
+ * @class VMPool
+ * @brief Executa lotes de programas independentes em um conjunto fixo de threads.
+ *
+ * Os programas so preparados uma vez (`VirtualMachine::prepare`) e compartilhados, somente
+ * leitura, por todas as threads; cada execuo cria apenas o estado mutvel da VM, com a
+ * pilha retirada da `StackArena` da thread. As threads so criadas no construtor e retiram
+ * trabalho de um ndice atmico em pequenos lotes, o que equilibra a carga quando os
+ * programas tm duraes diferentes.
+ *
+ * @note Cada VM entrega a sua sada ao *sink* em blocos de linhas completas; com o *sink*
+ * padro (`std::cout`), blocos de programas diferentes podem se intercalar. Um *sink* prprio
+ * (`Config::output`) compartilhado entre as threads precisa ser *thread-safe*.
+ */
+class VMPool {
+public:
+    /// @brief Resultado de uma execuo.
+    struct Result {
+        bool ok = false;                   ///< `true` se o programa terminou com `HALT`.
+        std::string error;                 ///< Mensagem da exceo (`VMError`, do *sink*, de memria...), se houve erro.
+        std::chrono::nanoseconds latency{}; ///< Tempo de construo + execuo da VM.
+    };
+
     /**
-     * @brief Emite a instruo `JMP` (salto incondicional) com endereo Big-Endian.
+     * @param workers Nmero de threads (pelo menos 1).
+     * @param cfg Configurao das VMs; os programas devem ter sido preparados com ela.
      */
-    inline void emit_jmp_be(std::vector<Byte>& out, Word16 addr) {
-        emit(out, Opcode::JMP);
-        out.push_back(static_cast<Byte>((addr >> 8) & 0xFF));
-        out.push_back(static_cast<Byte>(addr & 0xFF));
+    VMPool(std::size_t workers, VirtualMachine::Config cfg) : cfg_{ cfg } {
+        workers = std::max<std::size_t>(workers, 1);
+        threads_.reserve(workers);
+        for (std::size_t i = 0; i < workers; ++i) threads_.emplace_back([this] { workerLoop(); });
     }
 
+    VMPool(const VMPool&) = delete;
+    VMPool& operator=(const VMPool&) = delete;
+
+    ~VMPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    [[nodiscard]] std::size_t workers() const noexcept { return threads_.size(); }
+
     /**
-     * @brief Emite a instruo `JZ` (salto se zero) com endereo Big-Endian.
+     * @brief Executa todos os programas do lote e espera o trmino.
+     *
+     * @param programs Programas a executar (o mesmo programa pode aparecer vrias vezes).
+     * @return Um resultado por programa, na mesma ordem.
      */
-    inline void emit_jz_be(std::vector<Byte>& out, Word16 addr) {
-        emit(out, Opcode::JZ);
-        out.push_back(static_cast<Byte>((addr >> 8) & 0xFF));
-        out.push_back(static_cast<Byte>(addr & 0xFF));
+    std::vector<Result> run(const std::vector<std::shared_ptr<const PreparedProgram>>& programs) {
+        std::vector<Result> results(programs.size());
+        std::unique_lock<std::mutex> lock(mutex_);
+        batch_ = &programs;
+        results_ = &results;
+        next_.store(0, std::memory_order_relaxed);
+        pending_ = threads_.size();
+        ++generation_;
+        start_.notify_all();
+        done_.wait(lock, [this] { return pending_ == 0; });
+        batch_ = nullptr;
+        results_ = nullptr;
+        return results;
+    }
+
+private:
+    static constexpr std::size_t kLote = 16; ///< Programas retirados do ndice por vez.
+
+    void workerLoop() {
+        StackArena arena;
+        std::size_t seen = 0;
+        for (;;) {
+            const std::vector<std::shared_ptr<const PreparedProgram>>* batch = nullptr;
+            std::vector<Result>* results = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+                batch = batch_;
+                results = results_;
+            }
+
+            const std::size_t n = batch->size();
+            for (;;) {
+                const std::size_t begin = next_.fetch_add(kLote, std::memory_order_relaxed);
+                if (begin >= n) break;
+                const std::size_t end = std::min(begin + kLote, n);
+                for (std::size_t i = begin; i < end; ++i) (*results)[i] = runOne((*batch)[i], arena);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pending_ == 0) done_.notify_one();
+        }
+    }
+
+    Result runOne(const std::shared_ptr<const PreparedProgram>& program, StackArena& arena) const {
+        Result result;
+        arena.reset();
+        const auto t0 = std::chrono::steady_clock::now();
+        try {
+            Int* const stack = program->info ? arena.allocate(program->info->maxStackDepth + 1) : nullptr;
+            VirtualMachine vm(program, cfg_, stack);
+            vm.run();
+            result.ok = true;
+        }
+        catch (const std::exception& e) {
+            // qualquer exceo fica no resultado: se escapasse, a thread chamaria std::terminate
+            result.error = e.what();
+        }
+        catch (...) {
+            result.error = "exceo desconhecida";
+        }
+        result.latency = std::chrono::steady_clock::now() - t0;
+        return result;
+    }
+
+    VirtualMachine::Config cfg_;
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_; ///< Sinaliza um novo lote (ou o encerramento).
+    std::condition_variable done_;  ///< Sinaliza que todas as threads terminaram o lote.
+    const std::vector<std::shared_ptr<const PreparedProgram>>* batch_ = nullptr;
+    std::vector<Result>* results_ = nullptr;
+    std::atomic<std::size_t> next_{ 0 }; ///< Prximo programa ainda no retirado.
+    std::size_t pending_ = 0;            ///< Threads que ainda no terminaram o lote.
+    std::size_t generation_ = 0;         ///< Nmero do lote corrente.
+    bool stop_ = false;
+};
+
+// =========================== Benchmark ===========================
+
+/**
+ * @brief Nome legvel de uma estratgia de despacho.
+ */
+[[nodiscard]] static std::string_view dispatch_name(Dispatch d) {
+    switch (d) {
+    case Dispatch::Switch:   return "switch";
+    case Dispatch::Threaded: return "threaded";
+    case Dispatch::Fast:     return "fast";
+    case Dispatch::Jit:      return "jit";
+    case Dispatch::Register: return "register";
+    }
+    return "?";
+}
+
+/**
+ * @brief Estratgia de despacho pelo nome (inverso de `dispatch_name`).
+ */
+[[nodiscard]] static std::optional<Dispatch> parse_dispatch(std::string_view nome) {
+    for (Dispatch d : { Dispatch::Switch, Dispatch::Threaded, Dispatch::Fast, Dispatch::Jit, Dispatch::Register }) {
+        if (dispatch_name(d) == nome) return d;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Mede instrues por segundo e ns/instruo de cada estratgia de despacho em um programa.
+ *
+ * Cada modo  executado algumas vezes e reportamos a melhor medida, o que reduz o rudo
+ * causado por outros processos na mquina. Ao final, compara o custo de carga do modo `Fast`
+ * (verificao + pr-decodificao) com o tempo que ele economiza por execuo em relao ao
+ * modo `Threaded`, que executa o bytecode bruto.
+ *
+ * @param nome Nome do programa (para o relatrio).
+ * @param program Bytecode a executar.
+ */
+static void bench_program(std::string_view nome, const std::vector<Byte>& program) {
+    constexpr int kRepeticoes = 3;
+
+    std::cout << "--- Benchmark: " << nome << " (" << program.size() << " bytes) ---\n";
+    NullSink nulo; // o resultado impresso pelos programas de memria e de CALL
+    double baseline = 0.0;
+    std::uint64_t instrucoes = 0;
+    double tempoThreaded = 0.0;
+    double tempoFast = 0.0;
+    for (Dispatch d : { Dispatch::Switch, Dispatch::Threaded, Dispatch::Fast, Dispatch::Jit }) {
+        double melhor = 0.0;
+        double menorTempo = 0.0;
+        bool nativo = false;
+        for (int r = 0; r < kRepeticoes; ++r) {
+            VirtualMachine::Config cfg;
+            cfg.dispatch = d;
+            cfg.fuse = false; // mesma contagem de instrues em todos os modos (ver bench_fusion)
+            cfg.output = &nulo;
+            VirtualMachine vm(program, cfg);
+
+            const auto t0 = std::chrono::steady_clock::now();
+            vm.run();
+            const auto t1 = std::chrono::steady_clock::now();
+
+            const double segundos = std::chrono::duration<double>(t1 - t0).count();
+            // O JIT no conta instrues: todos os modos usam a contagem do switch.
+            if (d == Dispatch::Switch) instrucoes = vm.instructionsExecuted();
+            nativo = vm.jitActive();
+            melhor = std::max(melhor, static_cast<double>(instrucoes) / segundos);
+            menorTempo = (r == 0) ? segundos : std::min(menorTempo, segundos);
+        }
+        if (d == Dispatch::Switch) baseline = melhor;
+        if (d == Dispatch::Threaded) tempoThreaded = menorTempo;
+        if (d == Dispatch::Fast) tempoFast = menorTempo;
+        std::cout << std::left << std::setw(10) << dispatch_name(d) << std::right
+            << " instrucoes=" << instrucoes
+            << "  " << std::fixed << std::setprecision(1) << melhor / 1e6 << " M instr/s"
+            << "  " << std::setprecision(2) << 1e9 / melhor << " ns/instr"
+            << "  (" << melhor / baseline << "x)"
+            << (d == Dispatch::Jit && !nativo ? "  [sem suporte: interpretador fast]" : "") << "\n";
+    }
+
+    // Custo de carga do modo Fast, medido isoladamente e amortizado em muitas repeties.
+    constexpr int kCargas = 2000;
+    std::size_t descarte = 0;
+    const auto c0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kCargas; ++i) descarte += verify_program(program, Endianness::Big).blocks.size();
+    const auto c1 = std::chrono::steady_clock::now();
+    const ProgramInfo info = verify_program(program, Endianness::Big);
+    for (int i = 0; i < kCargas; ++i) descarte += decode_program(program, info, Endianness::Big).size();
+    const auto c2 = std::chrono::steady_clock::now();
+
+    const double verificacao = std::chrono::duration<double>(c1 - c0).count() / kCargas;
+    const double decodificacao = std::chrono::duration<double>(c2 - c1).count() / kCargas;
+    const double ganho = tempoThreaded - tempoFast;
+    std::cout << "carga fast: verificacao " << std::setprecision(2) << verificacao * 1e6 << " us"
+        << " + pre-decodificacao " << decodificacao * 1e6 << " us"
+        << "; ganho sobre threaded " << ganho * 1e3 << " ms por execucao";
+    if (ganho > 0.0 && descarte > 0) {
+        const double ganhoPorInstrucao = ganho / static_cast<double>(instrucoes);
+        std::cout << " (a carga se paga apos ~" << std::setprecision(0)
+            << (verificacao + decodificacao) / ganhoPorInstrucao << " instrucoes executadas)";
+    }
+    std::cout << "\n";
+}
+
+/**
+ * @brief Compara o modo `Fast` com e sem superinstrues: nmero de despachos e tempo.
+ *
+ * @param nome Nome do programa (para o relatrio).
+ * @param program Bytecode a executar.
+ */
+static void bench_fusion(std::string_view nome, const std::vector<Byte>& program) {
+    constexpr int kRepeticoes = 3;
+    std::array<double, 2> tempo{};
+    std::array<std::uint64_t, 2> despachos{};
+    for (int fundido = 0; fundido < 2; ++fundido) {
+        for (int r = 0; r < kRepeticoes; ++r) {
+            VirtualMachine::Config cfg;
+            cfg.dispatch = Dispatch::Fast;
+            cfg.fuse = (fundido == 1);
+            VirtualMachine vm(program, cfg);
+
+            const auto t0 = std::chrono::steady_clock::now();
+            vm.run();
+            const auto t1 = std::chrono::steady_clock::now();
+
+            const double segundos = std::chrono::duration<double>(t1 - t0).count();
+            tempo[fundido] = (r == 0) ? segundos : std::min(tempo[fundido], segundos);
+            despachos[fundido] = vm.instructionsExecuted();
+        }
+    }
+    std::cout << "fusao (" << nome << "): despachos " << despachos[0] << " -> " << despachos[1]
+        << " (" << std::fixed << std::setprecision(1)
+        << 100.0 * (1.0 - static_cast<double>(despachos[1]) / static_cast<double>(despachos[0])) << "% a menos)"
+        << ", tempo " << std::setprecision(1) << tempo[0] * 1e3 << " ms -> " << tempo[1] * 1e3 << " ms"
+        << " (" << std::setprecision(2) << tempo[0] / tempo[1] << "x)\n";
+}
+
+/**
+ * @brief Compara o mesmo lao escrito com os opcodes clssicos e com os largos (`PUSH32`, `JNZ`).
+ *
+ * Os dois programas fazem o mesmo trabalho; a diferena de despachos (5 -> 4 por iterao do
+ * lao interno) vem s do conjunto de instrues, sem superinstrues.
+ */
+static void bench_wide_ops(const std::vector<Byte>& classico, const std::vector<Byte>& largo) {
+    for (Dispatch d : { Dispatch::Threaded, Dispatch::Fast }) {
+        std::uint64_t despachos[2]{};
+        double tempo[2]{};
+        for (int v = 0; v < 2; ++v) {
+            VirtualMachine::Config cfg;
+            cfg.dispatch = d;
+            cfg.fuse = false;
+            for (int r = 0; r < 3; ++r) {
+                VirtualMachine vm(v == 0 ? classico : largo, cfg);
+                const auto t0 = std::chrono::steady_clock::now();
+                vm.run();
+                const double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                tempo[v] = (r == 0) ? segundos : std::min(tempo[v], segundos);
+                despachos[v] = vm.instructionsExecuted();
+            }
+        }
+        std::cout << "opcodes largos (" << dispatch_name(d) << "): despachos " << despachos[0] << " -> " << despachos[1]
+            << ", tempo " << std::fixed << std::setprecision(1) << tempo[0] * 1e3 << " ms -> " << tempo[1] * 1e3 << " ms"
+            << " (" << std::setprecision(2) << tempo[0] / tempo[1] << "x)\n";
+    }
+}
+
+/**
+ * @brief Executa o benchmark de despacho em um lao puro, em um lao dominado por aritmtica e
+ * nos programas que usam os opcodes largos, de memria e de chamada.
+ */
+static void run_benchmark() {
+    const auto laco = make_program_loop(200, 50000);
+    const auto aritmetica = make_program_arith(100, 50000);
+    const auto lacoLargo = make_program_loop_jnz(200, 50000);
+    bench_program("lao", laco);
+    bench_program("aritmtica", aritmetica);
+    bench_program("lao JNZ/PUSH32", lacoLargo);
+    bench_program("memria LOAD/STORE", make_program_memory(100, 50000));
+    bench_program("CALL/RET", make_program_call(5000000));
+    bench_fusion("lao", laco);
+    bench_fusion("aritmtica", aritmetica);
+    bench_wide_ops(laco, lacoLargo);
+}
+
+/**
+ * @brief Mede a vazo de `PRINT` com cada configurao de sada em um programa que imprime 10M valores.
+ *
+ * A sada vai para `std::cout` (redirecione para `/dev/null` ou um arquivo) e o relatrio para
+ * `std::cerr`. A linha de referncia imprime os mesmos valores com `std::cout << v << '\n'`,
+ * o que a VM fazia antes a cada `PRINT`.
+ */
+static void bench_output() {
+    constexpr Word16 kExterno = 200;
+    constexpr Word16 kInterno = 50000;
+    constexpr double kValores = static_cast<double>(kExterno) * kInterno;
+    const auto programa = make_program_print(kExterno, kInterno);
+
+    auto relatorio = [&](std::string_view nome, double segundos) {
+        std::cerr << std::left << std::setw(38) << nome << std::right << std::fixed
+            << std::setprecision(1) << kValores / segundos / 1e6 << " M valores/s  "
+            << std::setprecision(0) << segundos * 1e3 << " ms\n";
+    };
+
+    std::cerr << "--- Benchmark: PRINT de " << static_cast<std::uint64_t>(kValores) << " valores ---\n";
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        for (Word16 o = kExterno; o > 0; --o) {
+            for (Int i = kInterno; i > 0; --i) std::cout << i << '\n';
+        }
+        std::cout.flush();
+        relatorio("referencia: cout << v (sem VM)", std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    }
+
+    NullSink nulo;
+    struct Caso { std::string_view nome; OutputSink* sink; std::size_t buffer; };
+    for (const Caso& caso : { Caso{ "cout, um write por PRINT", nullptr, 0 },
+                              Caso{ "cout, buffer de 64 KiB", nullptr, 64 * 1024 },
+                              Caso{ "null sink, buffer de 64 KiB", &nulo, 64 * 1024 } }) {
+        for (Dispatch d : { Dispatch::Switch, Dispatch::Fast, Dispatch::Jit }) {
+            VirtualMachine::Config cfg;
+            cfg.dispatch = d;
+            cfg.output = caso.sink;
+            cfg.outputBuffer = caso.buffer;
+            VirtualMachine vm(programa, cfg);
+            const auto t0 = std::chrono::steady_clock::now();
+            vm.run();
+            std::cout.flush();
+            const double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            relatorio(std::string(dispatch_name(d)) + ", " + std::string(caso.nome), segundos);
+        }
+    }
+}
+
+/**
+ * @brief Compara a mquina de pilha (`Fast`, com e sem superinstrues) com a de registradores.
+ *
+ * Para cada programa reporta o nmero de despachos e o tempo mdio por execuo completa
+ * (construo da VM sobre o programa j preparado + `run()`), com a sada descartada.
+ */
+static void bench_register() {
+    struct Caso { std::string_view nome; std::vector<Byte> programa; int repeticoes; };
+    const std::vector<Caso> casos = {
+        { "programa 1 (expresso)", make_program1(), 200000 },
+        { "aritmtica (100x1000)", make_program_arith(100, 1000), 5 },
+        { "lao (200x1000)", make_program_loop(200, 1000), 5 },
+    };
+    struct Modo { std::string_view nome; Dispatch dispatch; bool fuse; };
+    const Modo modos[] = {
+        { "pilha (fast)", Dispatch::Fast, false },
+        { "pilha + superinstr.", Dispatch::Fast, true },
+        { "registradores", Dispatch::Register, false },
+    };
+
+    NullSink nulo;
+    std::cout << "--- Benchmark: pilha x registradores ---\n";
+    for (const Caso& caso : casos) {
+        std::cout << caso.nome << ":\n";
+        for (const Modo& modo : modos) {
+            VirtualMachine::Config cfg;
+            cfg.dispatch = modo.dispatch;
+            cfg.fuse = modo.fuse;
+            cfg.output = &nulo;
+            const auto programa = VirtualMachine::prepare(caso.programa, cfg);
+
+            std::uint64_t despachos = 0;
+            const auto t0 = std::chrono::steady_clock::now();
+            for (int r = 0; r < caso.repeticoes; ++r) {
+                VirtualMachine vm(programa, cfg, nullptr);
+                vm.run();
+                despachos = vm.instructionsExecuted();
+            }
+            const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / caso.repeticoes;
+            std::cout << "  " << std::left << std::setw(22) << modo.nome << std::right
+                << std::setw(12) << despachos << " despachos"
+                << std::setw(16) << std::fixed << std::setprecision(0) << ns << " ns/programa\n";
+        }
+    }
+}
+
+/**
+ * @brief Mede o tempo de inicializao de um programa grande vindo de um arquivo `.vmb`.
+ *
+ * Compara a leitura do arquivo para um `std::vector` (cpia) + verificao, o mapeamento
+ * com `mmap` + verificao. Por fim mede o custo de cada VM adicional criada
+ * sobre o mesmo programa mapeado, que no copia nem reanalisa o bytecode.
+ *
+ * @param blocos Nmero de blocos `PUSH 1; PUSH 2; ADD; POP` (6 bytes cada).
+ */
+static void bench_load(std::size_t blocos) {
+    std::vector<Byte> programa;
+    programa.reserve(blocos * 6 + 1);
+    for (std::size_t i = 0; i < blocos; ++i) {
+        assembler::emit_push(programa, 1);
+        assembler::emit_push(programa, 2);
+        assembler::emit(programa, Opcode::ADD);
+        assembler::emit(programa, Opcode::POP);
+    }
+    assembler::emit(programa, Opcode::HALT);
+
+    const std::string caminho = (std::filesystem::temp_directory_path() / "vm-bench-load.vmb").string();
+    const ProgramInfo info = verify_program(programa, Endianness::Big);
+    bytecode_file::write(caminho, programa, Endianness::Big, &info);
+
+    VirtualMachine::Config cfg;
+    cfg.dispatch = Dispatch::Fast;
+
+    auto medir = [](auto&& carregar) {
+        constexpr int kRepeticoes = 5;
+        double melhor = 0.0;
+        for (int r = 0; r < kRepeticoes; ++r) {
+            const auto t0 = std::chrono::steady_clock::now();
+            const auto programaPreparado = carregar();
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            melhor = (r == 0) ? ms : std::min(melhor, ms);
+            if (programaPreparado->bytecode.empty()) std::abort();
+        }
+        return melhor;
+    };
+
+    std::cout << "--- Benchmark: carga de " << programa.size() / 1024 << " KiB de bytecode ---\n" << std::fixed << std::setprecision(2);
+    const double copia = medir([&] {
+        std::ifstream in(caminho, std::ios::binary);
+        std::vector<Byte> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        bytecode_file::Header header;
+        const auto codigo = bytecode_file::parse(bytes, header);
+        return VirtualMachine::prepare(std::vector<Byte>(codigo.begin(), codigo.end()), cfg);
+    });
+    std::cout << "leitura (copia) + verificacao  " << copia << " ms\n";
+    const double mapeado = medir([&] { return VirtualMachine::prepare(BytecodeImage::open(caminho), cfg); });
+    std::cout << "mmap + verificacao             " << mapeado << " ms\n";
+
+    constexpr int kVms = 1000;
+    const auto compartilhado = VirtualMachine::prepare(BytecodeImage::open(caminho), cfg);
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kVms; ++i) {
+        VirtualMachine vm(compartilhado, cfg, nullptr);
+        if (vm.instructionsExecuted() != 0) std::abort();
     }
+    const double porVm = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / kVms;
+    std::cout << "VM adicional sobre o mapeamento " << porVm << " us (" << kVms << " VMs, uma copia do bytecode)\n";
+    std::filesystem::remove(caminho);
+}
+
+/**
+ * @brief Percentil `p` (0..1) de um conjunto de latncias.
+ */
+[[nodiscard]] static double percentile_us(std::vector<std::chrono::nanoseconds> v, double p) {
+    if (v.empty()) return 0.0;
+    const auto k = static_cast<std::size_t>(p * static_cast<double>(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(k), v.end());
+    return std::chrono::duration<double, std::micro>(v[k]).count();
 }
 
-// =========================== Programas de Teste ===========================
+/**
+ * @brief Mede a vazo (programas/s) e a latncia do `VMPool` conforme o nmero de threads.
+ *
+ * O lote tem muitos programas pequenos e independentes, como os de um servio, distribudos
+ * entre alguns programas distintos preparados uma nica vez. A primeira linha mostra o custo
+ * de criar uma VM do zero por programa (verificao + decodificao a cada execuo).
+ */
+static void bench_pool() {
+    constexpr std::size_t kProgramas = 20000;
+    VirtualMachine::Config cfg;
+    cfg.dispatch = Dispatch::Fast;
+
+    const std::vector<std::vector<Byte>> distintos = {
+        make_program_loop(1, 200), make_program_arith(1, 100), make_program_arith(2, 40), make_program_loop(4, 25)
+    };
+    std::vector<std::shared_ptr<const PreparedProgram>> lote;
+    lote.reserve(kProgramas);
+    std::vector<std::shared_ptr<const PreparedProgram>> preparados;
+    for (const auto& p : distintos) preparados.push_back(VirtualMachine::prepare(p, cfg));
+    for (std::size_t i = 0; i < kProgramas; ++i) lote.push_back(preparados[i % preparados.size()]);
+
+    std::cout << "--- Benchmark: VMPool (" << kProgramas << " programas, "
+        << std::thread::hardware_concurrency() << " CPUs) ---\n";
+
+    auto relatorio = [](std::string_view nome, double segundos, std::vector<std::chrono::nanoseconds> latencias) {
+        std::cout << std::left << std::setw(24) << nome << std::right << std::fixed
+            << std::setprecision(0) << static_cast<double>(latencias.size()) / segundos << " programas/s"
+            << "  p50 " << std::setprecision(2) << percentile_us(latencias, 0.50) << " us"
+            << "  p99 " << percentile_us(latencias, 0.99) << " us\n";
+    };
+
+    {
+        std::vector<std::chrono::nanoseconds> latencias;
+        latencias.reserve(kProgramas);
+        const auto t0 = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < kProgramas; ++i) {
+            const auto s0 = std::chrono::steady_clock::now();
+            VirtualMachine vm(distintos[i % distintos.size()], cfg);
+            vm.run();
+            latencias.push_back(std::chrono::steady_clock::now() - s0);
+        }
+        const double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        relatorio("sequencial (sem pool)", segundos, std::move(latencias));
+    }
+
+    const std::size_t maximo = std::max<std::size_t>(4, std::thread::hardware_concurrency());
+    for (std::size_t workers = 1; workers <= maximo; workers *= 2) {
+        VMPool pool(workers, cfg);
+        (void)pool.run(lote); // aquecimento: arenas e caches
+        const auto t0 = std::chrono::steady_clock::now();
+        const auto resultados = pool.run(lote);
+        const double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        std::vector<std::chrono::nanoseconds> latencias;
+        latencias.reserve(resultados.size());
+        for (const auto& r : resultados) latencias.push_back(r.latency);
+        relatorio("pool " + std::to_string(workers) + " thread(s)", segundos, std::move(latencias));
+    }
+}
 
 /**
- * @brief Cria um programa de teste aritmtico simples.
+ * @brief Sute fixa de desempenho: instrues por segundo de cada modo em um corpus de programas.
  *
- * Lgica: $(10 + 5) \times 2 = 30$.
+ * O corpus cobre laos puros, cadeias aritmticas, cdigo dominado por `PRINT` (sada para um
+ * `NullSink`) e os opcodes largos, de memria e de chamada. Cada medida  a melhor de 3
+ * execues; a contagem de instrues  a do modo `Switch` (o JIT no conta instrues).
  *
- * @return Bytecode do programa.
+ * Com `base`, compara com as medidas gravadas nesse arquivo (uma linha `programa modo Minstr/s`
+ * por medida) e falha se alguma ficar mais de `limite` por cento abaixo; se o arquivo no
+ * existir, grava nele as medidas atuais como nova base.
+ *
+ * @param base Arquivo de base (vazio = apenas relatrio).
+ * @param limite Queda tolerada, em porcentagem.
+ * @return 0 sem regresses, 1 caso contrrio.
  */
-static std::vector<Byte> make_program1() {
-    // Programa 1: (10 + 5) * 2 -> imprime 30
-    // PUSH 10; PUSH 5; ADD; PUSH 2; MUL; PRINT; HALT
-    std::vector<Byte> p;
-    assembler::emit_push(p, 10);
-    assembler::emit_push(p, 5);
-    assembler::emit(p, Opcode::ADD);
-    assembler::emit_push(p, 2);
-    assembler::emit(p, Opcode::MUL);
-    assembler::emit(p, Opcode::PRINT);
-    assembler::emit(p, Opcode::HALT);
-    return p;
+static int run_bench_suite(const std::string& base, double limite) {
+    struct Caso { std::string_view nome; std::vector<Byte> programa; };
+    const std::vector<Caso> corpus = {
+        { "laco", make_program_loop(100, 50000) },
+        { "aritmetica", make_program_arith(40, 50000) },
+        { "print", make_program_print(20, 50000) },
+        { "laco-jnz", make_program_loop_jnz(100, 50000) },
+        { "memoria", make_program_memory(50, 50000) },
+        { "call", make_program_call(2000000) },
+    };
+    constexpr std::array<Dispatch, 5> kModos = {
+        Dispatch::Switch, Dispatch::Threaded, Dispatch::Fast, Dispatch::Jit, Dispatch::Register
+    };
+
+    std::vector<std::tuple<std::string, std::string, double>> medidas;
+    NullSink nulo;
+    std::cout << std::left << std::setw(12) << "programa";
+    for (Dispatch d : kModos) std::cout << std::right << std::setw(11) << dispatch_name(d);
+    std::cout << "   (M instr/s)\n";
+    for (const Caso& caso : corpus) {
+        std::cout << std::left << std::setw(12) << caso.nome << std::right << std::fixed << std::setprecision(1);
+        std::uint64_t instrucoes = 0;
+        for (Dispatch d : kModos) {
+            VirtualMachine::Config cfg;
+            cfg.dispatch = d;
+            cfg.output = &nulo;
+            double menorTempo = 0.0;
+            for (int r = 0; r < 3; ++r) {
+                VirtualMachine vm(caso.programa, cfg);
+                const auto t0 = std::chrono::steady_clock::now();
+                vm.run();
+                const double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                if (d == Dispatch::Switch) instrucoes = vm.instructionsExecuted();
+                menorTempo = (r == 0) ? segundos : std::min(menorTempo, segundos);
+            }
+            const double mips = static_cast<double>(instrucoes) / menorTempo / 1e6;
+            medidas.emplace_back(std::string(caso.nome), std::string(dispatch_name(d)), mips);
+            std::cout << std::setw(11) << mips << std::flush;
+        }
+        std::cout << "\n";
+    }
+    if (base.empty()) return 0;
+
+    std::ifstream entrada(base);
+    if (!entrada) {
+        std::ofstream saida(base, std::ios::trunc);
+        for (const auto& [programa, modo, mips] : medidas) saida << programa << ' ' << modo << ' ' << mips << '\n';
+        if (!saida) throw VMError("No foi possvel gravar " + base);
+        std::cout << "base gravada em " << base << "\n";
+        return 0;
+    }
+    std::size_t regressoes = 0;
+    std::string linha;
+    while (std::getline(entrada, linha)) {
+        std::istringstream campos(linha);
+        std::string programa, modo;
+        double anterior = 0.0;
+        if (!(campos >> programa >> modo >> anterior) || anterior <= 0.0) continue;
+        const auto atual = std::find_if(medidas.begin(), medidas.end(), [&](const auto& m) {
+            return std::get<0>(m) == programa && std::get<1>(m) == modo;
+        });
+        if (atual == medidas.end()) continue;
+        const double variacao = 100.0 * (std::get<2>(*atual) / anterior - 1.0);
+        if (variacao < -limite) {
+            ++regressoes;
+            std::cout << "REGRESSO " << programa << "/" << modo << ": " << std::setprecision(1) << anterior
+                << " -> " << std::get<2>(*atual) << " M instr/s (" << variacao << "%, limite -" << limite << "%)\n";
+        }
+    }
+    std::cout << "comparado com " << base << ": " << regressoes << " regresses acima de " << limite << "%\n";
+    return regressoes == 0 ? 0 : 1;
 }
 
+// =========================== Teste diferencial ===========================
+
 /**
- * @brief Cria um programa de teste com loops e condicionais.
+ * @brief Executa um programa capturando tudo o que ele escreve em `std::cout` e `std::cerr`.
  *
- * Lgica: Contagem regressiva de 3 at 1.
- * Utiliza manipulao de pilha (`DUP`) e saltos (`JZ`, `JMP`).
+ * O resultado inclui a sada, o erro (se houver) e a linha de contexto que `run()` imprime em
+ * excees (IP e tamanho da pilha), de modo que dois modos s so considerados equivalentes
+ * se concordarem tambm no estado final.
+ */
+static std::string capture_run(const std::vector<Byte>& program, const VirtualMachine::Config& cfg) {
+    std::ostringstream saida;
+    std::streambuf* const coutAntigo = std::cout.rdbuf(saida.rdbuf());
+    std::streambuf* const cerrAntigo = std::cerr.rdbuf(saida.rdbuf());
+    try {
+        VirtualMachine vm(program, cfg);
+        vm.run();
+        saida << "[ok]";
+    }
+    catch (const VMError& e) {
+        saida << "[erro] " << e.what();
+    }
+    std::cout.rdbuf(coutAntigo);
+    std::cerr.rdbuf(cerrAntigo);
+    return saida.str();
+}
+
+/**
+ * @brief Compara os modos `Jit` e `Register` com o interpretador `Fast` em programas aleatrios
+ * e nos de exemplo.
  *
- * @return Bytecode do programa.
+ * @param quantidade Nmero de programas aleatrios.
+ * @return 0 se todas as execues coincidirem, 1 caso contrrio.
+ */
+static int run_differential_test(std::size_t quantidade) {
+    VirtualMachine::Config interpretador;
+    interpretador.dispatch = Dispatch::Fast;
+
+    {
+        VirtualMachine::Config nativo;
+        nativo.dispatch = Dispatch::Jit;
+        if (!VirtualMachine(make_program1(), nativo).jitActive()) {
+            std::cout << "JIT indisponvel neste host: o modo jit executa o interpretador fast.\n";
+        }
+    }
+
+    std::vector<std::vector<Byte>> programas = {
+        make_program1(), make_program2_countdown(), make_program_loop(3, 4), make_program_arith(2, 3),
+        make_program_loop_jnz(3, 4), make_program_memory(2, 5), make_program_call(10)
+    };
+    std::mt19937_64 rng(12345);
+    for (std::size_t i = 0; i < quantidade; ++i) programas.push_back(make_random_program(rng, 24));
+
+    std::size_t divergencias = 0;
+    for (Dispatch modo : { Dispatch::Jit, Dispatch::Register }) {
+        VirtualMachine::Config cfg;
+        cfg.dispatch = modo;
+        std::size_t divergenciasModo = 0;
+        for (const auto& programa : programas) {
+            const std::string esperado = capture_run(programa, interpretador);
+            const std::string obtido = capture_run(programa, cfg);
+            if (esperado != obtido && ++divergenciasModo <= 5) {
+                std::cout << "divergncia (" << programa.size() << " bytes):\n--- fast ---\n" << esperado
+                    << "\n--- " << dispatch_name(modo) << " ---\n" << obtido << "\n";
+            }
+        }
+        std::cout << dispatch_name(modo) << " x fast: " << programas.size() << " programas, "
+            << divergenciasModo << " divergncias\n";
+        divergencias += divergenciasModo;
+    }
+    return divergencias == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Resultado observvel de uma execuo: sada de `PRINT`, erro e instrues executadas.
  */
-static std::vector<Byte> make_program2_countdown() {
-    // Programa 2: contagem regressiva de 3 a 1 usando DUP, JZ, JMP
-    // Endereos calculados manualmente para clareza (big-endian)
-    // layout:
-    // 00: PUSH 3
-    // 02: DUP
-    // 03: PRINT
-    // 04: PUSH 1
-    // 06: SUB
-    // 07: DUP
-    // 08: JZ 0x0014
-    // 11: JMP 0x0002
-    // 14: POP
-    // 15: HALT
+struct Observacao {
+    std::string saida;
+    std::string erro;                     ///< Mensagem do `VMError` (vazia se terminou em `HALT`).
+    std::optional<std::uint64_t> passos;  ///< Instrues executadas, quando comparveis entre os modos.
+};
 
-    std::vector<Byte> p;
-    assembler::emit_push(p, 3);           // 00,01
+/**
+ * @brief Executa um programa na VM com `cfg`, capturando a sada e o erro.
+ *
+ * A linha de contexto que `run()` escreve em `std::cerr` nos erros  descartada: o estado final
+ * exato (IP e pilha)  comparado pelo `--diff-test`, entre os modos pr-decodificados.
+ */
+static Observacao observe_vm(const std::vector<Byte>& program, VirtualMachine::Config cfg, bool contaPassos) {
+    std::ostringstream saida;
+    std::ostringstream contexto;
+    StreamSink sink{ saida };
+    cfg.output = &sink;
+    std::streambuf* const cerrAntigo = std::cerr.rdbuf(contexto.rdbuf());
+    Observacao o;
+    std::uint64_t passos = 0;
+    try {
+        VirtualMachine vm(program, cfg);
+        try {
+            vm.run();
+        }
+        catch (...) {
+            passos = vm.instructionsExecuted();
+            throw;
+        }
+        passos = vm.instructionsExecuted();
+    }
+    catch (const VMError& e) {
+        o.erro = e.what();
+    }
+    std::cerr.rdbuf(cerrAntigo);
+    o.saida = saida.str();
+    if (contaPassos) o.passos = passos;
+    return o;
+}
 
-    assembler::emit(p, Opcode::DUP);     // 02
-    assembler::emit(p, Opcode::PRINT);   // 03
-    assembler::emit_push(p, 1);          // 04,05
-    assembler::emit(p, Opcode::SUB);     // 06
-    assembler::emit(p, Opcode::DUP);     // 07
+/**
+ * @brief Executa um programa em uma instanciao de `Interpreter` do ncleo.
+ */
+template <typename Interp>
+static Observacao observe_core(const std::vector<Byte>& program, Endianness endianness) {
+    std::ostringstream saida;
+    Observacao o;
+    try {
+        Interp vm(program, endianness);
+        o.passos = vm.run(saida);
+    }
+    catch (const VMError& e) {
+        o.erro = e.what();
+    }
+    o.saida = saida.str();
+    return o;
+}
 
-    // JZ -> endereo 0x0014 (decimal 20). colocamos big-endian 00 14
-    assembler::emit_jz_be(p, static_cast<Word16>(0x0014)); // 08,09,10
+/**
+ * @brief Converte um programa para a outra ordem de bytes (inverte os operandos de 2, 4 e 8 bytes).
+ */
+[[nodiscard]] static std::vector<Byte> swap_endianness(std::vector<Byte> code) {
+    for (Address pc = 0; pc < code.size(); pc += 1 + operand_size(static_cast<Opcode>(code[pc]))) {
+        const std::size_t len = operand_size(static_cast<Opcode>(code[pc]));
+        std::reverse(code.begin() + static_cast<std::ptrdiff_t>(pc + 1), code.begin() + static_cast<std::ptrdiff_t>(pc + 1 + len));
+    }
+    return code;
+}
 
-    // JMP -> endereo 0x0002
-    assembler::emit_jmp_be(p, static_cast<Word16>(0x0002)); // 11,12,13
+/**
+ * @brief *Fuzzing* diferencial: cada programa aleatrio roda em todos os modos e polticas.
+ *
+ * Os programas alternam entre `make_random_program` (saltos para frente, junes aleatrias) e
+ * `make_random_structured_program` (laos, sub-rotinas, memria). Cada um  executado em:
+ * - `VirtualMachine`: `switch` e `threaded` com e sem verificador na carga, `fast` com e sem
+ *   superinstrues, `fast` com o programa convertido para *little-endian*, `jit` e `register`;
+ * - `Interpreter` do ncleo: `int64_t` com `Checked` e `Unchecked`, comparados com a VM, e
+ *   `int32_t` com as duas polticas, comparados entre si.
+ *
+ * Todos precisam produzir a mesma sada e o mesmo erro (mensagem idntica); os modos que
+ * executam o bytecode sem fuso tambm precisam contar as mesmas instrues. O programa `i`
+ * usa a semente `semente + i`, ento `--fuzz 1 <semente + i>` reproduz uma divergncia.
+ *
+ * @param quantidade Nmero de programas.
+ * @param semente Semente do primeiro programa.
+ * @return 0 se todas as execues coincidirem, 1 caso contrrio.
+ */
+static int run_fuzz(std::size_t quantidade, std::uint64_t semente) {
+    struct Modo { std::string nome; VirtualMachine::Config cfg; bool contaPassos; bool littleEndian; };
+    std::vector<Modo> modos;
+    for (Dispatch d : { Dispatch::Switch, Dispatch::Threaded }) {
+        for (bool verifica : { false, true }) {
+            VirtualMachine::Config cfg;
+            cfg.dispatch = d;
+            cfg.verify = verifica;
+            modos.push_back({ std::string(dispatch_name(d)) + (verifica ? "/verify" : ""), cfg, true, false });
+        }
+    }
+    for (bool funde : { true, false }) {
+        VirtualMachine::Config cfg;
+        cfg.dispatch = Dispatch::Fast;
+        cfg.fuse = funde;
+        modos.push_back({ funde ? "fast" : "fast/nofuse", cfg, !funde, false });
+    }
+    {
+        VirtualMachine::Config cfg;
+        cfg.dispatch = Dispatch::Fast;
+        cfg.endianness = Endianness::Little;
+        modos.push_back({ "fast/little", cfg, false, true });
+    }
+    for (Dispatch d : { Dispatch::Jit, Dispatch::Register }) {
+        VirtualMachine::Config cfg;
+        cfg.dispatch = d;
+        modos.push_back({ std::string(dispatch_name(d)), cfg, false, false });
+    }
 
-    assembler::emit(p, Opcode::POP);     // 14
-    assembler::emit(p, Opcode::HALT);    // 15
+    std::size_t divergencias = 0;
+    std::uint64_t instrucoes = 0;
+    std::size_t erros = 0;
+    auto reporta = [&](std::uint64_t s, const std::vector<Byte>& programa, std::string_view a, const Observacao& x,
+        std::string_view b, const Observacao& y) {
+        if (++divergencias > 3) return;
+        std::cout << "divergncia (semente " << s << ", " << programa.size() << " bytes): " << a << " x " << b << "\n";
+        for (const auto& [nome, o] : { std::pair{ a, &x }, std::pair{ b, &y } }) {
+            std::cout << "--- " << nome << " (" << (o->passos ? std::to_string(*o->passos) : "?") << " passos) ---\n"
+                << o->saida << (o->erro.empty() ? "[ok]" : "[erro] " + o->erro) << "\n";
+        }
+        for (Address pc = 0; pc < programa.size(); pc += 1 + operand_size(static_cast<Opcode>(programa[pc]))) {
+            std::cout << "  " << std::setw(5) << pc << "  " << disassemble(programa, pc, Endianness::Big) << "\n";
+        }
+    };
+    auto confere = [&](std::uint64_t s, const std::vector<Byte>& programa, std::string_view a, const Observacao& x,
+        std::string_view b, const Observacao& y) {
+        const bool passosIguais = !x.passos || !y.passos || *x.passos == *y.passos;
+        if (x.saida != y.saida || x.erro != y.erro || !passosIguais) reporta(s, programa, a, x, b, y);
+    };
 
-    return p;
+    for (std::size_t i = 0; i < quantidade; ++i) {
+        const std::uint64_t s = semente + i;
+        std::mt19937_64 rng(s);
+        const std::vector<Byte> programa = (s % 2 == 0) ? make_random_program(rng, 32)
+                                                        : make_random_structured_program(rng, 48);
+        const std::vector<Byte> little = swap_endianness(programa);
+
+        const Observacao referencia = observe_vm(programa, modos[0].cfg, true);
+        instrucoes += referencia.passos.value_or(0);
+        if (!referencia.erro.empty()) ++erros;
+        for (std::size_t m = 1; m < modos.size(); ++m) {
+            const Modo& modo = modos[m];
+            confere(s, programa, modos[0].nome, referencia, modo.nome,
+                observe_vm(modo.littleEndian ? little : programa, modo.cfg, modo.contaPassos));
+        }
+        confere(s, programa, modos[0].nome, referencia, "core int64_t/checked",
+            observe_core<Interpreter<Int, Checked>>(programa, Endianness::Big));
+        confere(s, programa, modos[0].nome, referencia, "core int64_t/unchecked",
+            observe_core<Interpreter<Int, Unchecked>>(little, Endianness::Little));
+        confere(s, programa, "core int32_t/checked", observe_core<Interpreter<std::int32_t, Checked>>(programa, Endianness::Big),
+            "core int32_t/unchecked", observe_core<Interpreter<std::int32_t, Unchecked>>(programa, Endianness::Big));
+    }
+    std::cout << "fuzz: " << quantidade << " programas (sementes " << semente << ".." << semente + quantidade - 1
+        << "), " << modos.size() + 4 << " configuraes, " << instrucoes << " instrues na referncia, "
+        << erros << " terminados em erro, " << divergencias << " divergncias\n";
+    return divergencias == 0 ? 0 : 1;
 }
 
 // =========================== Main: execues de teste ===========================
@@ -540,11 +3456,90 @@ static std::vector<Byte> make_program2_countdown() {
  * @brief Ponto de entrada principal.
  *
  * Executa os dois programas de exemplo sequencialmente, capturando excees de execuo.
+ * Com o argumento `--bench`, executa apenas o benchmark de despacho; com `--pool`, o benchmark
+ * de execuo em lote (`VMPool`); com `--bench-print`, o de sada (`PRINT`); com `--profile`,
+ * o perfil de um programa de exemplo (exige `-DVM_PROFILE=1`); com `--register`, a comparao
+ * entre a mquina de pilha e a de registradores; com `--diff-test [n]`, apenas o teste
+ * diferencial dos modos `Jit` e `Register` contra o interpretador (n programas aleatrios);
+ * com `--fuzz [n] [semente]`, o *fuzzing* diferencial de todos os modos e polticas; com
+ * `--bench-suite [base] [limite%]`, a sute de desempenho, que falha (cdigo 1) em regresses
+ * acima do limite (padro 10%) em relao ao arquivo de base.
+ *
+ * Arquivos de bytecode: `--assemble entrada.asm saida.vmb` monta e verifica um programa em
+ * texto e grava o continer `.vmb`; `--run arquivo.vmb [modo]` o executa a partir de um
+ * mapeamento em memria; `--bench-load [blocos]` mede o tempo de inicializao.
  *
+ * @param argc Nmero de argumentos da linha de comando.
+ * @param argv Argumentos da linha de comando.
  * @return 0 em caso de sucesso, cdigos de erro > 0 em caso de falha.
  */
-int main() {
+int main(int argc, char* argv[]) {
     try {
+        if (argc > 1 && std::string_view(argv[1]) == "--bench") {
+            run_benchmark();
+            return 0;
+        }
+        if (argc > 1 && std::string_view(argv[1]) == "--bench-print") {
+            bench_output();
+            return 0;
+        }
+        if (argc > 1 && std::string_view(argv[1]) == "--profile") {
+            if (!VM_PROFILE) {
+                std::cerr << "Profiler no compilado: recompile com -DVM_PROFILE=1.\n";
+                return 1;
+            }
+            VirtualMachine::Config cfg;
+            cfg.profile = true;
+            cfg.profileSampleEvery = argc > 2 ? static_cast<std::uint32_t>(std::stoul(argv[2])) : 1;
+            VirtualMachine vm(make_program_arith(20, 1000), cfg);
+            vm.run();
+            return 0;
+        }
+        if (argc > 1 && std::string_view(argv[1]) == "--pool") {
+            bench_pool();
+            return 0;
+        }
+        if (argc > 3 && std::string_view(argv[1]) == "--assemble") {
+            std::ifstream in(argv[2]);
+            if (!in) throw VMError(std::string("No foi possvel abrir ") + argv[2]);
+            const std::string fonte((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            const auto programa = assembler::assemble_text(fonte);
+            const ProgramInfo info = verify_program(programa, Endianness::Big);
+            bytecode_file::write(argv[3], programa, Endianness::Big, &info);
+            std::cout << argv[3] << ": " << programa.size() << " bytes de cdigo, pilha mxima "
+                << info.maxStackDepth << "\n";
+            return 0;
+        }
+        if (argc > 2 && std::string_view(argv[1]) == "--run") {
+            VirtualMachine::Config cfg;
+            cfg.dispatch = Dispatch::Fast;
+            if (argc > 3) {
+                const auto modo = parse_dispatch(argv[3]);
+                if (!modo) throw VMError(std::string("Modo de despacho desconhecido: ") + argv[3]);
+                cfg.dispatch = *modo;
+            }
+            VirtualMachine vm(VirtualMachine::prepare(BytecodeImage::open(argv[2]), cfg), cfg, nullptr);
+            vm.run();
+            return 0;
+        }
+        if (argc > 1 && std::string_view(argv[1]) == "--bench-load") {
+            bench_load(argc > 2 ? std::stoul(argv[2]) : 1000000);
+            return 0;
+        }
+        if (argc > 1 && std::string_view(argv[1]) == "--diff-test") {
+            return run_differential_test(argc > 2 ? std::stoul(argv[2]) : 2000);
+        }
+        if (argc > 1 && std::string_view(argv[1]) == "--fuzz") {
+            return run_fuzz(argc > 2 ? std::stoul(argv[2]) : 2000, argc > 3 ? std::stoull(argv[3]) : 1);
+        }
+        if (argc > 1 && std::string_view(argv[1]) == "--bench-suite") {
+            return run_bench_suite(argc > 2 ? argv[2] : "", argc > 3 ? std::stod(argv[3]) : 10.0);
+        }
+        if (argc > 1 && std::string_view(argv[1]) == "--register") {
+            bench_register();
+            return 0;
+        }
+
         std::cout << "--- Iniciando VM (Programa 1) ---\n";
         {
             auto program1 = make_program1();
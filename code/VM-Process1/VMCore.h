@@ -0,0 +1,1804 @@
+/**
+ * @file VMCore.h
+ * @brief Ncleo *header-only* compartilhado pelas mquinas virtuais de pilha (VM-Process1 e VM-Process).
+ *
+ * Rene tudo o que define a linguagem da VM e no depende de um modo de execuo especfico:
+ * - tipos bsicos, `Opcode`, tabela de efeitos de pilha, decodificao de operandos,
+ *   aritmtica com *wraparound* (`wrap_add`...) e desmontagem;
+ * - o verificador esttico de bytecode (`verify_program`);
+ * - `Interpreter<Value, Checks>`, interpretador compacto parametrizado pelo tipo dos valores
+ *   (`std::int32_t`/`std::int64_t`) e pela poltica de verificao (`Checked`/`Unchecked`);
+ * - o montador (`assembler`) e os programas de teste usados pelas demonstraes e benchmarks.
+ *
+ * A VM-Process1 constri sobre ele seus modos avanados (pr-decodificao, JIT, registradores);
+ * a VM-Process usa diretamente as instanciaes de `Interpreter`.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <array>
+#include <string>
+#include <string_view>
+#include <span>
+#include <stdexcept>
+#include <sstream>
+#include <ostream>
+#include <iomanip>
+#include <algorithm>
+#include <charconv>
+#include <cctype>
+#include <concepts>
+#include <type_traits>
+#include <random>
+
+// =========================== Configuraes e Tipos ===========================
+
+/**
+ * @brief Tipo base para um byte de memria (8 bits).
+ */
+using Byte = uint8_t;
+
+/**
+ * @brief Tipo para representar uma palavra de 16 bits (usado em endereos e literais maiores).
+ */
+using Word16 = uint16_t;
+
+/**
+ * @brief Tipo para endereamento de memria (ndice no vetor de bytes).
+ */
+using Address = std::size_t;
+
+/**
+ * @brief Enumerao para configurao da ordem dos bytes (Endianness).
+ */
+enum class Endianness { Big, Little };
+
+/**
+ * @class VMError
+ * @brief Exceo especfica da Mquina Virtual.
+ *
+ * Herda de `std::runtime_error` para encapsular erros de execuo, como:
+ * - Stack underflow.
+ * - Opcode invlido.
+ * - Acesso invlido  memria.
+ * - Diviso por zero.
+ */
+class VMError : public std::runtime_error {
+public:
+    /**
+     * @brief Construtor da exceo.
+     * @param msg Mensagem de erro detalhada.
+     */
+    explicit VMError(std::string msg) : std::runtime_error("VM_ERROR: " + std::move(msg)) {}
+};
+
+/**
+ * @enum Opcode
+ * @brief Conjunto de instrues suportadas pela VM.
+ *
+ * Utiliza `enum class` herdando de `Byte` para garantir que cada instruo ocupe exatamente 1 byte
+ * e para evitar converses implcitas indesejadas.
+ */
+enum class Opcode : Byte {
+    HALT = 0x00,   ///< Para a execuo da VM.
+    PUSH = 0x01,   ///< Empilha um valor de 8 bits: `PUSH <uint8_t>`.
+    POP = 0x02,    ///< Desempilha o valor do topo e o descarta.
+    ADD = 0x03,    ///< Soma os dois valores do topo: $a + b$.
+    SUB = 0x04,    ///< Subtrai os dois valores do topo: $a - b$.
+    MUL = 0x05,    ///< Multiplica os dois valores do topo: $a \times b$.
+    DIV = 0x06,    ///< Divide os dois valores do topo: $a / b$.
+    PRINT = 0x07,  ///< Imprime o valor do topo da pilha na sada padro.
+
+    DUP = 0x08,    ///< Duplica o valor no topo da pilha.
+    SWAP = 0x09,   ///< Troca os dois valores no topo da pilha.
+    PUSH16 = 0x0A, ///< Empilha um valor de 16 bits: `PUSH16 <uint16_t>`.
+    JMP = 0x0B,    ///< Salto incondicional para endereo: `JMP <uint16_t addr>`.
+    JZ = 0x0C,     ///< Salto condicional se zero: `JZ <uint16_t addr>`.
+
+    PUSH32 = 0x0D, ///< Empilha um valor de 32 bits com sinal: `PUSH32 <int32_t>`.
+    PUSH64 = 0x0E, ///< Empilha um valor de 64 bits com sinal: `PUSH64 <int64_t>`.
+    LOAD = 0x0F,   ///< Empilha a clula do segmento de dados: `LOAD <uint16_t slot>`.
+    STORE = 0x10,  ///< Desempilha para a clula do segmento de dados: `STORE <uint16_t slot>`.
+    JLT = 0x11,    ///< Desempilha $b$ e $a$ e salta se $a < b$: `JLT <uint32_t addr>`.
+    JNZ = 0x12,    ///< Salto condicional se diferente de zero: `JNZ <uint32_t addr>`.
+    CALL = 0x13,   ///< Chama a sub-rotina em `addr`, guardando o retorno: `CALL <uint32_t addr>`.
+    RET = 0x14,    ///< Retorna da sub-rotina corrente.
+    JMP32 = 0x15,  ///< `JMP` com alvo de 32 bits (programas maiores que 64 KiB).
+    JZ32 = 0x16    ///< `JZ` com alvo de 32 bits.
+};
+
+/**
+ * @brief Nmero de clulas do segmento de dados endereveis por `LOAD`/`STORE` (ndice de 16 bits).
+ *
+ * Cada programa recebe apenas as clulas que referencia (ver `ProgramInfo::dataSlots`), todas
+ * iniciadas com zero.
+ */
+constexpr std::size_t kMaxDataSlots = 65536;
+
+/**
+ * @brief Profundidade mxima de chamadas aninhadas (`CALL` sem o `RET` correspondente).
+ */
+constexpr std::size_t kMaxCallDepth = 1024;
+
+/**
+ * @brief Lista constante de opcodes vlidos para validao rpida.
+ *
+ * @note O uso de `constexpr std::array` permite que essa lista seja construda em tempo de compilao,
+ * otimizando a verificao de segurana sem custo de tempo de execuo para inicializao.
+ */
+constexpr std::array<Byte, 23> kValidOpcodes = {
+    static_cast<Byte>(Opcode::HALT),
+    static_cast<Byte>(Opcode::PUSH),
+    static_cast<Byte>(Opcode::POP),
+    static_cast<Byte>(Opcode::ADD),
+    static_cast<Byte>(Opcode::SUB),
+    static_cast<Byte>(Opcode::MUL),
+    static_cast<Byte>(Opcode::DIV),
+    static_cast<Byte>(Opcode::PRINT),
+    static_cast<Byte>(Opcode::DUP),
+    static_cast<Byte>(Opcode::SWAP),
+    static_cast<Byte>(Opcode::PUSH16),
+    static_cast<Byte>(Opcode::JMP),
+    static_cast<Byte>(Opcode::JZ),
+    static_cast<Byte>(Opcode::PUSH32),
+    static_cast<Byte>(Opcode::PUSH64),
+    static_cast<Byte>(Opcode::LOAD),
+    static_cast<Byte>(Opcode::STORE),
+    static_cast<Byte>(Opcode::JLT),
+    static_cast<Byte>(Opcode::JNZ),
+    static_cast<Byte>(Opcode::CALL),
+    static_cast<Byte>(Opcode::RET),
+    static_cast<Byte>(Opcode::JMP32),
+    static_cast<Byte>(Opcode::JZ32)
+};
+
+/**
+ * @brief Verifica se um byte corresponde a um Opcode vlido.
+ *
+ * @param b O byte a ser verificado.
+ * @return `true` se o byte for um opcode vlido, `false` caso contrrio.
+ *
+ * @note Destaque C++23:
+ * - `[[nodiscard]]`: O compilador emitir um aviso se o retorno desta funo for ignorado.
+ * - `constexpr`: Permite que esta verificao seja feita em tempo de compilao se o argumento for constante.
+ * - `noexcept`: Garante que esta funo no lana excees.
+ */
+[[nodiscard]] constexpr bool is_valid_opcode(Byte b) noexcept {
+    for (Byte v : kValidOpcodes) if (v == b) return true;
+    return false;
+}
+
+/**
+ * @brief Retorna quantos bytes de operando seguem um opcode no bytecode.
+ *
+ * @param op O opcode consultado.
+ * @return 1 para `PUSH`; 2 para `PUSH16`, `JMP`, `JZ`, `LOAD` e `STORE`; 4 para `PUSH32` e os
+ * saltos de 32 bits; 8 para `PUSH64`; 0 para os demais.
+ */
+[[nodiscard]] constexpr std::size_t operand_size(Opcode op) noexcept {
+    switch (op) {
+    case Opcode::PUSH:
+        return 1;
+    case Opcode::PUSH16:
+    case Opcode::JMP:
+    case Opcode::JZ:
+    case Opcode::LOAD:
+    case Opcode::STORE:
+        return 2;
+    case Opcode::PUSH32:
+    case Opcode::JLT:
+    case Opcode::JNZ:
+    case Opcode::CALL:
+    case Opcode::JMP32:
+    case Opcode::JZ32:
+        return 4;
+    case Opcode::PUSH64:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Indica se o operando do opcode  um endereo de destino (saltos e `CALL`).
+ */
+[[nodiscard]] constexpr bool is_branch(Opcode op) noexcept {
+    switch (op) {
+    case Opcode::JMP:
+    case Opcode::JZ:
+    case Opcode::JLT:
+    case Opcode::JNZ:
+    case Opcode::CALL:
+    case Opcode::JMP32:
+    case Opcode::JZ32:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Indica se a execuo nunca continua na instruo seguinte (`HALT`, `RET` e saltos incondicionais).
+ */
+[[nodiscard]] constexpr bool ends_flow(Opcode op) noexcept {
+    return op == Opcode::HALT || op == Opcode::RET || op == Opcode::JMP || op == Opcode::JMP32;
+}
+
+/**
+ * @brief Indica se o compilador suporta *labels as values* (goto computado).
+ *
+ * GCC e Clang oferecem a extenso `&&label` / `goto *ptr`, que permite o despacho
+ * *direct-threaded*: cada handler salta diretamente para o prximo, sem voltar a um `switch`.
+ * Nos demais compiladores (MSVC) usamos uma tabela de ponteiros para funes.
+ */
+#ifndef VM_HAS_COMPUTED_GOTO
+#if defined(__GNUC__) || defined(__clang__)
+#define VM_HAS_COMPUTED_GOTO 1
+#else
+#define VM_HAS_COMPUTED_GOTO 0
+#endif
+#endif
+
+/**
+ * @brief Nome mnemnico de um opcode (usado em mensagens de erro e na desmontagem).
+ */
+[[nodiscard]] constexpr std::string_view opcode_name(Opcode op) noexcept {
+    switch (op) {
+    case Opcode::HALT:   return "HALT";
+    case Opcode::PUSH:   return "PUSH";
+    case Opcode::POP:    return "POP";
+    case Opcode::ADD:    return "ADD";
+    case Opcode::SUB:    return "SUB";
+    case Opcode::MUL:    return "MUL";
+    case Opcode::DIV:    return "DIV";
+    case Opcode::PRINT:  return "PRINT";
+    case Opcode::DUP:    return "DUP";
+    case Opcode::SWAP:   return "SWAP";
+    case Opcode::PUSH16: return "PUSH16";
+    case Opcode::JMP:    return "JMP";
+    case Opcode::JZ:     return "JZ";
+    case Opcode::PUSH32: return "PUSH32";
+    case Opcode::PUSH64: return "PUSH64";
+    case Opcode::LOAD:   return "LOAD";
+    case Opcode::STORE:  return "STORE";
+    case Opcode::JLT:    return "JLT";
+    case Opcode::JNZ:    return "JNZ";
+    case Opcode::CALL:   return "CALL";
+    case Opcode::RET:    return "RET";
+    case Opcode::JMP32:  return "JMP32";
+    case Opcode::JZ32:   return "JZ32";
+    }
+    return "?";
+}
+
+/**
+ * @struct StackEffect
+ * @brief Efeito de uma instruo sobre a pilha: quantos valores consome e quantos produz.
+ */
+struct StackEffect {
+    int pops;   ///< Valores exigidos no topo da pilha.
+    int pushes; ///< Valores deixados no lugar dos consumidos.
+};
+
+/**
+ * @brief Tabela de efeitos de pilha de cada opcode, base da interpretao abstrata do verificador.
+ */
+[[nodiscard]] constexpr StackEffect stack_effect(Opcode op) noexcept {
+    switch (op) {
+    case Opcode::PUSH:
+    case Opcode::PUSH16:
+    case Opcode::PUSH32:
+    case Opcode::PUSH64:
+    case Opcode::LOAD:   return { 0, 1 };
+    case Opcode::POP:
+    case Opcode::PRINT:
+    case Opcode::JZ:
+    case Opcode::JZ32:
+    case Opcode::JNZ:
+    case Opcode::STORE:  return { 1, 0 };
+    case Opcode::JLT:    return { 2, 0 };
+    case Opcode::ADD:
+    case Opcode::SUB:
+    case Opcode::MUL:
+    case Opcode::DIV:    return { 2, 1 };
+    case Opcode::DUP:    return { 1, 2 };
+    case Opcode::SWAP:   return { 2, 2 };
+    default:             return { 0, 0 }; // HALT, JMP, JMP32, CALL, RET
+    }
+}
+
+/**
+ * @brief Combina dois bytes em uma palavra de 16 bits segundo a ordem de bytes configurada.
+ */
+[[nodiscard]] constexpr Word16 decode_word(Byte b0, Byte b1, Endianness e) noexcept {
+    if (e == Endianness::Big) {
+        return static_cast<Word16>((static_cast<Word16>(b0) << 8) | static_cast<Word16>(b1));
+    }
+    return static_cast<Word16>((static_cast<Word16>(b1) << 8) | static_cast<Word16>(b0));
+}
+
+/**
+ * @brief L um operando de `sizeof(T)` bytes segundo a ordem de bytes configurada.
+ *
+ * @tparam T Tipo inteiro do operando (`std::uint32_t`, `std::int32_t`, `std::int64_t`...).
+ * @param p Primeiro byte do operando.
+ * @param e Ordem de bytes.
+ */
+template <std::integral T>
+[[nodiscard]] constexpr T decode_operand(const Byte* p, Endianness e) noexcept {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        const Byte b = e == Endianness::Big ? p[i] : p[sizeof(T) - 1 - i];
+        value = (value << 8) | b;
+    }
+    return static_cast<T>(value);
+}
+
+/**
+ * @brief Destino do salto (ou `CALL`) que comea em `pc`: 16 bits para `JMP`/`JZ`, 32 bits para os demais.
+ */
+[[nodiscard]] constexpr Address branch_target(std::span<const Byte> code, Address pc, Endianness e) noexcept {
+    const auto op = static_cast<Opcode>(code[pc]);
+    if (operand_size(op) == 2) return decode_word(code[pc + 1], code[pc + 2], e);
+    return decode_operand<std::uint32_t>(&code[pc + 1], e);
+}
+
+/**
+ * @brief Valor empilhado por uma instruo `PUSH*` que comea em `pc`.
+ *
+ * `PUSH` e `PUSH16` estendem com zeros; `PUSH32` estende o sinal; `PUSH64`  o valor exato.
+ */
+[[nodiscard]] constexpr std::int64_t push_value(std::span<const Byte> code, Address pc, Endianness e) noexcept {
+    switch (static_cast<Opcode>(code[pc])) {
+    case Opcode::PUSH:   return code[pc + 1];
+    case Opcode::PUSH16: return decode_word(code[pc + 1], code[pc + 2], e);
+    case Opcode::PUSH32: return decode_operand<std::int32_t>(&code[pc + 1], e);
+    default:             return decode_operand<std::int64_t>(&code[pc + 1], e);
+    }
+}
+
+/**
+ * @brief Clulas do segmento de dados usadas por um programa: o maior slot de `LOAD`/`STORE` + 1.
+ *
+ * Varredura linear, sem anlise de fluxo; para no primeiro opcode invlido ou operando truncado.
+ * Os modos que no verificam o programa ainda conferem cada acesso em tempo de execuo.
+ */
+[[nodiscard]] inline std::size_t data_slots(std::span<const Byte> code, Endianness e) noexcept {
+    std::size_t slots = 0;
+    for (Address pc = 0; pc < code.size() && is_valid_opcode(code[pc]);) {
+        const auto op = static_cast<Opcode>(code[pc]);
+        const std::size_t len = 1 + operand_size(op);
+        if (pc + len > code.size()) break;
+        if (op == Opcode::LOAD || op == Opcode::STORE) {
+            slots = std::max<std::size_t>(slots, decode_word(code[pc + 1], code[pc + 2], e) + 1u);
+        }
+        pc += len;
+    }
+    return slots;
+}
+
+/**
+ * @brief Aritmtica em complemento de dois com *wraparound* (estouro no  comportamento indefinido).
+ *
+ * Usada por todos os modos de execuo, para que `PUSH64` e produtos grandes tenham o mesmo
+ * resultado em qualquer ncleo (e no cdigo nativo do JIT).
+ */
+template <std::signed_integral T>
+[[nodiscard]] constexpr T wrap_add(T a, T b) noexcept {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(static_cast<U>(a) + static_cast<U>(b));
+}
+
+template <std::signed_integral T>
+[[nodiscard]] constexpr T wrap_sub(T a, T b) noexcept {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(static_cast<U>(a) - static_cast<U>(b));
+}
+
+template <std::signed_integral T>
+[[nodiscard]] constexpr T wrap_mul(T a, T b) noexcept {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(static_cast<U>(a) * static_cast<U>(b));
+}
+
+/// @brief Diviso truncada com `b != 0`; `MIN / -1` d a volta para `MIN` (em vez do *trap* de `idiv`).
+template <std::signed_integral T>
+[[nodiscard]] constexpr T wrap_div(T a, T b) noexcept {
+    return b == -1 ? wrap_sub(T{ 0 }, a) : static_cast<T>(a / b);
+}
+
+/**
+ * @brief Desmonta a instruo no endereo `pc` (ex.: `PUSH16 300`, `JZ 0x000E`, `LOAD 3`).
+ *
+ * @param code Bytecode.
+ * @param pc Endereo do incio de uma instruo.
+ * @param endianness Ordem de bytes dos operandos.
+ * @return Texto da instruo; `??` para opcodes invlidos ou operandos truncados.
+ */
+[[nodiscard]] inline std::string disassemble(std::span<const Byte> code, std::size_t pc, Endianness endianness) {
+    if (pc >= code.size() || !is_valid_opcode(code[pc])) return "??";
+    const auto op = static_cast<Opcode>(code[pc]);
+    std::string text(opcode_name(op));
+    const std::size_t len = operand_size(op);
+    if (len == 0) return text;
+    if (pc + len >= code.size()) return text + " ??";
+    if (is_branch(op)) {
+        std::ostringstream out;
+        out << " 0x" << std::hex << std::uppercase << std::setw(4) << std::setfill('0')
+            << branch_target(code, pc, endianness);
+        return text + out.str();
+    }
+    if (op == Opcode::LOAD || op == Opcode::STORE) {
+        return text + " " + std::to_string(decode_word(code[pc + 1], code[pc + 2], endianness));
+    }
+    return text + " " + std::to_string(push_value(code, pc, endianness));
+}
+
+// =========================== Verificador de bytecode ===========================
+
+/**
+ * @struct BasicBlock
+ * @brief Bloco bsico: sequncia de instrues com uma nica entrada e uma nica sada.
+ */
+struct BasicBlock {
+    Address begin = 0;          ///< Endereo da primeira instruo (lder).
+    Address end = 0;            ///< Endereo logo aps a ltima instruo.
+    int entryDepth = -1;        ///< Profundidade da pilha na entrada (-1 = bloco inalcanvel).
+    int maxDepth = -1;          ///< Maior profundidade atingida dentro do bloco.
+};
+
+/**
+ * @struct ProgramInfo
+ * @brief Resultado do verificador: fatos estticos provados sobre o programa.
+ *
+ * Com estes fatos, o modo `Dispatch::Fast` pode dispensar as verificaes de limites da memria,
+ * de alvos de salto e de *underflow* e *overflow* da pilha em cada instruo executada.
+ */
+struct ProgramInfo {
+    std::vector<bool> instructionStart; ///< `true` nos endereos onde comea uma instruo.
+    std::vector<int> depthAt;           ///< Profundidade da pilha antes de cada instruo (-1 se inalcanvel).
+    std::vector<BasicBlock> blocks;     ///< Blocos bsicos em ordem de endereo.
+    std::size_t maxStackDepth = 0;      ///< Maior profundidade de pilha possvel em qualquer execuo.
+    std::size_t dataSlots = 0;          ///< Clulas do segmento de dados usadas (`data_slots`).
+    bool hasCalls = false;              ///< O programa contm `CALL` (precisa de pilha de retorno).
+};
+
+/**
+ * @brief Verifica estaticamente um programa, sem execut-lo.
+ *
+ * Etapas:
+ * 1. Varredura linear: todo opcode  vlido e todo operando cabe na memria.
+ * 2. Alvos de saltos e de `CALL` existem e caem no incio de uma instruo.
+ * 3. Particionamento em blocos bsicos (lderes: endereo 0, alvos e instrues aps saltos,
+ *    `CALL`, `RET` e `HALT`).
+ * 4. Interpretao abstrata da profundidade da pilha: cada bloco alcanvel  simulado com sua
+ *    profundidade de entrada, provando a ausncia de *underflow*, exigindo profundidades
+ *    iguais nos pontos de juno e que nenhum caminho ultrapasse o fim do programa.
+ *
+ * Sub-rotinas: cada bloco pertence a uma nica funo (o programa principal ou o alvo de um
+ * `CALL`), e as profundidades continuam absolutas. Por isso toda chamada de uma mesma funo
+ * ocorre com a mesma profundidade, todo `RET` dela deixa a mesma profundidade (que  a da
+ * instruo aps cada `CALL`) e `RET` no programa principal  rejeitado. Assim `depthAt` segue
+ * valendo para os modos que alocam a pilha em registradores, e um `RET` verificado sempre tem
+ * um `CALL` correspondente. S o limite de aninhamento (`kMaxCallDepth`, alcanvel por
+ * recurso) fica para a execuo.
+ *
+ * @param code Bytecode a verificar.
+ * @param endianness Ordem de bytes usada para decodificar operandos.
+ * @return Os fatos provados sobre o programa.
+ * @throws VMError Com o endereo e o motivo exatos da primeira violao encontrada.
+ */
+[[nodiscard]] inline ProgramInfo verify_program(std::span<const Byte> code, Endianness endianness) {
+    const Address size = code.size();
+    ProgramInfo info;
+    info.instructionStart.assign(size, false);
+    info.depthAt.assign(size, -1);
+    if (size == 0) throw VMError("Verificador: programa vazio");
+
+    auto fail = [](Address at, const std::string& why) {
+        return VMError("Verificador: IP=" + std::to_string(at) + ": " + why);
+    };
+
+    // 1. Varredura linear.
+    for (Address pc = 0; pc < size;) {
+        const Byte raw = code[pc];
+        if (!is_valid_opcode(raw)) {
+            std::ostringstream oss;
+            oss << "opcode invlido 0x" << std::hex << std::setw(2) << std::setfill('0')
+                << static_cast<int>(raw);
+            throw fail(pc, oss.str());
+        }
+        const Opcode op = static_cast<Opcode>(raw);
+        const std::size_t len = 1 + operand_size(op);
+        if (pc + len > size) {
+            throw fail(pc, std::string(opcode_name(op)) + " truncado: faltam "
+                + std::to_string(pc + len - size) + " byte(s) de operando");
+        }
+        info.instructionStart[pc] = true;
+        if (op == Opcode::CALL) info.hasCalls = true;
+        pc += len;
+    }
+    info.dataSlots = data_slots(code, endianness);
+
+    auto targetOf = [&](Address pc) -> Address {
+        return branch_target(code, pc, endianness);
+    };
+
+    // 2. Alvos de salto e 3. lderes dos blocos bsicos.
+    std::vector<bool> leader(size, false);
+    leader[0] = true;
+    for (Address pc = 0; pc < size; pc += 1 + operand_size(static_cast<Opcode>(code[pc]))) {
+        const Opcode op = static_cast<Opcode>(code[pc]);
+        const Address next = pc + 1 + operand_size(op);
+        if (is_branch(op)) {
+            const Address target = targetOf(pc);
+            if (target >= size) {
+                throw fail(pc, std::string(opcode_name(op)) + " salta para " + std::to_string(target)
+                    + ", fora do programa (tamanho " + std::to_string(size) + ")");
+            }
+            if (!info.instructionStart[target]) {
+                throw fail(pc, std::string(opcode_name(op)) + " salta para " + std::to_string(target)
+                    + ", que no  incio de instruo");
+            }
+            leader[target] = true;
+        }
+        if ((is_branch(op) || ends_flow(op)) && next < size) leader[next] = true;
+    }
+
+    std::vector<std::size_t> blockAt(size, 0);
+    for (Address pc = 0; pc < size; pc += 1 + operand_size(static_cast<Opcode>(code[pc]))) {
+        if (leader[pc]) {
+            if (!info.blocks.empty()) info.blocks.back().end = pc;
+            info.blocks.push_back(BasicBlock{ pc, size, -1, -1 });
+        }
+        blockAt[pc] = info.blocks.size() - 1;
+    }
+
+    // 4. Interpretao abstrata da profundidade da pilha (worklist sobre blocos).
+    //    `owner` identifica a funo dona de cada bloco: 0 = programa principal, entrada + 1 = sub-rotina.
+    struct Function {
+        int entryDepth = -1;
+        int retDepth = -1;                               ///< -1 enquanto nenhum `RET` foi analisado.
+        std::vector<std::pair<Address, Address>> waiting; ///< (`CALL`, continuao)  espera do `RET`.
+    };
+    std::vector<std::size_t> owner(info.blocks.size(), 0);
+    std::vector<Function> functions(size + 1);
+    std::vector<std::size_t> worklist;
+    auto reach = [&](Address from, Address target, int depth, std::size_t fn) {
+        const std::size_t index = blockAt[target];
+        BasicBlock& b = info.blocks[index];
+        if (b.entryDepth < 0) {
+            b.entryDepth = depth;
+            owner[index] = fn;
+            worklist.push_back(index);
+            return;
+        }
+        if (owner[index] != fn) {
+            throw fail(from, "IP=" + std::to_string(target) + "  alcanado por duas funes diferentes");
+        }
+        if (b.entryDepth != depth) {
+            throw fail(from, "profundidade de pilha inconsistente ao chegar em IP=" + std::to_string(target)
+                + " (" + std::to_string(depth) + " por este caminho, "
+                + std::to_string(b.entryDepth) + " por outro)");
+        }
+    };
+
+    reach(0, 0, 0, 0);
+    while (!worklist.empty()) {
+        const std::size_t index = worklist.back();
+        worklist.pop_back();
+        BasicBlock& b = info.blocks[index];
+        const std::size_t fn = owner[index];
+
+        int depth = b.entryDepth;
+        b.maxDepth = depth;
+        Address pc = b.begin;
+        for (;;) {
+            const Opcode op = static_cast<Opcode>(code[pc]);
+            const StackEffect eff = stack_effect(op);
+            info.depthAt[pc] = depth;
+            if (depth < eff.pops) {
+                throw fail(pc, "stack underflow: " + std::string(opcode_name(op)) + " precisa de "
+                    + std::to_string(eff.pops) + " valor(es), profundidade " + std::to_string(depth));
+            }
+            depth += eff.pushes - eff.pops;
+            b.maxDepth = std::max(b.maxDepth, depth);
+
+            const Address next = pc + 1 + operand_size(op);
+            if (op == Opcode::HALT) break;
+            if (op == Opcode::RET) {
+                if (fn == 0) throw fail(pc, "RET fora de uma funo");
+                Function& f = functions[fn];
+                if (f.retDepth >= 0 && f.retDepth != depth) {
+                    throw fail(pc, "RET com profundidade " + std::to_string(depth) + ", outro RET da funo em IP="
+                        + std::to_string(fn - 1) + " deixa " + std::to_string(f.retDepth));
+                }
+                f.retDepth = depth;
+                const auto waiting = std::move(f.waiting);
+                f.waiting.clear();
+                for (const auto& [call, cont] : waiting) reach(call, cont, depth, owner[blockAt[call]]);
+                break;
+            }
+            if (op == Opcode::CALL) {
+                const Address target = targetOf(pc);
+                Function& f = functions[target + 1];
+                if (f.entryDepth >= 0 && f.entryDepth != depth) {
+                    throw fail(pc, "CALL com profundidade " + std::to_string(depth) + ", mas a funo em IP="
+                        + std::to_string(target) + " j  chamada com " + std::to_string(f.entryDepth));
+                }
+                f.entryDepth = depth;
+                reach(pc, target, depth, target + 1);
+                if (next >= size) throw fail(pc, "a execuo pode passar do fim do programa sem HALT");
+                if (functions[target + 1].retDepth >= 0) reach(pc, next, functions[target + 1].retDepth, fn);
+                else functions[target + 1].waiting.emplace_back(pc, next);
+                break;
+            }
+            if (op == Opcode::JMP || op == Opcode::JMP32) { reach(pc, targetOf(pc), depth, fn); break; }
+            if (is_branch(op)) reach(pc, targetOf(pc), depth, fn);
+            if (next >= size) throw fail(pc, "a execuo pode passar do fim do programa sem HALT");
+            if (next == b.end) { reach(pc, next, depth, fn); break; }
+            pc = next;
+        }
+        info.maxStackDepth = std::max(info.maxStackDepth, static_cast<std::size_t>(b.maxDepth));
+    }
+    return info;
+}
+
+// =========================== Interpretador genrico ===========================
+
+/**
+ * @brief Poltica `Checked`: cada instruo confere, em tempo de execuo, os limites da memria
+ * e da pilha, a validade do opcode e o alvo dos saltos.
+ */
+struct Checked {
+    static constexpr bool kRuntimeChecks = true;
+    static constexpr std::string_view kName = "checked";
+};
+
+/**
+ * @brief Poltica `Unchecked`: o programa  aprovado por `verify_program` na construo e o lao
+ * de execuo no confere nada alm da diviso por zero.
+ */
+struct Unchecked {
+    static constexpr bool kRuntimeChecks = false;
+    static constexpr std::string_view kName = "unchecked";
+};
+
+/**
+ * @brief Requisitos de uma poltica de verificao para `Interpreter`.
+ */
+template <typename P>
+concept CheckPolicy = requires {
+    { P::kRuntimeChecks } -> std::convertible_to<bool>;
+    { P::kName } -> std::convertible_to<std::string_view>;
+};
+
+/**
+ * @class Interpreter
+ * @brief Interpretador de bytecode parametrizado pelo tipo dos valores da pilha e pela poltica de verificao.
+ *
+ * Todas as instanciaes executam a mesma linguagem com a mesma semntica: aritmtica em
+ * complemento de dois com *wraparound* na largura de `Value` (estouro no  comportamento
+ * indefinido) e `VMError` na diviso por zero. Com `Unchecked`, o verificador prova na carga
+ * a ausncia de *underflow*, operandos truncados e saltos invlidos, e o lao dispensa todas
+ * essas verificaes; a pilha  alocada com a profundidade mxima provada.
+ *
+ * O segmento de dados de `LOAD`/`STORE` tem as clulas referenciadas pelo programa, iniciadas
+ * com zero a cada `run`; `CALL`/`RET` usam uma pilha de retorno separada, limitada a
+ * `kMaxCallDepth` em qualquer poltica.
+ *
+ * O despacho usa goto computado quando disponvel (`VM_HAS_COMPUTED_GOTO`) e `switch` nos
+ * demais compiladores. `PRINT` formata com `std::to_chars` em um buffer descarregado em blocos.
+ *
+ * @tparam Value Tipo inteiro com sinal dos valores da pilha (`std::int32_t` ou `std::int64_t`).
+ * @tparam Checks Poltica de verificao (`Checked` ou `Unchecked`).
+ */
+template <std::signed_integral Value, CheckPolicy Checks>
+class Interpreter {
+public:
+    using value_type = Value;
+    static constexpr bool kRuntimeChecks = Checks::kRuntimeChecks;
+    static constexpr std::size_t kDefaultStackLimit = 1024;    ///< Limite padro da pilha, em valores.
+    static constexpr std::size_t kOutputFlush = 64 * 1024;     ///< Tamanho do bloco de sada de `PRINT`.
+
+    /**
+     * @brief Prepara a execuo de um programa (que no  copiado: deve sobreviver ao interpretador).
+     *
+     * @param code Bytecode.
+     * @param endianness Ordem de bytes dos operandos.
+     * @param stackLimit Maior nmero de valores na pilha.
+     * @throws VMError Com `Unchecked`, se o programa for rejeitado pelo verificador ou puder
+     *         ultrapassar `stackLimit`.
+     */
+    explicit Interpreter(std::span<const Byte> code, Endianness endianness = Endianness::Big,
+        std::size_t stackLimit = kDefaultStackLimit)
+        : code_(code), endianness_(endianness) {
+        if constexpr (kRuntimeChecks) {
+            stack_.resize(std::max<std::size_t>(stackLimit, 1));
+            data_.resize(data_slots(code, endianness));
+        }
+        else {
+            const ProgramInfo info = verify_program(code, endianness);
+            if (info.maxStackDepth > stackLimit) {
+                throw VMError("Pilha cheia: o programa pode empilhar " + std::to_string(info.maxStackDepth)
+                    + " valores (limite " + std::to_string(stackLimit) + ")");
+            }
+            stack_.resize(std::max<std::size_t>(info.maxStackDepth, 1));
+            data_.resize(info.dataSlots);
+        }
+        calls_.resize(kMaxCallDepth);
+        output_.reserve(kOutputFlush + 32);
+    }
+
+    /// @brief Nome da configurao, ex.: `int32_t/unchecked`.
+    [[nodiscard]] static std::string name() {
+        return std::string(sizeof(Value) == 4 ? "int32_t" : "int64_t") + "/" + std::string(Checks::kName);
+    }
+
+    /**
+     * @brief Executa o programa desde o endereo 0 at `HALT`, com a pilha vazia.
+     *
+     * @param out Destino de `PRINT` (um valor por linha).
+     * @return Nmero de instrues executadas.
+     * @throws VMError Em erros de execuo; a sada produzida at o erro  descarregada antes.
+     */
+    std::uint64_t run(std::ostream& out) {
+        output_.clear();
+        std::fill(data_.begin(), data_.end(), Value{ 0 });
+        try {
+            const std::uint64_t steps = execute(out);
+            flush(out);
+            return steps;
+        }
+        catch (...) {
+            flush(out);
+            throw;
+        }
+    }
+
+private:
+    std::span<const Byte> code_;
+    Endianness endianness_;
+    std::vector<Value> stack_;
+    std::vector<Value> data_;     ///< Segmento de dados de `LOAD`/`STORE`.
+    std::vector<Address> calls_;  ///< Pilha de retorno de `CALL`/`RET`.
+    std::string output_;
+
+    [[nodiscard]] static Value add(Value a, Value b) noexcept { return wrap_add(a, b); }
+    [[nodiscard]] static Value sub(Value a, Value b) noexcept { return wrap_sub(a, b); }
+    [[nodiscard]] static Value mul(Value a, Value b) noexcept { return wrap_mul(a, b); }
+
+    /// @brief Diviso truncada; `MIN / -1` d a volta para `MIN`, como as demais operaes.
+    [[nodiscard]] static Value div(Value a, Value b) {
+        if (b == 0) throw VMError("Diviso por zero");
+        return wrap_div(a, b);
+    }
+
+    void print(Value v, std::ostream& out) {
+        char text[24];
+        const auto [end, ec] = std::to_chars(text, text + sizeof(text) - 1, v);
+        *end = '\n';
+        output_.append(text, end + 1);
+        if (output_.size() >= kOutputFlush) flush(out);
+    }
+
+    void flush(std::ostream& out) {
+        if (output_.empty()) return;
+        out.write(output_.data(), static_cast<std::streamsize>(output_.size()));
+        output_.clear();
+    }
+
+    [[noreturn]] static void underflow(Opcode op, std::ptrdiff_t needed, std::ptrdiff_t available) {
+        std::ostringstream oss;
+        oss << "Pilha insuficiente para " << opcode_name(op)
+            << " (necessrio: " << needed << ", disponvel: " << available << ")";
+        throw VMError(oss.str());
+    }
+
+    [[noreturn]] static void invalidOpcode(Address at, Byte raw) {
+        std::ostringstream oss;
+        oss << "Opcode invlido lido em IP=" << at << " : 0x"
+            << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(raw);
+        throw VMError(oss.str());
+    }
+
+    /**
+     * @brief Lao de execuo; com `Unchecked` todos os `if constexpr (kRuntimeChecks)` somem.
+     */
+    std::uint64_t execute(std::ostream& out) {
+        const Byte* const code = code_.data();
+        const Address size = code_.size();
+        Value* const base = stack_.data();
+        Value* const limit = base + stack_.size();
+        Value* sp = base; // prxima posio livre
+        Value* const data = data_.data();
+        const std::size_t dataSize = data_.size();
+        Address* const calls = calls_.data();
+        std::size_t callDepth = 0;
+        Address ip = 0;
+        std::uint64_t steps = 0;
+
+        auto need = [&](Opcode op, std::ptrdiff_t n) {
+            if constexpr (kRuntimeChecks) {
+                if (sp - base < n) underflow(op, n, sp - base);
+            }
+        };
+        auto room = [&] {
+            if constexpr (kRuntimeChecks) {
+                if (sp == limit) throw VMError("Pilha cheia: limite de " + std::to_string(stack_.size()) + " valores");
+            }
+        };
+        auto operand = [&](Opcode op) {
+            if constexpr (kRuntimeChecks) {
+                if (ip + operand_size(op) > size) {
+                    throw VMError(std::string(opcode_name(op)) + ": operando fora dos limites em IP=" + std::to_string(ip - 1));
+                }
+            }
+        };
+        auto word = [&] {
+            const Word16 w = decode_word(code[ip], code[ip + 1], endianness_);
+            ip += 2;
+            return w;
+        };
+        auto wide = [&]<typename T>(std::type_identity<T>) {
+            const T v = decode_operand<T>(code + ip, endianness_);
+            ip += sizeof(T);
+            return v;
+        };
+        auto target32 = [&] { return static_cast<Address>(wide(std::type_identity<std::uint32_t>{})); };
+        auto slot = [&](Opcode op) -> Value& {
+            const Word16 k = word();
+            if constexpr (kRuntimeChecks) {
+                if (k >= dataSize) {
+                    throw VMError(std::string(opcode_name(op)) + ": clula " + std::to_string(k)
+                        + " fora do segmento de dados (" + std::to_string(dataSize) + " clulas)");
+                }
+            }
+            return data[k];
+        };
+        auto jump = [&](Opcode op, Address target) {
+            if constexpr (kRuntimeChecks) {
+                if (target >= size) throw VMError(std::string(opcode_name(op)) + ": endereo invlido: " + std::to_string(target));
+            }
+            ip = target;
+        };
+
+#if VM_HAS_COMPUTED_GOTO
+        std::array<void*, 256> table;
+        table.fill(&&op_invalid);
+        table[static_cast<Byte>(Opcode::HALT)] = &&op_HALT;
+        table[static_cast<Byte>(Opcode::PUSH)] = &&op_PUSH;
+        table[static_cast<Byte>(Opcode::POP)] = &&op_POP;
+        table[static_cast<Byte>(Opcode::ADD)] = &&op_ADD;
+        table[static_cast<Byte>(Opcode::SUB)] = &&op_SUB;
+        table[static_cast<Byte>(Opcode::MUL)] = &&op_MUL;
+        table[static_cast<Byte>(Opcode::DIV)] = &&op_DIV;
+        table[static_cast<Byte>(Opcode::PRINT)] = &&op_PRINT;
+        table[static_cast<Byte>(Opcode::DUP)] = &&op_DUP;
+        table[static_cast<Byte>(Opcode::SWAP)] = &&op_SWAP;
+        table[static_cast<Byte>(Opcode::PUSH16)] = &&op_PUSH16;
+        table[static_cast<Byte>(Opcode::JMP)] = &&op_JMP;
+        table[static_cast<Byte>(Opcode::JZ)] = &&op_JZ;
+        table[static_cast<Byte>(Opcode::PUSH32)] = &&op_PUSH32;
+        table[static_cast<Byte>(Opcode::PUSH64)] = &&op_PUSH64;
+        table[static_cast<Byte>(Opcode::LOAD)] = &&op_LOAD;
+        table[static_cast<Byte>(Opcode::STORE)] = &&op_STORE;
+        table[static_cast<Byte>(Opcode::JLT)] = &&op_JLT;
+        table[static_cast<Byte>(Opcode::JNZ)] = &&op_JNZ;
+        table[static_cast<Byte>(Opcode::CALL)] = &&op_CALL;
+        table[static_cast<Byte>(Opcode::RET)] = &&op_RET;
+        table[static_cast<Byte>(Opcode::JMP32)] = &&op_JMP32;
+        table[static_cast<Byte>(Opcode::JZ32)] = &&op_JZ32;
+
+#define VM_CORE_OP(name) op_##name
+#define VM_CORE_NEXT()                                                                     \
+        do {                                                                               \
+            if constexpr (kRuntimeChecks) {                                                \
+                if (ip >= size) throw VMError("IP fora dos limites da memria: " + std::to_string(ip)); \
+            }                                                                              \
+            ++steps;                                                                       \
+            goto *table[code[ip++]];                                                       \
+        } while (0)
+
+        VM_CORE_NEXT();
+        {
+#else
+#define VM_CORE_OP(name) case Opcode::name
+#define VM_CORE_NEXT() continue
+
+        for (;;) {
+            if constexpr (kRuntimeChecks) {
+                if (ip >= size) throw VMError("IP fora dos limites da memria: " + std::to_string(ip));
+            }
+            ++steps;
+            switch (static_cast<Opcode>(code[ip++])) {
+#endif
+        VM_CORE_OP(HALT):
+            return steps;
+        VM_CORE_OP(PUSH):
+            operand(Opcode::PUSH);
+            room();
+            *sp++ = static_cast<Value>(code[ip++]);
+            VM_CORE_NEXT();
+        VM_CORE_OP(POP):
+            need(Opcode::POP, 1);
+            --sp;
+            VM_CORE_NEXT();
+        VM_CORE_OP(ADD):
+            need(Opcode::ADD, 2);
+            --sp;
+            sp[-1] = add(sp[-1], sp[0]);
+            VM_CORE_NEXT();
+        VM_CORE_OP(SUB):
+            need(Opcode::SUB, 2);
+            --sp;
+            sp[-1] = sub(sp[-1], sp[0]);
+            VM_CORE_NEXT();
+        VM_CORE_OP(MUL):
+            need(Opcode::MUL, 2);
+            --sp;
+            sp[-1] = mul(sp[-1], sp[0]);
+            VM_CORE_NEXT();
+        VM_CORE_OP(DIV):
+            need(Opcode::DIV, 2);
+            --sp;
+            sp[-1] = div(sp[-1], sp[0]);
+            VM_CORE_NEXT();
+        VM_CORE_OP(PRINT):
+            need(Opcode::PRINT, 1);
+            print(*--sp, out);
+            VM_CORE_NEXT();
+        VM_CORE_OP(DUP):
+            need(Opcode::DUP, 1);
+            room();
+            *sp = sp[-1];
+            ++sp;
+            VM_CORE_NEXT();
+        VM_CORE_OP(SWAP):
+            need(Opcode::SWAP, 2);
+            std::swap(sp[-1], sp[-2]);
+            VM_CORE_NEXT();
+        VM_CORE_OP(PUSH16):
+            operand(Opcode::PUSH16);
+            room();
+            *sp++ = static_cast<Value>(word());
+            VM_CORE_NEXT();
+        VM_CORE_OP(JMP):
+            operand(Opcode::JMP);
+            jump(Opcode::JMP, word());
+            VM_CORE_NEXT();
+        VM_CORE_OP(JZ): {
+            operand(Opcode::JZ);
+            const Word16 target = word();
+            need(Opcode::JZ, 1);
+            if (*--sp == 0) jump(Opcode::JZ, target);
+            VM_CORE_NEXT();
+        }
+        VM_CORE_OP(PUSH32):
+            operand(Opcode::PUSH32);
+            room();
+            *sp++ = static_cast<Value>(wide(std::type_identity<std::int32_t>{}));
+            VM_CORE_NEXT();
+        VM_CORE_OP(PUSH64):
+            operand(Opcode::PUSH64);
+            room();
+            *sp++ = static_cast<Value>(wide(std::type_identity<std::int64_t>{}));
+            VM_CORE_NEXT();
+        VM_CORE_OP(LOAD): {
+            operand(Opcode::LOAD);
+            room();
+            const Value v = slot(Opcode::LOAD);
+            *sp++ = v;
+            VM_CORE_NEXT();
+        }
+        VM_CORE_OP(STORE): {
+            operand(Opcode::STORE);
+            Value& cell = slot(Opcode::STORE);
+            need(Opcode::STORE, 1);
+            cell = *--sp;
+            VM_CORE_NEXT();
+        }
+        VM_CORE_OP(JLT): {
+            operand(Opcode::JLT);
+            const Address target = target32();
+            need(Opcode::JLT, 2);
+            sp -= 2;
+            if (sp[0] < sp[1]) jump(Opcode::JLT, target);
+            VM_CORE_NEXT();
+        }
+        VM_CORE_OP(JNZ): {
+            operand(Opcode::JNZ);
+            const Address target = target32();
+            need(Opcode::JNZ, 1);
+            if (*--sp != 0) jump(Opcode::JNZ, target);
+            VM_CORE_NEXT();
+        }
+        VM_CORE_OP(CALL): {
+            operand(Opcode::CALL);
+            const Address target = target32();
+            if (callDepth == kMaxCallDepth) {
+                throw VMError("Pilha de chamadas cheia: limite de " + std::to_string(kMaxCallDepth) + " CALLs aninhados");
+            }
+            calls[callDepth++] = ip;
+            jump(Opcode::CALL, target);
+            VM_CORE_NEXT();
+        }
+        VM_CORE_OP(RET):
+            if constexpr (kRuntimeChecks) {
+                if (callDepth == 0) throw VMError("RET sem CALL correspondente em IP=" + std::to_string(ip - 1));
+            }
+            ip = calls[--callDepth];
+            VM_CORE_NEXT();
+        VM_CORE_OP(JMP32):
+            operand(Opcode::JMP32);
+            jump(Opcode::JMP32, target32());
+            VM_CORE_NEXT();
+        VM_CORE_OP(JZ32): {
+            operand(Opcode::JZ32);
+            const Address target = target32();
+            need(Opcode::JZ32, 1);
+            if (*--sp == 0) jump(Opcode::JZ32, target);
+            VM_CORE_NEXT();
+        }
+#if VM_HAS_COMPUTED_GOTO
+        }
+    op_invalid:
+        --ip;
+        invalidOpcode(ip, code[ip]);
+#else
+            default:
+                --ip;
+                invalidOpcode(ip, code[ip]);
+            }
+        }
+#endif
+#undef VM_CORE_OP
+#undef VM_CORE_NEXT
+    }
+};
+
+// =========================== Helpers para montagem de bytecode ===========================
+
+/**
+ * @namespace assembler
+ * @brief Funes auxiliares para facilitar a construo manual de programas (bytecode).
+ *
+ * Fornece uma abstrao simples sobre o `std::vector<Byte>` para evitar inseres manuais propensas a erro.
+ */
+namespace assembler {
+    /**
+     * @brief Insere um opcode no vetor de bytecode.
+     */
+    inline void emit(std::vector<Byte>& out, Opcode op) {
+        out.push_back(static_cast<Byte>(op));
+    }
+
+    /**
+     * @brief Emite a instruo `PUSH` seguida de um valor de 8 bits.
+     */
+    inline void emit_push(std::vector<Byte>& out, Byte value) {
+        emit(out, Opcode::PUSH);
+        out.push_back(value);
+    }
+
+    /**
+     * @brief Emite a instruo `PUSH16` seguida de um valor de 16 bits (Big-Endian).
+     */
+    inline void emit_push16_be(std::vector<Byte>& out, Word16 value) {
+        emit(out, Opcode::PUSH16);
+        out.push_back(static_cast<Byte>((value >> 8) & 0xFF));
+        out.push_back(static_cast<Byte>(value & 0xFF));
+    }
+
+    /**
+     * @brief Emite a instruo `JMP` (salto incondicional) com endereo Big-Endian.
+     */
+    inline void emit_jmp_be(std::vector<Byte>& out, Word16 addr) {
+        emit(out, Opcode::JMP);
+        out.push_back(static_cast<Byte>((addr >> 8) & 0xFF));
+        out.push_back(static_cast<Byte>(addr & 0xFF));
+    }
+
+    /**
+     * @brief Emite a instruo `JZ` (salto se zero) com endereo Big-Endian.
+     */
+    inline void emit_jz_be(std::vector<Byte>& out, Word16 addr) {
+        emit(out, Opcode::JZ);
+        out.push_back(static_cast<Byte>((addr >> 8) & 0xFF));
+        out.push_back(static_cast<Byte>(addr & 0xFF));
+    }
+
+    /**
+     * @brief Emite `op` seguido de um operando de `bytes` bytes em Big-Endian.
+     */
+    inline void emit_operand_be(std::vector<Byte>& out, Opcode op, std::uint64_t value, std::size_t bytes) {
+        emit(out, op);
+        for (std::size_t i = bytes; i-- > 0;) out.push_back(static_cast<Byte>((value >> (8 * i)) & 0xFF));
+    }
+
+    /**
+     * @brief Emite a instruo `PUSH32` seguida de um valor de 32 bits com sinal (Big-Endian).
+     */
+    inline void emit_push32_be(std::vector<Byte>& out, std::int32_t value) {
+        emit_operand_be(out, Opcode::PUSH32, static_cast<std::uint32_t>(value), 4);
+    }
+
+    /**
+     * @brief Emite a instruo `PUSH64` seguida de um valor de 64 bits com sinal (Big-Endian).
+     */
+    inline void emit_push64_be(std::vector<Byte>& out, std::int64_t value) {
+        emit_operand_be(out, Opcode::PUSH64, static_cast<std::uint64_t>(value), 8);
+    }
+
+    /**
+     * @brief Emite `LOAD` (empilha a clula `slot` do segmento de dados).
+     */
+    inline void emit_load_be(std::vector<Byte>& out, Word16 slot) {
+        emit_operand_be(out, Opcode::LOAD, slot, 2);
+    }
+
+    /**
+     * @brief Emite `STORE` (desempilha para a clula `slot` do segmento de dados).
+     */
+    inline void emit_store_be(std::vector<Byte>& out, Word16 slot) {
+        emit_operand_be(out, Opcode::STORE, slot, 2);
+    }
+
+    /**
+     * @brief Emite um desvio com alvo de 32 bits (`JLT`, `JNZ`, `CALL`, `JMP32` ou `JZ32`) em Big-Endian.
+     */
+    inline void emit_branch32_be(std::vector<Byte>& out, Opcode op, std::uint32_t addr) {
+        emit_operand_be(out, op, addr, 4);
+    }
+
+    /**
+     * @brief Reescreve, em Big-Endian, o operando de 32 bits que comea em `pos` (alvo de `emit_branch32_be`).
+     */
+    inline void patch_dword_be(std::vector<Byte>& out, std::size_t pos, std::uint32_t value) {
+        for (std::size_t i = 0; i < 4; ++i) out.at(pos + i) = static_cast<Byte>((value >> (8 * (3 - i))) & 0xFF);
+    }
+
+    /**
+     * @brief Reescreve, em Big-Endian, o operando de 16 bits que comea em `pos`.
+     *
+     * Usado para resolver saltos para frente: emite-se o salto com endereo 0 e, quando o destino
+     * for conhecido, corrige-se o operando.
+     */
+    inline void patch_word_be(std::vector<Byte>& out, std::size_t pos, Word16 value) {
+        out.at(pos) = static_cast<Byte>((value >> 8) & 0xFF);
+        out.at(pos + 1) = static_cast<Byte>(value & 0xFF);
+    }
+
+    /**
+     * @brief Monta um programa a partir de texto (assembly da VM).
+     *
+     * Sintaxe, uma instruo por linha:
+     * - mnemnicos de `Opcode` (`PUSH 10`, `PUSH16 300`, `ADD`, `JZ fim`...), sem distino de caixa;
+     * - `rotulo:` define um rtulo (pode preceder uma instruo na mesma linha);
+     * - operandos decimais ou hexadecimais (`0x1F`); `PUSH32`/`PUSH64` aceitam valores negativos;
+     * - saltos e `CALL` aceitam rtulos ou endereos (`JMP`/`JZ` s at 64 KiB; alm disso,
+     *   `JMP32`/`JZ32`);
+     * - `;` ou `#` iniciam um comentrio at o fim da linha.
+     *
+     * Os operandos so emitidos em Big-Endian, como nos demais helpers.
+     *
+     * @param source Texto do programa.
+     * @return Bytecode.
+     * @throws VMError Com o nmero da linha, para mnemnicos, operandos ou rtulos invlidos.
+     */
+    [[nodiscard]] inline std::vector<Byte> assemble_text(std::string_view source) {
+        struct Line { std::size_t number; Opcode op; std::string operand; };
+        std::vector<Line> lines;
+        std::vector<std::pair<std::string, std::size_t>> labels; // nome -> endereo
+        std::size_t address = 0;
+
+        auto fail = [](std::size_t number, const std::string& why) {
+            return VMError("Assembler: linha " + std::to_string(number) + ": " + why);
+        };
+        auto upper = [](std::string text) {
+            for (char& c : text) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            return text;
+        };
+
+        // 1 passada: rtulos e endereos.
+        std::size_t number = 0;
+        for (std::size_t begin = 0; begin <= source.size();) {
+            const std::size_t end = std::min(source.find('\n', begin), source.size());
+            std::string_view text = source.substr(begin, end - begin);
+            begin = end + 1;
+            ++number;
+            text = text.substr(0, std::min(text.find(';'), text.find('#')));
+
+            std::istringstream in{ std::string(text) };
+            std::string word;
+            if (!(in >> word)) continue;
+            if (word.back() == ':') {
+                word.pop_back();
+                if (word.empty()) throw fail(number, "rtulo vazio");
+                for (const auto& [name, at] : labels) {
+                    if (name == word) throw fail(number, "rtulo repetido: " + word);
+                }
+                labels.emplace_back(word, address);
+                if (!(in >> word)) continue;
+            }
+
+            const std::string mnemonic = upper(word);
+            const auto found = std::find_if(kValidOpcodes.begin(), kValidOpcodes.end(),
+                [&](Byte op) { return opcode_name(static_cast<Opcode>(op)) == mnemonic; });
+            if (found == kValidOpcodes.end()) throw fail(number, "mnemnico desconhecido: " + word);
+
+            Line line{ number, static_cast<Opcode>(*found), {} };
+            const bool hasOperand = operand_size(line.op) != 0;
+            if (hasOperand && !(in >> line.operand)) throw fail(number, mnemonic + " exige um operando");
+            std::string extra;
+            if (in >> extra) throw fail(number, "texto inesperado: " + extra);
+            address += 1 + operand_size(line.op);
+            lines.push_back(std::move(line));
+        }
+
+        // 2 passada: emisso.
+        auto number_of = [&](const Line& line, std::int64_t min, std::int64_t max) -> std::int64_t {
+            const std::string& t = line.operand;
+            const bool negative = !t.empty() && t[0] == '-';
+            const std::size_t skip = negative ? 1 : 0;
+            const bool hex = t.size() > skip + 2 && t[skip] == '0' && (t[skip + 1] == 'x' || t[skip + 1] == 'X');
+            std::uint64_t magnitude = 0;
+            const char* first = t.data() + skip + (hex ? 2 : 0);
+            const auto [ptr, ec] = std::from_chars(first, t.data() + t.size(), magnitude, hex ? 16 : 10);
+            if (ec == std::errc{} && ptr == t.data() + t.size() && ptr != first) {
+                const auto range = "operando fora do intervalo " + std::to_string(min) + ".." + std::to_string(max) + ": " + t;
+                if (negative) {
+                    if (magnitude > 0 - static_cast<std::uint64_t>(min)) throw fail(line.number, range);
+                    return static_cast<std::int64_t>(0 - magnitude);
+                }
+                // PUSH64 0x8000000000000000...: padro de bits em hexadecimal.
+                if (hex && line.op == Opcode::PUSH64) return static_cast<std::int64_t>(magnitude);
+                if (magnitude > static_cast<std::uint64_t>(max)) throw fail(line.number, range);
+                return static_cast<std::int64_t>(magnitude);
+            }
+            if (is_branch(line.op)) {
+                for (const auto& [name, at] : labels) {
+                    if (name == t) {
+                        if (at > static_cast<std::uint64_t>(max)) {
+                            throw fail(line.number, "rtulo alm de 64 KiB: " + t + " (use JMP32/JZ32)");
+                        }
+                        return static_cast<std::int64_t>(at);
+                    }
+                }
+                throw fail(line.number, "rtulo indefinido: " + t);
+            }
+            throw fail(line.number, "operando invlido: " + t);
+        };
+
+        std::vector<Byte> out;
+        out.reserve(address);
+        for (const Line& line : lines) {
+            switch (line.op) {
+            case Opcode::PUSH:   emit_push(out, static_cast<Byte>(number_of(line, 0, 0xFF))); break;
+            case Opcode::PUSH16: emit_push16_be(out, static_cast<Word16>(number_of(line, 0, 0xFFFF))); break;
+            case Opcode::JMP:    emit_jmp_be(out, static_cast<Word16>(number_of(line, 0, 0xFFFF))); break;
+            case Opcode::JZ:     emit_jz_be(out, static_cast<Word16>(number_of(line, 0, 0xFFFF))); break;
+            case Opcode::LOAD:   emit_load_be(out, static_cast<Word16>(number_of(line, 0, 0xFFFF))); break;
+            case Opcode::STORE:  emit_store_be(out, static_cast<Word16>(number_of(line, 0, 0xFFFF))); break;
+            case Opcode::PUSH32:
+                emit_push32_be(out, static_cast<std::int32_t>(number_of(line, INT32_MIN, INT32_MAX)));
+                break;
+            case Opcode::PUSH64:
+                emit_push64_be(out, number_of(line, INT64_MIN, INT64_MAX));
+                break;
+            case Opcode::JLT:
+            case Opcode::JNZ:
+            case Opcode::CALL:
+            case Opcode::JMP32:
+            case Opcode::JZ32:
+                emit_branch32_be(out, line.op, static_cast<std::uint32_t>(number_of(line, 0, UINT32_MAX)));
+                break;
+            default:             emit(out, line.op); break;
+            }
+        }
+        return out;
+    }
+}
+
+// =========================== Programas de Teste ===========================
+
+/**
+ * @brief Cria um programa de teste aritmtico simples.
+ *
+ * Lgica: $(10 + 5) \times 2 = 30$.
+ *
+ * @return Bytecode do programa.
+ */
+inline std::vector<Byte> make_program1() {
+    // Programa 1: (10 + 5) * 2 -> imprime 30
+    // PUSH 10; PUSH 5; ADD; PUSH 2; MUL; PRINT; HALT
+    std::vector<Byte> p;
+    assembler::emit_push(p, 10);
+    assembler::emit_push(p, 5);
+    assembler::emit(p, Opcode::ADD);
+    assembler::emit_push(p, 2);
+    assembler::emit(p, Opcode::MUL);
+    assembler::emit(p, Opcode::PRINT);
+    assembler::emit(p, Opcode::HALT);
+    return p;
+}
+
+/**
+ * @brief Cria um programa de teste com loops e condicionais.
+ *
+ * Lgica: Contagem regressiva de 3 at 1.
+ * Utiliza manipulao de pilha (`DUP`) e saltos (`JZ`, `JMP`).
+ *
+ * @return Bytecode do programa.
+ */
+inline std::vector<Byte> make_program2_countdown() {
+    // Programa 2: contagem regressiva de 3 a 1 usando DUP, JZ, JMP
+    // Endereos calculados manualmente para clareza (big-endian)
+    // layout:
+    // 00: PUSH 3
+    // 02: DUP
+    // 03: PRINT
+    // 04: PUSH 1
+    // 06: SUB
+    // 07: DUP
+    // 08: JZ 0x000E
+    // 11: JMP 0x0002
+    // 14: POP
+    // 15: HALT
+
+    std::vector<Byte> p;
+    assembler::emit_push(p, 3);           // 00,01
+
+    assembler::emit(p, Opcode::DUP);     // 02
+    assembler::emit(p, Opcode::PRINT);   // 03
+    assembler::emit_push(p, 1);          // 04,05
+    assembler::emit(p, Opcode::SUB);     // 06
+    assembler::emit(p, Opcode::DUP);     // 07
+
+    // JZ -> endereo 0x000E (decimal 14, o POP). colocamos big-endian 00 0E
+    assembler::emit_jz_be(p, static_cast<Word16>(0x000E)); // 08,09,10
+
+    // JMP -> endereo 0x0002
+    assembler::emit_jmp_be(p, static_cast<Word16>(0x0002)); // 11,12,13
+
+    assembler::emit(p, Opcode::POP);     // 14
+    assembler::emit(p, Opcode::HALT);    // 15
+
+    return p;
+}
+
+/**
+ * @brief Emite dois laos aninhados, executando `body` a cada iterao do lao interno.
+ *
+ * O contador do lao interno fica no topo da pilha enquanto `body` executa; `body` deve
+ * preservar a pilha (efeito lquido zero).
+ *
+ * @param outer Nmero de iteraes do lao externo.
+ * @param inner Nmero de iteraes do lao interno.
+ * @param body Funo que emite o corpo do lao interno.
+ * @return Bytecode do programa.
+ */
+template <typename Body>
+inline std::vector<Byte> make_nested_loop(Word16 outer, Word16 inner, Body body) {
+    std::vector<Byte> p;
+    assembler::emit_push16_be(p, outer);                       // [o]
+
+    const auto outerLoop = static_cast<Word16>(p.size());
+    assembler::emit_push16_be(p, inner);                       // [o, i]
+
+    const auto innerLoop = static_cast<Word16>(p.size());
+    body(p);
+    assembler::emit_push(p, 1);
+    assembler::emit(p, Opcode::SUB);                           // [o, i-1]
+    assembler::emit(p, Opcode::DUP);
+    const std::size_t jzInner = p.size() + 1;
+    assembler::emit_jz_be(p, 0);                               // i-1 == 0 -> fim do lao interno
+    assembler::emit_jmp_be(p, innerLoop);
+
+    assembler::patch_word_be(p, jzInner, static_cast<Word16>(p.size()));
+    assembler::emit(p, Opcode::POP);                           // [o]
+    assembler::emit_push(p, 1);
+    assembler::emit(p, Opcode::SUB);                           // [o-1]
+    assembler::emit(p, Opcode::DUP);
+    const std::size_t jzOuter = p.size() + 1;
+    assembler::emit_jz_be(p, 0);
+    assembler::emit_jmp_be(p, outerLoop);
+
+    assembler::patch_word_be(p, jzOuter, static_cast<Word16>(p.size()));
+    assembler::emit(p, Opcode::POP);
+    assembler::emit(p, Opcode::HALT);
+    return p;
+}
+
+/**
+ * @brief Cria um programa de lao longo (dois laos aninhados), sem impresso, para benchmarks.
+ *
+ * O lao interno executa 5 instrues por iterao (`PUSH 1; SUB; DUP; JZ; JMP`),
+ * de modo que o custo do despacho domina o tempo de execuo.
+ *
+ * @param outer Nmero de iteraes do lao externo.
+ * @param inner Nmero de iteraes do lao interno.
+ * @return Bytecode do programa.
+ */
+inline std::vector<Byte> make_program_loop(Word16 outer, Word16 inner) {
+    return make_nested_loop(outer, inner, [](std::vector<Byte>&) {});
+}
+
+/**
+ * @brief Cria um programa dominado por aritmtica: $((7 + 5) \times 3 - 2) / 4$ a cada iterao.
+ *
+ * Dos 15 opcodes por iterao do lao interno, 10 so `PUSH`/aritmtica, o que expe o custo
+ * de `binaryOp` e das operaes de pilha.
+ *
+ * @param outer Nmero de iteraes do lao externo.
+ * @param inner Nmero de iteraes do lao interno.
+ * @return Bytecode do programa.
+ */
+inline std::vector<Byte> make_program_arith(Word16 outer, Word16 inner) {
+    return make_nested_loop(outer, inner, [](std::vector<Byte>& p) {
+        assembler::emit_push(p, 7);
+        assembler::emit_push(p, 5);
+        assembler::emit(p, Opcode::ADD);
+        assembler::emit_push(p, 3);
+        assembler::emit(p, Opcode::MUL);
+        assembler::emit_push(p, 2);
+        assembler::emit(p, Opcode::SUB);
+        assembler::emit_push(p, 4);
+        assembler::emit(p, Opcode::DIV);
+        assembler::emit(p, Opcode::POP);
+        });
+}
+
+/**
+ * @brief Cria o lao de `make_program_loop` com os opcodes largos: 4 despachos por iterao em vez de 5.
+ *
+ * `PUSH32` carrega contadores de at $2^{31}-1$ e `JNZ` fecha o lao interno sem o par `JZ`/`JMP`:
+ * `PUSH 1; SUB; DUP; JNZ`.
+ *
+ * @param outer Nmero de iteraes do lao externo.
+ * @param inner Nmero de iteraes do lao interno.
+ * @return Bytecode do programa.
+ */
+inline std::vector<Byte> make_program_loop_jnz(std::int32_t outer, std::int32_t inner) {
+    std::vector<Byte> p;
+    assembler::emit_push32_be(p, outer);                       // [o]
+    const auto outerLoop = static_cast<std::uint32_t>(p.size());
+    assembler::emit_push32_be(p, inner);                       // [o, i]
+    const auto innerLoop = static_cast<std::uint32_t>(p.size());
+    assembler::emit_push(p, 1);
+    assembler::emit(p, Opcode::SUB);
+    assembler::emit(p, Opcode::DUP);
+    assembler::emit_branch32_be(p, Opcode::JNZ, innerLoop);    // [o, 0] ao sair
+    assembler::emit(p, Opcode::POP);
+    assembler::emit_push(p, 1);
+    assembler::emit(p, Opcode::SUB);
+    assembler::emit(p, Opcode::DUP);
+    assembler::emit_branch32_be(p, Opcode::JNZ, outerLoop);
+    assembler::emit(p, Opcode::POP);
+    assembler::emit(p, Opcode::HALT);
+    return p;
+}
+
+/**
+ * @brief Cria um programa que acumula no segmento de dados: soma o contador do lao interno em `data[0]`.
+ *
+ * Corpo do lao interno: `DUP; LOAD 0; ADD; STORE 0`, e ao final imprime a soma, $outer \cdot inner(inner+1)/2$.
+ *
+ * @param outer Nmero de iteraes do lao externo.
+ * @param inner Nmero de iteraes do lao interno.
+ * @return Bytecode do programa.
+ */
+inline std::vector<Byte> make_program_memory(std::int32_t outer, std::int32_t inner) {
+    std::vector<Byte> p;
+    assembler::emit_push32_be(p, outer);
+    const auto outerLoop = static_cast<std::uint32_t>(p.size());
+    assembler::emit_push32_be(p, inner);
+    const auto innerLoop = static_cast<std::uint32_t>(p.size());
+    assembler::emit(p, Opcode::DUP);
+    assembler::emit_load_be(p, 0);
+    assembler::emit(p, Opcode::ADD);
+    assembler::emit_store_be(p, 0);                            // data[0] += i
+    assembler::emit_push(p, 1);
+    assembler::emit(p, Opcode::SUB);
+    assembler::emit(p, Opcode::DUP);
+    assembler::emit_branch32_be(p, Opcode::JNZ, innerLoop);
+    assembler::emit(p, Opcode::POP);
+    assembler::emit_push(p, 1);
+    assembler::emit(p, Opcode::SUB);
+    assembler::emit(p, Opcode::DUP);
+    assembler::emit_branch32_be(p, Opcode::JNZ, outerLoop);
+    assembler::emit(p, Opcode::POP);
+    assembler::emit_load_be(p, 0);
+    assembler::emit(p, Opcode::PRINT);
+    assembler::emit(p, Opcode::HALT);
+    return p;
+}
+
+/**
+ * @brief Cria um programa com uma sub-rotina chamada a cada iterao do lao interno.
+ *
+ * O lao conta de 0 at `count` com `JLT` e chama `acumula` (`DUP; DUP; MUL; LOAD 0; ADD; STORE 0; RET`),
+ * que soma $i^2$ em `data[0]`; ao final imprime a soma. Mede o custo de `CALL`/`RET`.
+ *
+ * @param count Nmero de iteraes (e de chamadas).
+ * @return Bytecode do programa.
+ */
+inline std::vector<Byte> make_program_call(std::int32_t count) {
+    std::vector<Byte> p;
+    assembler::emit_push(p, 0);                                // [i]
+    const auto loop = static_cast<std::uint32_t>(p.size());
+    const std::size_t call = p.size() + 1;
+    assembler::emit_branch32_be(p, Opcode::CALL, 0);
+    assembler::emit_push(p, 1);
+    assembler::emit(p, Opcode::ADD);                           // [i+1]
+    assembler::emit(p, Opcode::DUP);
+    assembler::emit_push32_be(p, count);
+    assembler::emit_branch32_be(p, Opcode::JLT, loop);         // i+1 < count -> repete
+    assembler::emit(p, Opcode::POP);
+    assembler::emit_load_be(p, 0);
+    assembler::emit(p, Opcode::PRINT);
+    assembler::emit(p, Opcode::HALT);
+
+    assembler::patch_dword_be(p, call, static_cast<std::uint32_t>(p.size()));
+    assembler::emit(p, Opcode::DUP);                           // acumula: [i] -> [i]
+    assembler::emit(p, Opcode::DUP);
+    assembler::emit(p, Opcode::MUL);
+    assembler::emit_load_be(p, 0);
+    assembler::emit(p, Opcode::ADD);
+    assembler::emit_store_be(p, 0);
+    assembler::emit(p, Opcode::RET);
+    return p;
+}
+
+/**
+ * @brief Gera um programa aleatrio aprovado pelo verificador (usado nos testes diferenciais).
+ *
+ * As instrues so sorteadas respeitando a profundidade da pilha, de modo que no h
+ * *underflow* no caminho linear. Os saltos so sempre para frente (o programa sempre termina)
+ * e seus alvos so sorteados entre os incios de instruo seguintes; quando um alvo produz
+ * profundidades diferentes em um ponto de juno, o verificador rejeita o programa e outro 
+ * sorteado. H no mximo um `CALL`, para uma sub-rotina fixa posta depois do `HALT` final
+ * (`LOAD 3; PUSH 1; ADD; DUP; PRINT; STORE 3; RET`), e `LOAD`/`STORE` usam as clulas 0 a 3.
+ *
+ * @param rng Gerador de nmeros aleatrios.
+ * @param instrucoes Nmero mximo de instrues antes do `HALT` final.
+ * @return Bytecode (big-endian) de um programa vlido.
+ */
+inline std::vector<Byte> make_random_program(std::mt19937_64& rng, std::size_t instrucoes) {
+    auto sorteio = [&](std::size_t n) { return static_cast<std::size_t>(rng() % n); };
+    for (;;) {
+        std::vector<Byte> p;
+        std::vector<std::size_t> inicios;             // incio de cada instruo
+        std::vector<std::pair<std::size_t, bool>> saltos; // posio do operando de cada salto; `true` = 32 bits
+        std::size_t chamada = 0;                      // posio do operando do CALL (0 = nenhum)
+        int profundidade = 0;
+        const std::size_t n = 1 + sorteio(instrucoes);
+        for (std::size_t i = 0; i < n; ++i) {
+            inicios.push_back(p.size());
+            const std::size_t k = sorteio(profundidade >= 2 ? 21 : profundidade == 1 ? 15 : 8);
+            const auto salto32 = [&](Opcode op) {
+                saltos.emplace_back(p.size() + 1, true);
+                assembler::emit_branch32_be(p, op, 0);
+            };
+            switch (k) {
+            // profundidade >= 0
+            case 0: assembler::emit_push(p, static_cast<Byte>(sorteio(8))); ++profundidade; break;
+            case 1: assembler::emit_push16_be(p, static_cast<Word16>(rng())); ++profundidade; break;
+            case 2: saltos.emplace_back(p.size() + 1, false); assembler::emit_jmp_be(p, 0); break;
+            case 3: assembler::emit_push32_be(p, static_cast<std::int32_t>(rng())); ++profundidade; break;
+            case 4: assembler::emit_push64_be(p, static_cast<std::int64_t>(rng())); ++profundidade; break;
+            case 5: assembler::emit_load_be(p, static_cast<Word16>(sorteio(4))); ++profundidade; break;
+            case 6: salto32(Opcode::JMP32); break;
+            case 7:
+                if (chamada == 0) {
+                    chamada = p.size() + 1;
+                    assembler::emit_branch32_be(p, Opcode::CALL, 0);
+                }
+                else {
+                    assembler::emit_push(p, 1);
+                    ++profundidade;
+                }
+                break;
+            // profundidade >= 1
+            case 8: assembler::emit(p, Opcode::DUP); ++profundidade; break;
+            case 9: assembler::emit(p, Opcode::POP); --profundidade; break;
+            case 10: assembler::emit(p, Opcode::PRINT); --profundidade; break;
+            case 11: saltos.emplace_back(p.size() + 1, false); assembler::emit_jz_be(p, 0); --profundidade; break;
+            case 12: salto32(Opcode::JNZ); --profundidade; break;
+            case 13: assembler::emit_store_be(p, static_cast<Word16>(sorteio(4))); --profundidade; break;
+            case 14: salto32(Opcode::JZ32); --profundidade; break;
+            // profundidade >= 2
+            case 15: assembler::emit(p, Opcode::SWAP); break;
+            case 16: assembler::emit(p, Opcode::ADD); --profundidade; break;
+            case 17: assembler::emit(p, Opcode::SUB); --profundidade; break;
+            case 18: assembler::emit(p, Opcode::MUL); --profundidade; break;
+            case 19: assembler::emit(p, Opcode::DIV); --profundidade; break;
+            default: salto32(Opcode::JLT); profundidade -= 2; break;
+            }
+        }
+        inicios.push_back(p.size());
+        assembler::emit(p, Opcode::HALT);
+
+        // Cada salto recebe como alvo o incio de uma instruo posterior (ou o HALT final).
+        for (const auto& [pos, largo] : saltos) {
+            const auto depois = std::upper_bound(inicios.begin(), inicios.end(), pos);
+            const auto alvo = *(depois + static_cast<std::ptrdiff_t>(sorteio(static_cast<std::size_t>(inicios.end() - depois))));
+            if (largo) assembler::patch_dword_be(p, pos, static_cast<std::uint32_t>(alvo));
+            else assembler::patch_word_be(p, pos, static_cast<Word16>(alvo));
+        }
+        if (chamada != 0) {
+            assembler::patch_dword_be(p, chamada, static_cast<std::uint32_t>(p.size()));
+            assembler::emit_load_be(p, 3);
+            assembler::emit_push(p, 1);
+            assembler::emit(p, Opcode::ADD);
+            assembler::emit(p, Opcode::DUP);
+            assembler::emit(p, Opcode::PRINT);
+            assembler::emit_store_be(p, 3);
+            assembler::emit(p, Opcode::RET);
+        }
+        try {
+            (void)verify_program(p, Endianness::Big);
+            return p;
+        }
+        catch (const VMError&) {
+            // profundidades inconsistentes em uma juno: sorteia outro programa
+        }
+    }
+}
+
+/**
+ * @brief Cria um programa que imprime o contador do lao interno a cada iterao.
+ *
+ * Imprime `outer * inner` valores; o custo  dominado pela sada de `PRINT`.
+ *
+ * @param outer Nmero de iteraes do lao externo.
+ * @param inner Nmero de iteraes do lao interno.
+ * @return Bytecode do programa.
+ */
+inline std::vector<Byte> make_program_print(Word16 outer, Word16 inner) {
+    return make_nested_loop(outer, inner, [](std::vector<Byte>& p) {
+        assembler::emit(p, Opcode::DUP);
+        assembler::emit(p, Opcode::PRINT);
+        });
+}
+
+/**
+ * @brief Gera um programa aleatrio estruturado: laos contados, desvios, sub-rotinas e memria.
+ *
+ * Diferente de `make_random_program`, que s salta para frente, este gerador produz cdigo com
+ * laos de verdade (`PUSH k; corpo; PUSH 1; SUB; DUP; JNZ`) aninhados at dois nveis, desvios
+ * condicionais sobre blocos (`JZ32`/`JNZ`/`JLT`), at duas sub-rotinas chamadas por `CALL` e
+ * acessos s clulas 0 a 7 do segmento de dados. Cada construo  gerada com profundidade
+ * lquida zero e sem tocar os valores abaixo do seu "piso" (o contador do lao, os valores do
+ * chamador), e cada sub-rotina s  chamada na profundidade da sua primeira chamada; assim o
+ * programa  sempre aprovado pelo verificador e sempre termina.
+ *
+ * @param rng Gerador de nmeros aleatrios.
+ * @param instrucoes Tamanho aproximado do programa principal, em construes.
+ * @return Bytecode (big-endian) de um programa vlido.
+ * @throws VMError Se o programa gerado for rejeitado pelo verificador (erro no prprio gerador).
+ */
+inline std::vector<Byte> make_random_structured_program(std::mt19937_64& rng, std::size_t instrucoes) {
+    auto sorteio = [&](std::size_t n) { return static_cast<std::size_t>(rng() % n); };
+
+    struct Funcao {
+        int profundidade = -1;            // profundidade absoluta de entrada (-1 = ainda no gerada)
+        std::vector<Byte> corpo;
+        std::vector<std::size_t> chamadas; // posies (no programa) dos operandos dos CALLs
+    };
+    std::array<Funcao, 2> funcoes;
+
+    // Gera `n` construes em `p` e devolve a profundidade final; nunca consome abaixo de `piso`.
+    // Em `funcao` (ndice da sub-rotina sendo gerada, ou -1) no h chamadas: as funes so folhas.
+    auto bloco = [&](auto& self, std::vector<Byte>& p, int profundidade, int piso, std::size_t n,
+        int aninhamento, int funcao) -> int {
+        for (std::size_t i = 0; i < n; ++i) {
+            const int livres = profundidade - piso;
+            switch (sorteio(16)) {
+            case 0: assembler::emit_push(p, static_cast<Byte>(sorteio(10))); ++profundidade; break;
+            case 1: assembler::emit_push16_be(p, static_cast<Word16>(rng())); ++profundidade; break;
+            case 2: assembler::emit_push32_be(p, static_cast<std::int32_t>(rng())); ++profundidade; break;
+            case 3: assembler::emit_push64_be(p, static_cast<std::int64_t>(rng())); ++profundidade; break;
+            case 4: assembler::emit_load_be(p, static_cast<Word16>(sorteio(8))); ++profundidade; break;
+            case 5:
+                if (livres < 1) break;
+                assembler::emit_store_be(p, static_cast<Word16>(sorteio(8)));
+                --profundidade;
+                break;
+            case 6:
+                if (livres < 1) break;
+                if (sorteio(2)) { assembler::emit(p, Opcode::DUP); ++profundidade; }
+                else { assembler::emit(p, Opcode::PRINT); --profundidade; }
+                break;
+            case 7:
+                if (livres < 1) break;
+                assembler::emit(p, Opcode::POP);
+                --profundidade;
+                break;
+            case 8:
+            case 9: {
+                if (livres < 2) break;
+                constexpr std::array<Opcode, 4> kOps = { Opcode::ADD, Opcode::SUB, Opcode::MUL, Opcode::SWAP };
+                const Opcode op = kOps[sorteio(kOps.size())];
+                assembler::emit(p, op);
+                if (op != Opcode::SWAP) --profundidade;
+                break;
+            }
+            case 10:
+                if (livres < 1) break;
+                // quase sempre por uma constante no nula: a diviso por zero encerra o programa cedo
+                if (sorteio(8) != 0) assembler::emit_push(p, static_cast<Byte>(1 + sorteio(9)));
+                else if (livres < 2) break;
+                else --profundidade;
+                assembler::emit(p, Opcode::DIV);
+                break;
+            case 11:
+            case 12: { // if: desvio condicional sobre um bloco de profundidade lquida zero
+                const std::size_t precisa = (sorteio(3) == 0) ? 2 : 1;
+                if (static_cast<std::size_t>(livres) < precisa) break;
+                const Opcode op = precisa == 2 ? Opcode::JLT : (sorteio(2) ? Opcode::JZ32 : Opcode::JNZ);
+                const std::size_t alvo = p.size() + 1;
+                assembler::emit_branch32_be(p, op, 0);
+                profundidade -= static_cast<int>(precisa);
+                const int fim = self(self, p, profundidade, profundidade, 1 + sorteio(4), aninhamento, funcao);
+                for (int k = fim; k > profundidade; --k) assembler::emit(p, Opcode::POP);
+                assembler::patch_dword_be(p, alvo, static_cast<std::uint32_t>(p.size()));
+                break;
+            }
+            case 13:
+            case 14: { // lao contado; o contador fica abaixo do piso do corpo
+                if (aninhamento >= 2) break;
+                assembler::emit_push(p, static_cast<Byte>(1 + sorteio(12)));
+                const auto inicio = static_cast<std::uint32_t>(p.size());
+                const int corpo = profundidade + 1;
+                const int fim = self(self, p, corpo, corpo, 1 + sorteio(6), aninhamento + 1, funcao);
+                for (int k = fim; k > corpo; --k) assembler::emit(p, Opcode::POP);
+                assembler::emit_push(p, 1);
+                assembler::emit(p, Opcode::SUB);
+                assembler::emit(p, Opcode::DUP);
+                assembler::emit_branch32_be(p, Opcode::JNZ, inicio);
+                assembler::emit(p, Opcode::POP);
+                break;
+            }
+            default: { // CALL (s no programa principal)
+                if (funcao >= 0) break;
+                const std::size_t f = sorteio(funcoes.size());
+                Funcao& alvo = funcoes[f];
+                if (alvo.profundidade < 0) {
+                    alvo.profundidade = profundidade;
+                    const int fim = self(self, alvo.corpo, profundidade, profundidade, 2 + sorteio(6), 1, static_cast<int>(f));
+                    for (int k = fim; k > profundidade; --k) assembler::emit(alvo.corpo, Opcode::POP);
+                    assembler::emit(alvo.corpo, Opcode::RET);
+                }
+                if (alvo.profundidade != profundidade) break;
+                alvo.chamadas.push_back(p.size() + 1);
+                assembler::emit_branch32_be(p, Opcode::CALL, 0);
+                break;
+            }
+            }
+        }
+        return profundidade;
+    };
+
+    std::vector<Byte> p;
+    (void)bloco(bloco, p, 0, 0, 1 + sorteio(instrucoes), 0, -1);
+    assembler::emit(p, Opcode::HALT);
+    for (const Funcao& f : funcoes) {
+        if (f.chamadas.empty()) continue;
+        // Os saltos internos da funo so absolutos: realoca-os para a posio final.
+        const auto base = static_cast<std::uint32_t>(p.size());
+        std::vector<Byte> corpo = f.corpo;
+        for (Address pc = 0; pc < corpo.size(); pc += 1 + operand_size(static_cast<Opcode>(corpo[pc]))) {
+            if (is_branch(static_cast<Opcode>(corpo[pc]))) {
+                assembler::patch_dword_be(corpo, pc + 1, branch_target(corpo, pc, Endianness::Big) + base);
+            }
+        }
+        for (std::size_t at : f.chamadas) assembler::patch_dword_be(p, at, base);
+        p.insert(p.end(), corpo.begin(), corpo.end());
+    }
+    (void)verify_program(p, Endianness::Big);
+    return p;
+}
@@ -0,0 +1,15 @@
+; Contagem regressiva de 10 a 1 (mesmo algoritmo de make_program2_countdown).
+;
+;   VM-Process1 --assemble exemplos/contagem.asm contagem.vmb
+;   VM-Process1 --run contagem.vmb fast
+
+        PUSH 10
+laco:   DUP
+        PRINT
+        PUSH 1
+        SUB
+        DUP
+        JZ fim
+        JMP laco
+fim:    POP
+        HALT
@@ -0,0 +1,26 @@
+; Soma dos quadrados de 1 a 10 com uma sub-rotina e o segmento de dados.
+;
+;   VM-Process1 --assemble exemplos/quadrados.asm quadrados.vmb
+;   VM-Process1 --run quadrados.vmb jit
+
+        PUSH 1
+laco:   CALL acumula
+        PUSH 1
+        ADD
+        DUP
+        PUSH 11
+        JLT laco
+        POP
+        LOAD 0
+        PRINT
+        HALT
+
+; [i] -> [i], data[0] += i * i
+acumula:
+        DUP
+        DUP
+        MUL
+        LOAD 0
+        ADD
+        STORE 0
+        RET
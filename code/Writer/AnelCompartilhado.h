@@ -0,0 +1,959 @@
+/**
+ * @file AnelCompartilhado.h
+ * @brief Anel SPSC (um produtor, um consumidor) de mensagens de tamanho varivel em memria compartilhada POSIX.
+ *
+ * Alternativa ao protocolo de um slot do shared_struct.h (uma mensagem por vez, com evento "vazio",
+ * mutex e evento "cheio" a cada mensagem). Aqui o segmento criado com `shm_open`/`mmap` guarda um
+ * cabealho e uma rea de dados circular onde cabem vrias mensagens ao mesmo tempo:
+ * - o escritor s altera `cabeca` (total de bytes j escritos) e o leitor s altera `cauda` (total de
+ *   bytes j lidos), ento nenhum lock  necessrio: basta publicar os ndices com release/acquire;
+ * - `cabeca` e `cauda` ficam em linhas de cache diferentes, para que a escrita de um lado no invalide
+ *   a linha que o outro lado est lendo (*false sharing*);
+ * - cada lado guarda uma cpia local do ndice do outro e s rel o ndice compartilhado quando a cpia
+ *   diz que o anel est cheio (escritor) ou vazio (leitor).
+ *
+ * Cada mensagem  gravada como um registro `[tamanho: uint32][livre: uint32][bytes...]`, alinhado a
+ * 8 bytes e sempre contguo: se no couber at o fim da rea de dados, o resto da rea recebe um
+ * marcador "pular" e o registro comea do incio. Assim o escritor pode montar a mensagem direto no
+ * segmento (reservar/confirmar) e o leitor pode l-la ali mesmo (espiar/liberar), sem cpia;
+ * enviar/receber so atalhos que copiam. Mensagens podem ter at o tamanho do anel menos 8 bytes.
+ *
+ * Espera hbrida: quem encontra o anel vazio (leitor) ou cheio (escritor) primeiro gira um pouco
+ * relendo os ndices e s ento dorme num futex que fica no prprio segmento. O outro lado s faz a
+ * chamada de sistema para acord-lo se a flag "dormindo" estiver ligada, ento no caso comum (os dois
+ * acordados) nenhuma mensagem passa pelo kernel.
+ *
+ * AnelDifusao/LeitorDaDifusao usam o mesmo formato de registro para um escritor e vrios leitores
+ * (difuso, SPMC): cada leitor tem o seu cursor no segmento e o escritor  freado pelo mais lento, ou
+ * o descarta, conforme a PoliticaDeLentos.
+ *
+ * O anel  portvel (s usa std::atomic); o segmento (SegmentoCompartilhado)  POSIX.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace ipc {
+
+/// Tamanho de uma linha de cache nas CPUs x86-64 e ARM64 comuns.
+inline constexpr std::size_t kLinhaDeCache = 64;
+
+/// Identifica um segmento j inicializado como anel ("ANEL").
+inline constexpr std::uint32_t kMagico = 0x414E454Cu;
+
+/// Cada registro comea com o tamanho da mensagem (uint32) e 4 bytes livres, para a mensagem ficar alinhada a 8.
+inline constexpr std::size_t kCabecalhoDoRegistro = 8;
+
+/// Tamanho especial no cabealho: "o resto da rea de dados est vazio, continue no incio".
+inline constexpr std::uint32_t kPular = 0xFFFFFFFFu;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+    "os indices do anel sao compartilhados entre processos e precisam ser atomicos sem lock");
+
+/**
+ * @brief Cabealho do anel, no incio do segmento compartilhado. A rea de dados vem logo depois.
+ */
+struct CabecalhoDoAnel {
+    std::uint32_t magico;
+    std::uint32_t reservado;
+    std::uint64_t capacidade;             ///< Bytes da rea de dados (potncia de 2).
+    std::atomic<std::uint32_t> encerrado; ///< Equivalente a `SharedData::exit_requested`.
+
+    /// 1 enquanto o leitor dorme (ou vai dormir) esperando mensagem; tambm  a palavra do futex dele.
+    alignas(kLinhaDeCache) std::atomic<std::uint32_t> leitorDormindo;
+
+    /// 1 enquanto o escritor dorme esperando espao; tambm  a palavra do futex dele.
+    std::atomic<std::uint32_t> escritorDormindo;
+
+    /// Total de bytes j escritos. S o escritor altera.
+    alignas(kLinhaDeCache) std::atomic<std::uint64_t> cabeca;
+
+    /// Total de bytes j lidos. S o leitor altera.
+    alignas(kLinhaDeCache) std::atomic<std::uint64_t> cauda;
+};
+
+static_assert(offsetof(CabecalhoDoAnel, cauda) - offsetof(CabecalhoDoAnel, cabeca) >= kLinhaDeCache);
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "a palavra do futex tem 32 bits");
+static_assert(sizeof(CabecalhoDoAnel) % kLinhaDeCache == 0);
+
+/**
+ * @brief Avisa a CPU de que estamos num lao de espera ativa (reduz consumo e a penalidade ao sair do lao).
+ */
+inline void pausar() noexcept {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_pause();
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * @brief Dorme enquanto `palavra` valer `esperado` (pode voltar antes, sem motivo; quem chama confere de novo).
+ *
+ * Usa o futex sem FUTEX_PRIVATE_FLAG, que funciona entre processos que mapeiam a mesma memria.
+ * std::atomic::wait no serve aqui: a libstdc++ usa futex privado, que s acorda threads do mesmo processo.
+ * Fora do Linux no h um equivalente portvel entre processos, ento tiramos um cochilo curto.
+ */
+inline void dormirNaPalavra(std::atomic<std::uint32_t>& palavra, std::uint32_t esperado,
+    std::chrono::microseconds limite = std::chrono::microseconds(0)) noexcept {
+#ifdef __linux__
+    timespec espera{ static_cast<time_t>(limite.count() / 1000000), static_cast<long>(limite.count() % 1000000) * 1000 };
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&palavra), FUTEX_WAIT, esperado, limite.count() > 0 ? &espera : nullptr, nullptr, 0);
+#else
+    if (palavra.load(std::memory_order_relaxed) == esperado) std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+}
+
+/// Acorda um processo (ou todos) que dorme em `palavra` (no-op fora do Linux, onde o cochilo termina sozinho).
+inline void acordarNaPalavra([[maybe_unused]] std::atomic<std::uint32_t>& palavra, [[maybe_unused]] bool todos = false) noexcept {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&palavra), FUTEX_WAKE, todos ? INT32_MAX : 1, nullptr, nullptr, 0);
+#endif
+}
+
+/**
+ * @brief Liga a flag "dormindo", confere a condio mais uma vez e dorme no futex se ela ainda for falsa.
+ * @param limite Tempo mximo de sono (0 = sem limite).
+ * @return bool true se chegou a chamar o FUTEX_WAIT.
+ *
+ * A ordem  o que impede a perda de um aviso: quem dorme liga a flag e s depois rel o ndice; quem
+ * avisa publica o ndice e s depois l a flag (acordarSeDormindo). Com as duas cercas seq_cst, pelo
+ * menos um dos dois v a escrita do outro: ou quem ia dormir v o ndice novo e no dorme, ou quem
+ * publicou v a flag ligada e faz o FUTEX_WAKE. Se o aviso chegar entre a releitura e o FUTEX_WAIT, a
+ * flag j voltou a 0 e o FUTEX_WAIT retorna na hora (ele s dorme se a palavra ainda valer 1).
+ */
+template <typename Condicao>
+bool dormirAte(std::atomic<std::uint32_t>& dormindo, Condicao&& pronto,
+    std::chrono::microseconds limite = std::chrono::microseconds(0)) noexcept {
+    dormindo.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const bool dormir = !pronto();
+    if (dormir) dormirNaPalavra(dormindo, 1, limite);
+    dormindo.store(0, std::memory_order_relaxed);
+    return dormir;
+}
+
+/**
+ * @brief Depois de publicar um ndice: se o outro lado estiver dormindo, desliga a flag e o acorda.
+ * @return bool true se fez o FUTEX_WAKE.
+ */
+inline bool acordarSeDormindo(std::atomic<std::uint32_t>& dormindo) noexcept {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (dormindo.load(std::memory_order_relaxed) == 0) return false;
+    dormindo.store(0, std::memory_order_relaxed);
+    acordarNaPalavra(dormindo);
+    return true;
+}
+
+/// Bytes ocupados no anel por uma mensagem de `tamanho` bytes (cabealho + mensagem, alinhado a 8).
+inline constexpr std::uint64_t tamanhoDoRegistro(std::size_t tamanho) noexcept {
+    return (kCabecalhoDoRegistro + tamanho + 7) & ~std::uint64_t{ 7 };
+}
+
+/**
+ * @brief Quantas vezes girar relendo os ndices antes de dormir.
+ *
+ * Girar s adianta se o outro processo estiver rodando em outra CPU; com uma CPU s, cada giro  tempo
+ * roubado de quem vai produzir a mensagem, ento o padro  dormir direto.
+ */
+inline unsigned girosPadrao() noexcept {
+    static const unsigned giros = std::thread::hardware_concurrency() > 1 ? 2000 : 0;
+    return giros;
+}
+
+/**
+ * @brief Viso de um processo sobre o anel: o escritor usa enviar/tentarEnviar e o leitor, receber/tentarReceber.
+ *
+ * O objeto no  dono da memria; ele aponta para um segmento que o SegmentoCompartilhado mantm mapeado.
+ * Cada processo tem o seu objeto, e os campos em cache (caudaConhecida_, cabecaConhecida_) so locais.
+ */
+class AnelSpsc {
+public:
+    /// Bytes que o segmento precisa ter para um anel com essa capacidade.
+    static constexpr std::size_t tamanhoDoSegmento(std::size_t capacidade) noexcept {
+        return sizeof(CabecalhoDoAnel) + capacidade;
+    }
+
+    /**
+     * @brief Inicializa um anel vazio no comeo de `memoria` (lado que cria o segmento).
+     * @param memoria Pelo menos tamanhoDoSegmento(capacidade) bytes, alinhados a kLinhaDeCache.
+     * @param capacidade Bytes da rea de dados; potncia de 2, no mnimo 64.
+     * @throw std::invalid_argument Se a capacidade no for uma potncia de 2 vlida.
+     */
+    static AnelSpsc inicializar(void* memoria, std::size_t capacidade) {
+        if (capacidade < 64 || (capacidade & (capacidade - 1)) != 0) {
+            throw std::invalid_argument("A capacidade do anel deve ser uma potencia de 2 (minimo 64): " + std::to_string(capacidade));
+        }
+        auto* c = new (memoria) CabecalhoDoAnel{};
+        c->capacidade = capacidade;
+        c->magico = kMagico; // por ltimo: um leitor que v o mgico v o resto
+        return AnelSpsc(c);
+    }
+
+    /**
+     * @brief Usa um anel j inicializado por outro processo.
+     * @param memoria O incio do segmento.
+     * @param tamanho O tamanho do segmento mapeado.
+     * @throw std::runtime_error Se o segmento no contiver um anel ou for menor do que o anel diz ser.
+     */
+    static AnelSpsc anexar(void* memoria, std::size_t tamanho) {
+        auto* c = static_cast<CabecalhoDoAnel*>(memoria);
+        if (tamanho < sizeof(CabecalhoDoAnel) || c->magico != kMagico || tamanhoDoSegmento(c->capacidade) > tamanho) {
+            throw std::runtime_error("O segmento compartilhado nao contem um anel valido.");
+        }
+        return AnelSpsc(c);
+    }
+
+    /// Muda quantas vezes enviar/receber giram antes de dormir (0 = sempre dormir).
+    void definirGiros(unsigned giros) noexcept { giros_ = giros; }
+
+    /// Quantas chamadas futex (dormir + acordar) este processo j fez.
+    std::uint64_t chamadasAoKernel() const noexcept { return chamadasAoKernel_; }
+
+    /// Maior mensagem que cabe no anel (o registro inteiro, contguo, precisa caber na rea de dados).
+    std::size_t maiorMensagem() const noexcept { return static_cast<std::size_t>(mascara_ + 1) - kCabecalhoDoRegistro; }
+
+    // --- Escritor: reservar/confirmar (sem cpia) ---
+
+    /**
+     * @brief Tenta reservar `tamanho` bytes contguos no anel para o escritor montar a mensagem no lugar.
+     * @return void* Onde escrever a mensagem (alinhado a 8 bytes), ou nullptr se no houver espao agora.
+     * @throw std::length_error Se a mensagem for maior que maiorMensagem().
+     * @throw std::logic_error Se j houver uma reserva no confirmada.
+     *
+     * Se o registro no couber entre a posio atual e o fim da rea de dados, o resto da rea  marcado
+     * como "pular" e publicado na hora; a mensagem comea no incio da rea, quando houver espao l.
+     * Publicar o marcador sozinho  o que permite mensagens do tamanho do anel: o leitor passa pelo
+     * marcador e libera essa sobra mesmo antes de a mensagem caber.
+     */
+    void* tentarReservar(std::size_t tamanho) {
+        if (tamanho > maiorMensagem()) {
+            throw std::length_error("Mensagem de " + std::to_string(tamanho) + " bytes nao cabe no anel.");
+        }
+        if (reservado_) throw std::logic_error("Reserva anterior ainda nao confirmada.");
+        std::uint64_t cabeca = c_->cabeca.load(std::memory_order_relaxed);
+        const std::uint64_t registro = tamanhoDoRegistro(tamanho);
+        const std::uint64_t ateOFim = (mascara_ + 1) - (cabeca & mascara_);
+        if (registro > ateOFim) {
+            if (!haEspaco(cabeca, ateOFim)) return nullptr;
+            gravarCabecalho(cabeca, kPular);
+            cabeca += ateOFim;
+            c_->cabeca.store(cabeca, std::memory_order_release);
+            acordarSeDormindo(c_->leitorDormindo);
+        }
+        if (!haEspaco(cabeca, registro)) return nullptr;
+        reservado_ = true;
+        tamanhoReservado_ = tamanho;
+        return dados_ + (cabeca & mascara_) + kCabecalhoDoRegistro;
+    }
+
+    /// Reserva `tamanho` bytes, esperando (gira, depois dorme) enquanto o anel estiver cheio.
+    void* reservar(std::size_t tamanho) {
+        for (unsigned giro = 0;; ++giro) {
+            if (void* destino = tentarReservar(tamanho)) return destino;
+            if (giro < giros_) {
+                pausar();
+                continue;
+            }
+            const std::uint64_t cabeca = c_->cabeca.load(std::memory_order_relaxed);
+            const std::uint64_t ateOFim = (mascara_ + 1) - (cabeca & mascara_);
+            const std::uint64_t proximoPasso = std::min(ateOFim, tamanhoDoRegistro(tamanho)); // o marcador ou a mensagem
+            dormirAte(c_->escritorDormindo, [&] {
+                return cabeca + proximoPasso - c_->cauda.load(std::memory_order_relaxed) <= mascara_ + 1;
+            });
+        }
+    }
+
+    /**
+     * @brief Publica a mensagem reservada, com `tamanho` bytes (pode ser menos do que o reservado).
+     * @throw std::logic_error Se no houver reserva ou se `tamanho` passar do reservado.
+     */
+    void confirmar(std::size_t tamanho) {
+        if (!reservado_ || tamanho > tamanhoReservado_) throw std::logic_error("Confirmacao sem reserva correspondente.");
+        const std::uint64_t cabeca = c_->cabeca.load(std::memory_order_relaxed);
+        gravarCabecalho(cabeca, static_cast<std::uint32_t>(tamanho));
+        reservado_ = false;
+        c_->cabeca.store(cabeca + tamanhoDoRegistro(tamanho), std::memory_order_release); // publica o registro inteiro
+        acordarSeDormindo(c_->leitorDormindo);
+    }
+
+    /// Publica a mensagem reservada com o tamanho inteiro da reserva.
+    void confirmar() { confirmar(tamanhoReservado_); }
+
+    // --- Escritor: cpia ---
+
+    /**
+     * @brief Tenta copiar uma mensagem para o anel, sem esperar.
+     * @return bool false se no houver espao agora.
+     * @throw std::length_error Se a mensagem for maior que maiorMensagem().
+     */
+    bool tentarEnviar(const void* dados, std::size_t tamanho) {
+        void* destino = tentarReservar(tamanho);
+        if (!destino) return false;
+        std::memcpy(destino, dados, tamanho);
+        confirmar(tamanho);
+        return true;
+    }
+
+    /// Envia uma mensagem, esperando (gira, depois dorme) enquanto o anel estiver cheio.
+    void enviar(const void* dados, std::size_t tamanho) {
+        std::memcpy(reservar(tamanho), dados, tamanho);
+        confirmar(tamanho);
+    }
+
+    // --- Leitor: espiar/liberar (sem cpia) ---
+
+    /**
+     * @brief Tenta olhar a prxima mensagem direto no anel, sem copiar e sem esperar.
+     * @param mensagem Aponta para os bytes dentro do segmento; vale at liberar().
+     * @return bool false se o anel estiver vazio agora.
+     *
+     * Enquanto a mensagem no for liberada, o escritor no pode reutilizar o espao dela. Chamar de novo
+     * antes de liberar() devolve a mesma mensagem.
+     */
+    bool tentarEspiar(std::string_view& mensagem) {
+        std::uint64_t cauda = c_->cauda.load(std::memory_order_relaxed);
+        for (;;) {
+            if (cauda == cabecaConhecida_) {
+                cabecaConhecida_ = c_->cabeca.load(std::memory_order_acquire); // s rel o ndice do escritor quando parece vazio
+                if (cauda == cabecaConhecida_) return false;
+            }
+            std::uint32_t tamanho = 0;
+            std::memcpy(&tamanho, dados_ + (cauda & mascara_), sizeof(tamanho));
+            if (tamanho != kPular) {
+                mensagem = { reinterpret_cast<const char*>(dados_ + (cauda & mascara_) + kCabecalhoDoRegistro), tamanho };
+                espiado_ = tamanhoDoRegistro(tamanho);
+                return true;
+            }
+            cauda += (mascara_ + 1) - (cauda & mascara_); // marcador: a prxima mensagem est no incio da rea
+            c_->cauda.store(cauda, std::memory_order_release);
+            acordarSeDormindo(c_->escritorDormindo);
+        }
+    }
+
+    /**
+     * @brief Olha a prxima mensagem, esperando enquanto o anel estiver vazio.
+     * @return bool false se o escritor encerrou e no h mais mensagens.
+     */
+    bool espiar(std::string_view& mensagem) {
+        for (unsigned giro = 0; !tentarEspiar(mensagem); ++giro) {
+            if (c_->encerrado.load(std::memory_order_acquire)) {
+                return tentarEspiar(mensagem); // o que foi enviado antes de encerrar ainda  entregue
+            }
+            if (giro < giros_) {
+                pausar();
+                continue;
+            }
+            const std::uint64_t cauda = c_->cauda.load(std::memory_order_relaxed);
+            dormirAte(c_->leitorDormindo, [&] {
+                return c_->cabeca.load(std::memory_order_relaxed) != cauda || c_->encerrado.load(std::memory_order_relaxed) != 0;
+            });
+        }
+        return true;
+    }
+
+    /// Devolve ao escritor o espao da mensagem espiada (a string_view deixa de valer).
+    void liberar() {
+        if (espiado_ == 0) throw std::logic_error("Nenhuma mensagem espiada para liberar.");
+        c_->cauda.store(c_->cauda.load(std::memory_order_relaxed) + espiado_, std::memory_order_release);
+        espiado_ = 0;
+        acordarSeDormindo(c_->escritorDormindo);
+    }
+
+    // --- Leitor: cpia ---
+
+    /**
+     * @brief Tenta tirar a prxima mensagem do anel, sem esperar.
+     * @param mensagem Recebe uma cpia dos bytes da mensagem.
+     * @return bool false se o anel estiver vazio agora.
+     */
+    bool tentarReceber(std::string& mensagem) {
+        std::string_view espiada;
+        if (!tentarEspiar(espiada)) return false;
+        mensagem.assign(espiada);
+        liberar();
+        return true;
+    }
+
+    /**
+     * @brief Recebe (copia) a prxima mensagem, esperando enquanto o anel estiver vazio.
+     * @return bool false se o escritor encerrou e no h mais mensagens.
+     */
+    bool receber(std::string& mensagem) {
+        std::string_view espiada;
+        if (!espiar(espiada)) return false;
+        mensagem.assign(espiada);
+        liberar();
+        return true;
+    }
+
+    /// Avisa o leitor de que no haver mais mensagens (como `exit_requested = true`) e o acorda.
+    void encerrar() noexcept {
+        c_->encerrado.store(1, std::memory_order_release);
+        acordarSeDormindo(c_->leitorDormindo);
+    }
+
+private:
+    explicit AnelSpsc(CabecalhoDoAnel* c)
+        : c_(c),
+          dados_(reinterpret_cast<unsigned char*>(c) + sizeof(CabecalhoDoAnel)),
+          mascara_(c->capacidade - 1),
+          caudaConhecida_(c->cauda.load(std::memory_order_acquire)),
+          cabecaConhecida_(c->cabeca.load(std::memory_order_acquire)) {}
+
+    /// dormirAte, contando a chamada de sistema.
+    template <typename Condicao>
+    void dormirAte(std::atomic<std::uint32_t>& dormindo, Condicao&& pronto) noexcept {
+        chamadasAoKernel_ += ipc::dormirAte(dormindo, pronto);
+    }
+
+    /// acordarSeDormindo, contando a chamada de sistema.
+    void acordarSeDormindo(std::atomic<std::uint32_t>& dormindo) noexcept {
+        chamadasAoKernel_ += ipc::acordarSeDormindo(dormindo);
+    }
+
+    /// Rel `cauda` se a cpia local disser que faltam `n` bytes livres a partir de `cabeca`.
+    bool haEspaco(std::uint64_t cabeca, std::uint64_t n) noexcept {
+        if (cabeca + n - caudaConhecida_ <= mascara_ + 1) return true;
+        caudaConhecida_ = c_->cauda.load(std::memory_order_acquire); // s rel o ndice do leitor quando parece cheio
+        return cabeca + n - caudaConhecida_ <= mascara_ + 1;
+    }
+
+    void gravarCabecalho(std::uint64_t posicao, std::uint32_t tamanho) noexcept {
+        std::memcpy(dados_ + (posicao & mascara_), &tamanho, sizeof(tamanho));
+    }
+
+    CabecalhoDoAnel* c_;
+    unsigned char* dados_;
+    std::uint64_t mascara_;
+    std::uint64_t caudaConhecida_;  ///< Cpia local de `cauda` (usada pelo escritor).
+    std::uint64_t cabecaConhecida_; ///< Cpia local de `cabeca` (usada pelo leitor).
+    unsigned giros_ = girosPadrao();
+    bool reservado_ = false;          ///< H uma reserva do escritor ainda no confirmada.
+    std::size_t tamanhoReservado_ = 0;
+    std::uint64_t espiado_ = 0;       ///< Bytes do registro espiado pelo leitor (0 = nenhum).
+    std::uint64_t chamadasAoKernel_ = 0;
+};
+
+// --- Difuso (SPMC): um escritor, vrios leitores, cada um com o seu cursor ---
+
+/// Quantos leitores uma difuso aceita ao mesmo tempo.
+inline constexpr std::size_t kMaximoDeLeitores = 32;
+
+/// Identifica um segmento j inicializado como difuso ("DIFU").
+inline constexpr std::uint32_t kMagicoDaDifusao = 0x44494655u;
+
+/// O que o escritor da difuso faz quando o leitor mais lento no deixa espao no anel.
+enum class PoliticaDeLentos : std::uint32_t {
+    Esperar,   ///< Espera o leitor mais lento: nenhum leitor perde mensagens, todos andam no ritmo dele.
+    Descartar, ///< Depois de esperar `tolerancia`, desliga os leitores que esto segurando o anel.
+};
+
+/// Estado de uma vaga de leitor na difuso.
+enum class EstadoDoLeitor : std::uint32_t { Livre, Ativo, Descartado };
+
+/**
+ * @brief O cursor de um leitor, numa linha de cache s dele (cada leitor escreve s no seu).
+ */
+struct CursorDoLeitor {
+    alignas(kLinhaDeCache) std::atomic<std::uint64_t> posicao; ///< Total de bytes que este leitor j leu.
+    std::atomic<std::uint32_t> estado;                         ///< Um EstadoDoLeitor.
+};
+
+/**
+ * @brief Cabealho da difuso, no incio do segmento compartilhado. A rea de dados vem logo depois.
+ */
+struct CabecalhoDaDifusao {
+    std::uint32_t magico;
+    PoliticaDeLentos politica;
+    std::uint64_t capacidade;             ///< Bytes da rea de dados (potncia de 2).
+    std::uint64_t toleranciaEmMicros;     ///< Quanto o escritor espera antes de descartar (PoliticaDeLentos::Descartar).
+    std::atomic<std::uint32_t> encerrado;
+    std::atomic<std::uint32_t> trava;     ///< Protege a entrada/sada de leitores e a busca do mais lento.
+
+    /// Total de bytes j escritos. S o escritor altera.
+    alignas(kLinhaDeCache) std::atomic<std::uint64_t> cabeca;
+
+    /// Futex dos leitores: muda a cada aviso do escritor, e todos os que dormem nele acordam.
+    alignas(kLinhaDeCache) std::atomic<std::uint32_t> avisos;
+    std::atomic<std::uint32_t> leitoresDormindo; ///< 1 se algum leitor dorme (ou vai dormir) em `avisos`; o escritor zera ao avisar.
+    std::atomic<std::uint32_t> escritorDormindo; ///< 1 enquanto o escritor dorme esperando espao.
+
+    CursorDoLeitor leitores[kMaximoDeLeitores];
+};
+
+static_assert(sizeof(CabecalhoDaDifusao) % kLinhaDeCache == 0);
+
+/**
+ * @brief Trava de giro entre processos (RAII), para as operaes raras da difuso: um leitor entrando ou
+ * saindo e o escritor procurando o leitor mais lento.
+ */
+class TravaDeGiro {
+public:
+    explicit TravaDeGiro(std::atomic<std::uint32_t>& trava) noexcept : trava_(trava) {
+        while (trava_.exchange(1, std::memory_order_acquire) != 0) std::this_thread::yield();
+    }
+    TravaDeGiro(const TravaDeGiro&) = delete;
+    TravaDeGiro& operator=(const TravaDeGiro&) = delete;
+    ~TravaDeGiro() { trava_.store(0, std::memory_order_release); }
+
+private:
+    std::atomic<std::uint32_t>& trava_;
+};
+
+/**
+ * @brief Lado do escritor de uma difuso: publica mensagens que todos os leitores ativos vo ler.
+ *
+ * Os leitores no consomem as mensagens uns dos outros: cada um anda com o prprio cursor, e o espao
+ * s volta para o escritor quando o leitor mais atrasado passou por ele. O escritor guarda a posio do
+ * mais lento e s varre os cursores de novo quando essa cpia diz que o anel est cheio, ento o custo
+ * por mensagem no cresce com o nmero de leitores. Sem nenhum leitor ativo, as mensagens so
+ * descartadas (ningum segura o anel).
+ *
+ * Com PoliticaDeLentos::Descartar, um leitor que segura o anel por mais que a tolerncia  desligado:
+ * o escritor marca a vaga como Descartado e passa a sobrescrever o que ele no leu. O leitor descobre
+ * ao espiar ou liberar a prxima mensagem (LeitorDaDifusao::foiDescartado).
+ */
+class AnelDifusao {
+public:
+    /// Bytes que o segmento precisa ter para uma difuso com essa capacidade.
+    static constexpr std::size_t tamanhoDoSegmento(std::size_t capacidade) noexcept {
+        return sizeof(CabecalhoDaDifusao) + capacidade;
+    }
+
+    /**
+     * @brief Inicializa uma difuso vazia, sem leitores, no comeo de `memoria`.
+     * @param memoria Pelo menos tamanhoDoSegmento(capacidade) bytes, alinhados a kLinhaDeCache.
+     * @param capacidade Bytes da rea de dados; potncia de 2, no mnimo 64.
+     * @param politica O que fazer com leitores lentos.
+     * @param tolerancia Quanto esperar um leitor lento antes de descart-lo (s com PoliticaDeLentos::Descartar).
+     * @throw std::invalid_argument Se a capacidade no for uma potncia de 2 vlida.
+     */
+    static AnelDifusao inicializar(void* memoria, std::size_t capacidade, PoliticaDeLentos politica = PoliticaDeLentos::Esperar,
+        std::chrono::microseconds tolerancia = std::chrono::milliseconds(1)) {
+        if (capacidade < 64 || (capacidade & (capacidade - 1)) != 0) {
+            throw std::invalid_argument("A capacidade do anel deve ser uma potencia de 2 (minimo 64): " + std::to_string(capacidade));
+        }
+        auto* c = new (memoria) CabecalhoDaDifusao{};
+        c->politica = politica;
+        c->capacidade = capacidade;
+        c->toleranciaEmMicros = static_cast<std::uint64_t>(tolerancia.count());
+        c->magico = kMagicoDaDifusao;
+        return AnelDifusao(c);
+    }
+
+    void definirGiros(unsigned giros) noexcept { giros_ = giros; }
+
+    /// Maior mensagem que cabe no anel.
+    std::size_t maiorMensagem() const noexcept { return static_cast<std::size_t>(mascara_ + 1) - kCabecalhoDoRegistro; }
+
+    /// Quantos leitores esto ativos agora.
+    std::size_t leitoresAtivos() const noexcept {
+        std::size_t ativos = 0;
+        for (const CursorDoLeitor& leitor : c_->leitores) {
+            ativos += leitor.estado.load(std::memory_order_acquire) == static_cast<std::uint32_t>(EstadoDoLeitor::Ativo);
+        }
+        return ativos;
+    }
+
+    /// Quantos leitores este escritor j descartou.
+    std::uint64_t descartados() const noexcept { return descartados_; }
+
+    /**
+     * @brief Tenta reservar `tamanho` bytes contguos para montar a mensagem no lugar (como AnelSpsc::tentarReservar).
+     * @return void* Onde escrever, ou nullptr se o leitor mais lento ainda no liberou espao.
+     */
+    void* tentarReservar(std::size_t tamanho) {
+        if (tamanho > maiorMensagem()) {
+            throw std::length_error("Mensagem de " + std::to_string(tamanho) + " bytes nao cabe no anel.");
+        }
+        if (reservado_) throw std::logic_error("Reserva anterior ainda nao confirmada.");
+        std::uint64_t cabeca = c_->cabeca.load(std::memory_order_relaxed);
+        const std::uint64_t registro = tamanhoDoRegistro(tamanho);
+        const std::uint64_t ateOFim = (mascara_ + 1) - (cabeca & mascara_);
+        if (registro > ateOFim) {
+            if (!haEspaco(cabeca, ateOFim)) return nullptr;
+            std::memcpy(dados_ + (cabeca & mascara_), &kPular, sizeof(kPular));
+            cabeca += ateOFim;
+            publicar(cabeca);
+        }
+        if (!haEspaco(cabeca, registro)) return nullptr;
+        reservado_ = true;
+        tamanhoReservado_ = tamanho;
+        return dados_ + (cabeca & mascara_) + kCabecalhoDoRegistro;
+    }
+
+    /**
+     * @brief Reserva `tamanho` bytes, esperando o leitor mais lento (gira, depois dorme).
+     *
+     * Com PoliticaDeLentos::Descartar, depois de esperar a tolerncia, descarta os leitores que impedem a
+     * reserva e tenta de novo.
+     */
+    void* reservar(std::size_t tamanho) {
+        const bool podeDescartar = c_->politica == PoliticaDeLentos::Descartar;
+        const auto tolerancia = std::chrono::microseconds(c_->toleranciaEmMicros);
+        std::chrono::steady_clock::time_point inicioDaEspera{};
+        for (unsigned giro = 0;; ++giro) {
+            if (void* destino = tentarReservar(tamanho)) return destino;
+            const std::uint64_t cabeca = c_->cabeca.load(std::memory_order_relaxed);
+            const std::uint64_t proximoPasso = std::min((mascara_ + 1) - (cabeca & mascara_), tamanhoDoRegistro(tamanho));
+            if (podeDescartar) {
+                const auto agora = std::chrono::steady_clock::now();
+                if (giro == 0) {
+                    inicioDaEspera = agora;
+                }
+                else if (agora - inicioDaEspera >= tolerancia) {
+                    descartarLentos(cabeca + proximoPasso);
+                    continue;
+                }
+            }
+            if (giro < giros_) {
+                pausar();
+                continue;
+            }
+            dormirAte(c_->escritorDormindo, [&] {
+                return cabeca + proximoPasso - calcularMaisLento() <= mascara_ + 1;
+            }, podeDescartar ? tolerancia : std::chrono::microseconds(0));
+        }
+    }
+
+    /// Publica a mensagem reservada com `tamanho` bytes (no mximo o reservado).
+    void confirmar(std::size_t tamanho) {
+        if (!reservado_ || tamanho > tamanhoReservado_) throw std::logic_error("Confirmacao sem reserva correspondente.");
+        const std::uint64_t cabeca = c_->cabeca.load(std::memory_order_relaxed);
+        const auto tamanho32 = static_cast<std::uint32_t>(tamanho);
+        std::memcpy(dados_ + (cabeca & mascara_), &tamanho32, sizeof(tamanho32));
+        reservado_ = false;
+        publicar(cabeca + tamanhoDoRegistro(tamanho));
+    }
+
+    void confirmar() { confirmar(tamanhoReservado_); }
+
+    /// Copia uma mensagem para o anel, esperando espao se preciso.
+    void enviar(const void* dados, std::size_t tamanho) {
+        std::memcpy(reservar(tamanho), dados, tamanho);
+        confirmar(tamanho);
+    }
+
+    /// Avisa todos os leitores de que no haver mais mensagens.
+    void encerrar() noexcept {
+        c_->encerrado.store(1, std::memory_order_release);
+        c_->avisos.fetch_add(1, std::memory_order_seq_cst);
+        acordarNaPalavra(c_->avisos, true);
+    }
+
+private:
+    explicit AnelDifusao(CabecalhoDaDifusao* c)
+        : c_(c), dados_(reinterpret_cast<unsigned char*>(c) + sizeof(CabecalhoDaDifusao)), mascara_(c->capacidade - 1) {}
+
+    /**
+     * @brief Publica a nova cabea e acorda os leitores que estiverem dormindo (um nico FUTEX_WAKE para todos).
+     *
+     * O escritor zera a flag ao avisar, ento s faz a chamada de sistema de novo quando algum leitor
+     * voltar a dormir, mesmo que os leitores acordados ainda no tenham tido CPU para rodar.
+     */
+    void publicar(std::uint64_t cabeca) noexcept {
+        c_->cabeca.store(cabeca, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (c_->leitoresDormindo.load(std::memory_order_relaxed) != 0 && c_->leitoresDormindo.exchange(0, std::memory_order_relaxed) != 0) {
+            c_->avisos.fetch_add(1, std::memory_order_relaxed);
+            acordarNaPalavra(c_->avisos, true);
+        }
+    }
+
+    /// Posio do leitor ativo mais atrasado (ou a cabea, se no houver leitores).
+    std::uint64_t calcularMaisLento() noexcept {
+        TravaDeGiro trava(c_->trava);
+        std::uint64_t maisLento = c_->cabeca.load(std::memory_order_relaxed);
+        for (const CursorDoLeitor& leitor : c_->leitores) {
+            if (leitor.estado.load(std::memory_order_acquire) == static_cast<std::uint32_t>(EstadoDoLeitor::Ativo)) {
+                maisLento = std::min(maisLento, leitor.posicao.load(std::memory_order_acquire));
+            }
+        }
+        return maisLento;
+    }
+
+    /// S varre os cursores quando a posio guardada do mais lento diz que faltam `n` bytes a partir de `cabeca`.
+    bool haEspaco(std::uint64_t cabeca, std::uint64_t n) noexcept {
+        if (cabeca + n - maisLento_ <= mascara_ + 1) return true;
+        maisLento_ = calcularMaisLento();
+        return cabeca + n - maisLento_ <= mascara_ + 1;
+    }
+
+    /// Descarta os leitores ativos que ainda no liberaram os bytes at `fim` - capacidade.
+    void descartarLentos(std::uint64_t fim) noexcept {
+        TravaDeGiro trava(c_->trava);
+        for (CursorDoLeitor& leitor : c_->leitores) {
+            if (leitor.estado.load(std::memory_order_acquire) == static_cast<std::uint32_t>(EstadoDoLeitor::Ativo)
+                && fim - leitor.posicao.load(std::memory_order_acquire) > mascara_ + 1) {
+                leitor.estado.store(static_cast<std::uint32_t>(EstadoDoLeitor::Descartado), std::memory_order_release);
+                ++descartados_;
+            }
+        }
+    }
+
+    CabecalhoDaDifusao* c_;
+    unsigned char* dados_;
+    std::uint64_t mascara_;
+    std::uint64_t maisLento_ = 0; ///< Cpia local da posio do leitor mais lento.
+    unsigned giros_ = girosPadrao();
+    bool reservado_ = false;
+    std::size_t tamanhoReservado_ = 0;
+    std::uint64_t descartados_ = 0;
+};
+
+/**
+ * @brief Lado de um leitor da difuso (RAII): ocupa uma vaga ao ser criado e a devolve ao ser destrudo.
+ *
+ * O leitor comea na cabea atual: recebe as mensagens publicadas depois que entrou. A leitura  sem
+ * cpia (espiar/liberar) ou com cpia (receber), como no AnelSpsc. Se a difuso descartar leitores
+ * lentos, a mensagem espiada pode ter sido sobrescrita enquanto era lida: liberar() devolve false nesse
+ * caso, e o leitor deve ignorar o que fez com ela.
+ */
+class LeitorDaDifusao {
+public:
+    /**
+     * @brief Entra na difuso que est em `memoria`.
+     * @throw std::runtime_error Se o segmento no contiver uma difuso ou se todas as vagas estiverem ocupadas.
+     */
+    LeitorDaDifusao(void* memoria, std::size_t tamanho) : c_(static_cast<CabecalhoDaDifusao*>(memoria)) {
+        if (tamanho < sizeof(CabecalhoDaDifusao) || c_->magico != kMagicoDaDifusao
+            || AnelDifusao::tamanhoDoSegmento(c_->capacidade) > tamanho) {
+            throw std::runtime_error("O segmento compartilhado nao contem uma difusao valida.");
+        }
+        dados_ = reinterpret_cast<const unsigned char*>(c_) + sizeof(CabecalhoDaDifusao);
+        mascara_ = c_->capacidade - 1;
+        TravaDeGiro trava(c_->trava);
+        for (CursorDoLeitor& leitor : c_->leitores) {
+            if (leitor.estado.load(std::memory_order_relaxed) == static_cast<std::uint32_t>(EstadoDoLeitor::Livre)) {
+                cursor_ = &leitor;
+                break;
+            }
+        }
+        if (!cursor_) throw std::runtime_error("A difusao ja tem " + std::to_string(kMaximoDeLeitores) + " leitores.");
+        posicao_ = c_->cabeca.load(std::memory_order_acquire);
+        cabecaConhecida_ = posicao_;
+        cursor_->posicao.store(posicao_, std::memory_order_relaxed);
+        cursor_->estado.store(static_cast<std::uint32_t>(EstadoDoLeitor::Ativo), std::memory_order_release);
+    }
+
+    LeitorDaDifusao(const LeitorDaDifusao&) = delete;
+    LeitorDaDifusao& operator=(const LeitorDaDifusao&) = delete;
+
+    ~LeitorDaDifusao() {
+        TravaDeGiro trava(c_->trava);
+        cursor_->estado.store(static_cast<std::uint32_t>(EstadoDoLeitor::Livre), std::memory_order_release);
+        acordarSeDormindo(c_->escritorDormindo);
+    }
+
+    void definirGiros(unsigned giros) noexcept { giros_ = giros; }
+
+    /// O escritor descartou este leitor por ser lento demais (ver PoliticaDeLentos::Descartar).
+    bool foiDescartado() const noexcept {
+        return cursor_->estado.load(std::memory_order_acquire) == static_cast<std::uint32_t>(EstadoDoLeitor::Descartado);
+    }
+
+    /**
+     * @brief Tenta olhar a prxima mensagem direto no anel, sem esperar.
+     * @return bool false se no houver mensagem nova agora ou se o leitor foi descartado.
+     * @throw std::runtime_error Se o registro estiver corrompido (sem o leitor ter sido descartado).
+     */
+    bool tentarEspiar(std::string_view& mensagem) {
+        for (;;) {
+            if (foiDescartado()) return false;
+            if (posicao_ == cabecaConhecida_) {
+                cabecaConhecida_ = c_->cabeca.load(std::memory_order_acquire);
+                if (posicao_ == cabecaConhecida_) return false;
+            }
+            const std::uint64_t inicio = posicao_ & mascara_;
+            std::uint32_t tamanho = 0;
+            std::memcpy(&tamanho, dados_ + inicio, sizeof(tamanho));
+            if (tamanho == kPular) {
+                posicao_ += (mascara_ + 1) - inicio;
+                devolver();
+                continue;
+            }
+            if (inicio + tamanhoDoRegistro(tamanho) > mascara_ + 1) { // s acontece se o registro foi sobrescrito
+                if (foiDescartado()) return false;
+                throw std::runtime_error("Registro corrompido na difusao.");
+            }
+            mensagem = { reinterpret_cast<const char*>(dados_ + inicio + kCabecalhoDoRegistro), tamanho };
+            espiado_ = tamanhoDoRegistro(tamanho);
+            return true;
+        }
+    }
+
+    /**
+     * @brief Olha a prxima mensagem, esperando (gira, depois dorme) se no houver nenhuma.
+     * @return bool false se o escritor encerrou e no h mais mensagens, ou se o leitor foi descartado.
+     */
+    bool espiar(std::string_view& mensagem) {
+        for (unsigned giro = 0; !tentarEspiar(mensagem); ++giro) {
+            if (foiDescartado()) return false;
+            if (c_->encerrado.load(std::memory_order_acquire)) return tentarEspiar(mensagem);
+            if (giro < giros_) {
+                pausar();
+                continue;
+            }
+            // Mesmo raciocnio de dormirAte, mas o futex  `avisos`, comum a todos os leitores: se o escritor
+            // avisar entre a leitura de `avisos` e o FUTEX_WAIT, o valor j mudou e o FUTEX_WAIT retorna na hora.
+            const std::uint32_t aviso = c_->avisos.load(std::memory_order_acquire);
+            c_->leitoresDormindo.store(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (c_->cabeca.load(std::memory_order_acquire) == posicao_ && c_->encerrado.load(std::memory_order_acquire) == 0) {
+                dormirNaPalavra(c_->avisos, aviso);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Termina a leitura da mensagem espiada e avana o cursor.
+     * @return bool false se o leitor foi descartado (a mensagem pode ter sido sobrescrita durante a leitura).
+     */
+    bool liberar() {
+        if (espiado_ == 0) throw std::logic_error("Nenhuma mensagem espiada para liberar.");
+        posicao_ += espiado_;
+        espiado_ = 0;
+        devolver();
+        return !foiDescartado();
+    }
+
+    /**
+     * @brief Recebe (copia) a prxima mensagem, esperando se no houver nenhuma.
+     * @return bool false se o escritor encerrou e no h mais mensagens, ou se o leitor foi descartado.
+     */
+    bool receber(std::string& mensagem) {
+        std::string_view espiada;
+        if (!espiar(espiada)) return false;
+        mensagem.assign(espiada);
+        return liberar();
+    }
+
+private:
+    /// Publica a posio do cursor e acorda o escritor se ele estiver esperando espao.
+    void devolver() noexcept {
+        cursor_->posicao.store(posicao_, std::memory_order_release);
+        acordarSeDormindo(c_->escritorDormindo);
+    }
+
+    CabecalhoDaDifusao* c_;
+    const unsigned char* dados_ = nullptr;
+    std::uint64_t mascara_ = 0;
+    CursorDoLeitor* cursor_ = nullptr;
+    std::uint64_t posicao_ = 0;         ///< Cpia local do cursor (s este leitor o altera).
+    std::uint64_t cabecaConhecida_ = 0;
+    std::uint64_t espiado_ = 0;
+    unsigned giros_ = girosPadrao();
+};
+
+#ifndef _WIN32
+
+/**
+ * @brief Segmento de memria compartilhada POSIX com nome (RAII sobre shm_open + mmap).
+ *
+ * Equivalente a CreateFileMappingW/OpenFileMappingW + MapViewOfFile. Quem cria o segmento remove o nome
+ * (shm_unlink) no destrutor; quem j o mapeou continua usando a memria at desmapear.
+ */
+class SegmentoCompartilhado {
+public:
+    /**
+     * @brief Cria (ou recria) o segmento `nome` com `tamanho` bytes zerados.
+     * @throw std::runtime_error Se o segmento no puder ser criado ou mapeado.
+     */
+    static SegmentoCompartilhado criar(const std::string& nome, std::size_t tamanho) {
+        shm_unlink(nome.c_str()); // resto de uma execuo anterior que no terminou
+        const int fd = shm_open(nome.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) throw std::runtime_error("shm_open(" + nome + ") falhou: errno " + std::to_string(errno));
+        if (ftruncate(fd, static_cast<off_t>(tamanho)) != 0) {
+            close(fd);
+            shm_unlink(nome.c_str());
+            throw std::runtime_error("ftruncate(" + nome + ") falhou: errno " + std::to_string(errno));
+        }
+        return SegmentoCompartilhado(nome, fd, tamanho, true);
+    }
+
+    /**
+     * @brief Abre um segmento criado por outro processo, com o tamanho que ele tiver.
+     * @throw std::runtime_error Se o segmento no existir ou no puder ser mapeado.
+     */
+    static SegmentoCompartilhado abrir(const std::string& nome) {
+        const int fd = shm_open(nome.c_str(), O_RDWR, 0);
+        if (fd < 0) throw std::runtime_error("shm_open(" + nome + ") falhou: errno " + std::to_string(errno) + ". O escritor esta em execucao?");
+        struct stat st {};
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::runtime_error("fstat(" + nome + ") falhou: errno " + std::to_string(errno));
+        }
+        return SegmentoCompartilhado(nome, fd, static_cast<std::size_t>(st.st_size), false);
+    }
+
+    SegmentoCompartilhado(SegmentoCompartilhado&& outro) noexcept
+        : nome_(std::move(outro.nome_)), memoria_(outro.memoria_), tamanho_(outro.tamanho_), dono_(outro.dono_) {
+        outro.memoria_ = nullptr;
+        outro.dono_ = false;
+    }
+
+    SegmentoCompartilhado(const SegmentoCompartilhado&) = delete;
+    SegmentoCompartilhado& operator=(const SegmentoCompartilhado&) = delete;
+    SegmentoCompartilhado& operator=(SegmentoCompartilhado&&) = delete;
+
+    ~SegmentoCompartilhado() {
+        if (memoria_) munmap(memoria_, tamanho_);
+        if (dono_) shm_unlink(nome_.c_str());
+    }
+
+    void* dados() const noexcept { return memoria_; }
+    std::size_t tamanho() const noexcept { return tamanho_; }
+
+private:
+    SegmentoCompartilhado(std::string nome, int fd, std::size_t tamanho, bool dono)
+        : nome_(std::move(nome)), tamanho_(tamanho), dono_(dono) {
+        void* mapa = mmap(nullptr, tamanho_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd); // o mapeamento mantm o segmento aberto
+        if (mapa == MAP_FAILED) {
+            if (dono_) shm_unlink(nome_.c_str());
+            throw std::runtime_error("mmap(" + nome_ + ") falhou: errno " + std::to_string(errno));
+        }
+        memoria_ = mapa;
+    }
+
+    std::string nome_;
+    void* memoria_ = nullptr;
+    std::size_t tamanho_ = 0;
+    bool dono_ = false;
+};
+
+#endif // !_WIN32
+
+} // namespace ipc
@@ -4,12 +4,40 @@
  *
  * Cria um segmento de memria compartilhada, um mutex e dois eventos para
  * enviar mensagens de forma sincronizada para o programa leitor.
+ *
+ * No Linux (e demais sistemas POSIX) o programa usa outro transporte: um segmento `shm_open`/`mmap`
+ * com um anel de vrias mensagens de tamanho varivel, sem lock (AnelCompartilhado.h). Com `--bench
+ * [mensagens]`, o escritor cria um processo leitor (fork) e compara a vazo do anel com a do protocolo
+ * de um slot (mutex + semforos "vazio"/"cheio", a verso POSIX dos objetos do Windows).
+ * `--bench-latencia [mensagens] [intervalo_us]` mede a latncia de ida (p50/p99) de mensagens espaadas,
+ * comparando a espera hbrida do anel (gira e depois dorme num futex) com dormir sempre.
+ * `--bench-zero-copia [MB]` compara enviar/receber (cpia) com reservar/confirmar + espiar/liberar
+ * (mensagem montada e lida direto no segmento) para mensagens de 64 B, 4 KB e 1 MB.
+ * `--difusao` envia as linhas para vrios leitores ao mesmo tempo (`Reader-ipc --difusao`), e
+ * `--bench-difusao [mensagens]` mede a vazo da difuso com 1 a 8 leitores e com um leitor lento.
  */
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include <iostream>
 #include <string>
 #include "shared_struct.h" // Inclui a definio da struct e constantes
+#include "AnelCompartilhado.h"
+
+#ifndef _WIN32
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <iomanip>
+#include <random>
+#include <vector>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/wait.h>
+#endif
+
+#ifdef _WIN32
 
  // Funo auxiliar para imprimir erros da API do Windows
 void PrintError(const std::string& functionName) {
@@ -115,4 +143,724 @@ int main() {
     CloseHandle(hEventEmpty);
 
     return 0;
-}
\ No newline at end of file
+}
+#else
+// --- Verso POSIX: benchmark do anel contra o protocolo de um slot ---
+
+/// @brief Maior mensagem do slot nico do benchmark, em bytes.
+const std::size_t MAIOR_MENSAGEM_DO_SLOT = 4096;
+
+/**
+ * @struct SlotUnico
+ * @brief O protocolo do SharedData em POSIX: uma mensagem por vez, protegida por mutex e dois semforos.
+ *
+ * O mutex e os semforos ficam dentro do prprio segmento (PTHREAD_PROCESS_SHARED / pshared = 1), no
+ * lugar dos objetos nomeados do kernel do Windows. A sequncia por mensagem  a mesma do Writer/Reader:
+ * esperar "vazio" -> travar o mutex -> copiar -> destravar -> sinalizar "cheio".
+ */
+struct SlotUnico {
+    pthread_mutex_t mutex;
+    sem_t vazio;
+    sem_t cheio;
+    bool exit_requested;
+    std::size_t tamanho;
+    char message[MAIOR_MENSAGEM_DO_SLOT];
+};
+
+/**
+ * @brief Preenche a mensagem nmero `i` do benchmark: o nmero nos primeiros bytes e um padro no resto.
+ */
+void montarMensagem(char* destino, std::size_t tamanho, std::uint64_t i) {
+    std::memset(destino, static_cast<int>(i & 0xFF), tamanho);
+    std::memcpy(destino, &i, std::min(tamanho, sizeof(i)));
+}
+
+/**
+ * @brief Confere se a mensagem recebida  a de nmero `i` (nmero, tamanho e ltimo byte).
+ */
+bool conferirMensagem(const char* dados, std::size_t tamanho, std::size_t esperado, std::uint64_t i) {
+    std::uint64_t numero = 0;
+    std::memcpy(&numero, dados, std::min(tamanho, sizeof(numero)));
+    const std::uint64_t mascara = esperado >= sizeof(i) ? ~std::uint64_t{ 0 } : (std::uint64_t{ 1 } << (8 * esperado)) - 1;
+    return tamanho == esperado && numero == (i & mascara)
+        && (tamanho <= sizeof(i) || static_cast<unsigned char>(dados[tamanho - 1]) == (i & 0xFF));
+}
+
+/**
+ * @brief Espera o processo leitor terminar e converte o cdigo de sada em erro.
+ */
+void esperarLeitor(pid_t leitor) {
+    int status = 0;
+    while (waitpid(leitor, &status, 0) < 0 && errno == EINTR) {}
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw std::runtime_error("O processo leitor recebeu mensagens erradas (status " + std::to_string(status) + ").");
+    }
+}
+
+/**
+ * @brief Envia `mensagens` mensagens de `tamanho` bytes pelo slot nico para um processo leitor.
+ * @return double Segundos do primeiro envio at o leitor terminar.
+ */
+double medirSlotUnico(std::uint64_t mensagens, std::size_t tamanho) {
+    auto segmento = ipc::SegmentoCompartilhado::criar("/MySharedMemoryBenchSlot", sizeof(SlotUnico));
+    auto* slot = new (segmento.dados()) SlotUnico{};
+    pthread_mutexattr_t atributos;
+    pthread_mutexattr_init(&atributos);
+    pthread_mutexattr_setpshared(&atributos, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&slot->mutex, &atributos);
+    pthread_mutexattr_destroy(&atributos);
+    sem_init(&slot->vazio, 1, 1); // sinalizado: o buffer comea vazio
+    sem_init(&slot->cheio, 1, 0);
+
+    const pid_t leitor = fork();
+    if (leitor < 0) throw std::runtime_error("fork falhou");
+    if (leitor == 0) {
+        bool certo = true;
+        for (std::uint64_t i = 0;; ++i) {
+            sem_wait(&slot->cheio);
+            pthread_mutex_lock(&slot->mutex);
+            if (slot->exit_requested) {
+                certo = certo && i == mensagens;
+                pthread_mutex_unlock(&slot->mutex);
+                break;
+            }
+            certo = certo && conferirMensagem(slot->message, slot->tamanho, tamanho, i);
+            pthread_mutex_unlock(&slot->mutex);
+            sem_post(&slot->vazio);
+        }
+        _exit(certo ? 0 : 2);
+    }
+
+    std::string mensagem(tamanho, '\0');
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i <= mensagens; ++i) {
+        if (i < mensagens) montarMensagem(mensagem.data(), mensagem.size(), i);
+        sem_wait(&slot->vazio);
+        pthread_mutex_lock(&slot->mutex);
+        if (i == mensagens) {
+            slot->exit_requested = true;
+        }
+        else {
+            std::memcpy(slot->message, mensagem.data(), tamanho);
+            slot->tamanho = tamanho;
+        }
+        pthread_mutex_unlock(&slot->mutex);
+        sem_post(&slot->cheio);
+    }
+    esperarLeitor(leitor);
+    const double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    sem_destroy(&slot->vazio);
+    sem_destroy(&slot->cheio);
+    pthread_mutex_destroy(&slot->mutex);
+    return segundos;
+}
+
+/**
+ * @brief Envia `mensagens` mensagens de `tamanho` bytes pelo anel para um processo leitor.
+ * @return double Segundos do primeiro envio at o leitor terminar.
+ */
+double medirAnel(std::uint64_t mensagens, std::size_t tamanho, std::size_t capacidade) {
+    const std::string nome = "/MySharedMemoryBenchRing";
+    auto segmento = ipc::SegmentoCompartilhado::criar(nome, ipc::AnelSpsc::tamanhoDoSegmento(capacidade));
+    auto anel = ipc::AnelSpsc::inicializar(segmento.dados(), capacidade);
+
+    const pid_t leitor = fork();
+    if (leitor < 0) throw std::runtime_error("fork falhou");
+    if (leitor == 0) {
+        bool certo = true;
+        std::uint64_t i = 0;
+        try {
+            auto meu = ipc::SegmentoCompartilhado::abrir(nome); // o leitor abre pelo nome, como o Reader-ipc
+            auto anelDoLeitor = ipc::AnelSpsc::anexar(meu.dados(), meu.tamanho());
+            for (std::string recebida; anelDoLeitor.receber(recebida); ++i) {
+                certo = certo && conferirMensagem(recebida.data(), recebida.size(), tamanho, i);
+            }
+        }
+        catch (...) {
+            certo = false;
+        }
+        _exit(certo && i == mensagens ? 0 : 2);
+    }
+
+    std::string mensagem(tamanho, '\0');
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < mensagens; ++i) {
+        montarMensagem(mensagem.data(), mensagem.size(), i);
+        anel.enviar(mensagem.data(), mensagem.size());
+    }
+    anel.encerrar();
+    esperarLeitor(leitor);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/**
+ * @brief Compara a vazo (mensagens/s e GB/s) do slot nico com a do anel, para vrios tamanhos de mensagem.
+ *
+ * Cada medida  a melhor de 3. O tamanho de 1024 bytes corresponde ao SharedData original
+ * (256 wchar_t de 4 bytes no Linux).
+ */
+void benchIpc(std::uint64_t mensagens) {
+    const std::size_t capacidade = RING_CAPACITY;
+    std::cout << mensagens << " mensagens por medida, anel de " << capacidade / 1024 << " KB, "
+        << std::thread::hardware_concurrency() << " CPUs" << std::endl;
+    std::cout << std::setw(8) << "bytes" << std::setw(12) << "protocolo" << std::setw(14) << "msgs/s"
+        << std::setw(10) << "GB/s" << std::setw(10) << "speedup" << std::endl;
+    for (std::size_t tamanho : { std::size_t{ 16 }, std::size_t{ 64 }, std::size_t{ 1024 }, std::size_t{ 4096 } }) {
+        double slot = 0.0;
+        double anel = 0.0;
+        for (int r = 0; r < 3; ++r) {
+            const double s = medirSlotUnico(mensagens, tamanho);
+            const double a = medirAnel(mensagens, tamanho, capacidade);
+            slot = (r == 0) ? s : std::min(slot, s);
+            anel = (r == 0) ? a : std::min(anel, a);
+        }
+        for (const auto& [nome, segundos] : { std::pair<const char*, double>{ "slot unico", slot }, { "anel", anel } }) {
+            const double porSegundo = static_cast<double>(mensagens) / segundos;
+            std::cout << std::setw(8) << tamanho << std::setw(12) << nome << std::fixed << std::setprecision(0)
+                << std::setw(14) << porSegundo << std::setprecision(3) << std::setw(10) << porSegundo * static_cast<double>(tamanho) / 1e9
+                << std::setprecision(1) << std::setw(9) << slot / segundos << "x" << std::endl;
+        }
+    }
+}
+
+// --- Latncia de ida: mensagens espaadas, carimbadas com o relgio monotnico ---
+
+/**
+ * @brief Relgio comum aos dois processos (steady_clock  CLOCK_MONOTONIC no Linux), em nanossegundos.
+ */
+std::uint64_t agoraEmNanossegundos() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Memria annima compartilhada com o processo filho: o leitor grava ali uma latncia por mensagem
+ * e, na ltima posio, quantas chamadas futex fez.
+ */
+class ResultadosCompartilhados {
+public:
+    explicit ResultadosCompartilhados(std::uint64_t mensagens) : tamanho_((mensagens + 1) * sizeof(std::uint64_t)) {
+        void* mapa = mmap(nullptr, tamanho_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (mapa == MAP_FAILED) throw std::runtime_error("mmap dos resultados falhou");
+        valores_ = static_cast<std::uint64_t*>(mapa);
+    }
+    ResultadosCompartilhados(const ResultadosCompartilhados&) = delete;
+    ResultadosCompartilhados& operator=(const ResultadosCompartilhados&) = delete;
+    ~ResultadosCompartilhados() { munmap(valores_, tamanho_); }
+
+    std::uint64_t& operator[](std::size_t i) noexcept { return valores_[i]; }
+
+private:
+    std::size_t tamanho_;
+    std::uint64_t* valores_ = nullptr;
+};
+
+/**
+ * @brief Latncia de ida pelo slot nico: cada mensagem passa por "vazio" -> mutex -> "cheio".
+ * @param resultados Recebe as latncias em ns (posies 0..mensagens-1).
+ */
+void medirLatenciaSlotUnico(std::uint64_t mensagens, std::chrono::microseconds intervalo, ResultadosCompartilhados& resultados) {
+    auto segmento = ipc::SegmentoCompartilhado::criar("/MySharedMemoryBenchSlot", sizeof(SlotUnico));
+    auto* slot = new (segmento.dados()) SlotUnico{};
+    pthread_mutexattr_t atributos;
+    pthread_mutexattr_init(&atributos);
+    pthread_mutexattr_setpshared(&atributos, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&slot->mutex, &atributos);
+    pthread_mutexattr_destroy(&atributos);
+    sem_init(&slot->vazio, 1, 1);
+    sem_init(&slot->cheio, 1, 0);
+
+    const pid_t leitor = fork();
+    if (leitor < 0) throw std::runtime_error("fork falhou");
+    if (leitor == 0) {
+        for (std::uint64_t i = 0;; ++i) {
+            sem_wait(&slot->cheio);
+            const std::uint64_t chegada = agoraEmNanossegundos();
+            pthread_mutex_lock(&slot->mutex);
+            if (slot->exit_requested) break;
+            std::uint64_t enviada = 0;
+            std::memcpy(&enviada, slot->message, sizeof(enviada));
+            resultados[i] = chegada - enviada;
+            pthread_mutex_unlock(&slot->mutex);
+            sem_post(&slot->vazio);
+        }
+        _exit(0);
+    }
+
+    for (std::uint64_t i = 0; i <= mensagens; ++i) {
+        std::this_thread::sleep_for(intervalo);
+        const std::uint64_t enviada = agoraEmNanossegundos();
+        sem_wait(&slot->vazio);
+        pthread_mutex_lock(&slot->mutex);
+        if (i == mensagens) {
+            slot->exit_requested = true;
+        }
+        else {
+            std::memcpy(slot->message, &enviada, sizeof(enviada));
+            slot->tamanho = sizeof(enviada);
+        }
+        pthread_mutex_unlock(&slot->mutex);
+        sem_post(&slot->cheio);
+    }
+    esperarLeitor(leitor);
+    resultados[mensagens] = 0; // o protocolo sempre dorme; as chamadas no so contadas
+    sem_destroy(&slot->vazio);
+    sem_destroy(&slot->cheio);
+    pthread_mutex_destroy(&slot->mutex);
+}
+
+/**
+ * @brief Latncia de ida pelo anel com `giros` giros antes de dormir (0 = sempre dormir).
+ * @param resultados Recebe as latncias em ns e, na posio `mensagens`, as chamadas futex dos dois lados.
+ */
+void medirLatenciaAnel(std::uint64_t mensagens, std::chrono::microseconds intervalo, unsigned giros, ResultadosCompartilhados& resultados) {
+    const std::string nome = "/MySharedMemoryBenchRing";
+    auto segmento = ipc::SegmentoCompartilhado::criar(nome, ipc::AnelSpsc::tamanhoDoSegmento(RING_CAPACITY));
+    auto anel = ipc::AnelSpsc::inicializar(segmento.dados(), RING_CAPACITY);
+    anel.definirGiros(giros);
+
+    const pid_t leitor = fork();
+    if (leitor < 0) throw std::runtime_error("fork falhou");
+    if (leitor == 0) {
+        std::uint64_t i = 0;
+        try {
+            auto meu = ipc::SegmentoCompartilhado::abrir(nome);
+            auto anelDoLeitor = ipc::AnelSpsc::anexar(meu.dados(), meu.tamanho());
+            anelDoLeitor.definirGiros(giros);
+            for (std::string recebida; anelDoLeitor.receber(recebida); ++i) {
+                const std::uint64_t chegada = agoraEmNanossegundos();
+                std::uint64_t enviada = 0;
+                std::memcpy(&enviada, recebida.data(), std::min(recebida.size(), sizeof(enviada)));
+                if (i < mensagens) resultados[i] = chegada - enviada;
+            }
+            resultados[mensagens] = anelDoLeitor.chamadasAoKernel();
+        }
+        catch (...) {
+            _exit(2);
+        }
+        _exit(i == mensagens ? 0 : 2);
+    }
+
+    for (std::uint64_t i = 0; i < mensagens; ++i) {
+        std::this_thread::sleep_for(intervalo);
+        const std::uint64_t enviada = agoraEmNanossegundos();
+        anel.enviar(&enviada, sizeof(enviada));
+    }
+    anel.encerrar();
+    esperarLeitor(leitor);
+    resultados[mensagens] += anel.chamadasAoKernel();
+}
+
+/**
+ * @brief Compara a latncia de ida (p50, p99, p99.9, mximo) do slot nico, do anel que sempre dorme e do
+ * anel com espera hbrida.
+ *
+ * O escritor dorme `intervalo` entre uma mensagem e outra, ento o leitor quase sempre encontra o anel
+ * vazio:  o caso em que a forma de esperar decide a latncia. A coluna "futex/msg" conta as chamadas de
+ * sistema de dormir e acordar dos dois lados; no hbrido, um leitor que ainda est girando quando a
+ * mensagem chega no dorme e o escritor no precisa acord-lo. Com uma CPU s, o leitor girando ocupa a
+ * CPU que o escritor precisa, e o hbrido no tem como ganhar.
+ */
+void benchLatencia(std::uint64_t mensagens, std::chrono::microseconds intervalo) {
+    std::cout << mensagens << " mensagens de 8 bytes, uma a cada " << intervalo.count() << " us, "
+        << std::thread::hardware_concurrency() << " CPUs" << std::endl;
+    std::cout << std::left << std::setw(28) << "protocolo" << std::right << std::setw(10) << "p50 (us)" << std::setw(10) << "p99"
+        << std::setw(10) << "p99.9" << std::setw(10) << "max" << std::setw(11) << "futex/msg" << std::endl;
+    ResultadosCompartilhados resultados(mensagens);
+    auto imprimir = [&](const std::string& nome, bool contarChamadas) {
+        std::vector<std::uint64_t> latencias(mensagens);
+        for (std::uint64_t i = 0; i < mensagens; ++i) latencias[i] = resultados[i];
+        std::sort(latencias.begin(), latencias.end());
+        auto percentil = [&](double p) {
+            return static_cast<double>(latencias[std::min<std::size_t>(latencias.size() - 1, static_cast<std::size_t>(p * static_cast<double>(latencias.size())))]) / 1000.0;
+        };
+        std::cout << std::left << std::setw(28) << nome << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << percentil(0.50) << std::setw(10) << percentil(0.99) << std::setw(10) << percentil(0.999)
+            << std::setw(10) << static_cast<double>(latencias.back()) / 1000.0;
+        if (contarChamadas) {
+            std::cout << std::setprecision(2) << std::setw(11) << static_cast<double>(resultados[mensagens]) / static_cast<double>(mensagens);
+        }
+        else {
+            std::cout << std::setw(11) << "-";
+        }
+        std::cout << std::endl;
+    };
+    medirLatenciaSlotUnico(mensagens, intervalo, resultados);
+    imprimir("slot unico (semaforos)", false);
+    medirLatenciaAnel(mensagens, intervalo, 0, resultados);
+    imprimir("anel, sempre dorme", true);
+    for (unsigned giros : { 2000u, 20000u }) {
+        medirLatenciaAnel(mensagens, intervalo, giros, resultados);
+        imprimir("anel, hibrido " + std::to_string(giros) + " giros", true);
+    }
+}
+
+// --- Sem cpia: reservar/confirmar e espiar/liberar ---
+
+/**
+ * @brief Soma o contedo da mensagem em palavras de 8 bytes:  o "uso" da mensagem pelo leitor no benchmark.
+ */
+std::uint64_t somarPalavras(const char* dados, std::size_t tamanho) {
+    std::uint64_t soma = 0;
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= tamanho; i += sizeof(std::uint64_t)) {
+        std::uint64_t palavra;
+        std::memcpy(&palavra, dados + i, sizeof(palavra));
+        soma += palavra;
+    }
+    for (; i < tamanho; ++i) soma += static_cast<unsigned char>(dados[i]);
+    return soma;
+}
+
+/**
+ * @brief Confere o anel com mensagens de tamanhos aleatrios, de 0 at maiorMensagem(), entre dois processos.
+ * @throw std::runtime_error Se o leitor receber algo diferente do que foi enviado.
+ *
+ * O anel  pequeno (4 KB) para que quase toda mensagem caia perto do fim da rea e passe por um
+ * marcador "pular", e inclui mensagens do tamanho do anel inteiro. As APIs se alternam: metade das
+ * mensagens  reservada com folga e confirmada com o tamanho certo, a outra metade vai por enviar; o leitor
+ * alterna espiar/liberar e receber.
+ */
+void conferirAnel(std::uint64_t mensagens) {
+    const std::string nome = "/MySharedMemoryBenchRing";
+    const std::size_t capacidade = 4096;
+    auto segmento = ipc::SegmentoCompartilhado::criar(nome, ipc::AnelSpsc::tamanhoDoSegmento(capacidade));
+    auto anel = ipc::AnelSpsc::inicializar(segmento.dados(), capacidade);
+    const std::size_t maior = anel.maiorMensagem();
+    auto tamanhoDa = [maior](std::mt19937_64& rng) {
+        const std::uint64_t sorteio = rng();
+        return static_cast<std::size_t>(sorteio % 8 == 0 ? maior - sorteio % 3 : (sorteio >> 8) % (maior + 1));
+    };
+
+    const pid_t leitor = fork();
+    if (leitor < 0) throw std::runtime_error("fork falhou");
+    if (leitor == 0) {
+        bool certo = true;
+        std::uint64_t i = 0;
+        try {
+            auto meu = ipc::SegmentoCompartilhado::abrir(nome);
+            auto anelDoLeitor = ipc::AnelSpsc::anexar(meu.dados(), meu.tamanho());
+            std::mt19937_64 rng(42);
+            std::string copia;
+            for (;; ++i) {
+                std::string_view espiada;
+                if (i % 2 == 0) {
+                    if (!anelDoLeitor.espiar(espiada)) break;
+                }
+                else {
+                    if (!anelDoLeitor.receber(copia)) break;
+                    espiada = copia;
+                }
+                certo = certo && conferirMensagem(espiada.data(), espiada.size(), tamanhoDa(rng), i);
+                if (i % 2 == 0) anelDoLeitor.liberar();
+            }
+        }
+        catch (...) {
+            certo = false;
+        }
+        _exit(certo && i == mensagens ? 0 : 2);
+    }
+
+    std::mt19937_64 rng(42);
+    std::string mensagem;
+    for (std::uint64_t i = 0; i < mensagens; ++i) {
+        const std::size_t tamanho = tamanhoDa(rng);
+        if (i % 2 == 0) {
+            char* destino = static_cast<char*>(anel.reservar(std::min(maior, tamanho + 16)));
+            montarMensagem(destino, tamanho, i);
+            anel.confirmar(tamanho);
+        }
+        else {
+            mensagem.resize(tamanho);
+            montarMensagem(mensagem.data(), tamanho, i);
+            anel.enviar(mensagem.data(), mensagem.size());
+        }
+    }
+    anel.encerrar();
+    esperarLeitor(leitor);
+}
+
+/**
+ * @brief Envia `mensagens` mensagens de `tamanho` bytes com cpia (enviar/receber) ou sem (reservar/espiar).
+ * @return double Segundos do primeiro envio at o leitor terminar.
+ *
+ * Nos dois casos o escritor preenche a mensagem inteira e o leitor soma a mensagem inteira; a diferena
+ *  s onde os bytes ficam: com cpia, num buffer do programa que  copiado para o anel e de volta para
+ * outro buffer; sem cpia, direto no segmento.
+ */
+double medirCopia(std::uint64_t mensagens, std::size_t tamanho, std::size_t capacidade, bool semCopia) {
+    const std::string nome = "/MySharedMemoryBenchRing";
+    auto segmento = ipc::SegmentoCompartilhado::criar(nome, ipc::AnelSpsc::tamanhoDoSegmento(capacidade));
+    auto anel = ipc::AnelSpsc::inicializar(segmento.dados(), capacidade);
+
+    const pid_t leitor = fork();
+    if (leitor < 0) throw std::runtime_error("fork falhou");
+    if (leitor == 0) {
+        bool certo = true;
+        std::uint64_t i = 0;
+        std::uint64_t soma = 0;
+        try {
+            auto meu = ipc::SegmentoCompartilhado::abrir(nome);
+            auto anelDoLeitor = ipc::AnelSpsc::anexar(meu.dados(), meu.tamanho());
+            if (semCopia) {
+                for (std::string_view espiada; anelDoLeitor.espiar(espiada); ++i) {
+                    certo = certo && conferirMensagem(espiada.data(), espiada.size(), tamanho, i);
+                    soma += somarPalavras(espiada.data(), espiada.size());
+                    anelDoLeitor.liberar();
+                }
+            }
+            else {
+                for (std::string recebida; anelDoLeitor.receber(recebida); ++i) {
+                    certo = certo && conferirMensagem(recebida.data(), recebida.size(), tamanho, i);
+                    soma += somarPalavras(recebida.data(), recebida.size());
+                }
+            }
+        }
+        catch (...) {
+            certo = false;
+        }
+        _exit(certo && i == mensagens && soma != 1 ? 0 : 2); // usa a soma para o compilador no descart-la
+    }
+
+    std::string mensagem(tamanho, '\0');
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < mensagens; ++i) {
+        if (semCopia) {
+            montarMensagem(static_cast<char*>(anel.reservar(tamanho)), tamanho, i);
+            anel.confirmar();
+        }
+        else {
+            montarMensagem(mensagem.data(), tamanho, i);
+            anel.enviar(mensagem.data(), mensagem.size());
+        }
+    }
+    anel.encerrar();
+    esperarLeitor(leitor);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+/**
+ * @brief Compara enviar/receber com reservar/confirmar + espiar/liberar para 64 B, 4 KB e 1 MB.
+ *
+ * Cada medida transfere cerca de `megabytes` MB (entre 1000 e 2 milhes de mensagens) e vale a melhor
+ * de 3. O anel tem pelo menos 4 vezes o tamanho da mensagem, para que o escritor no espere o leitor a
+ * cada mensagem de 1 MB.
+ */
+void benchZeroCopia(std::uint64_t megabytes) {
+    conferirAnel(20000);
+    std::cout << "Conferencia com tamanhos aleatorios (ate o tamanho do anel): OK" << std::endl;
+    std::cout << std::setw(9) << "bytes" << std::setw(8) << "anel" << std::setw(16) << "api" << std::setw(12) << "msgs/s"
+        << std::setw(10) << "GB/s" << std::setw(9) << "ganho" << std::endl;
+    for (std::size_t tamanho : { std::size_t{ 64 }, std::size_t{ 4096 }, std::size_t{ 1 } << 20 }) {
+        const std::uint64_t mensagens = std::clamp<std::uint64_t>(megabytes * 1000000 / tamanho, 1000, 2000000);
+        const std::size_t capacidade = std::max<std::size_t>(RING_CAPACITY, std::bit_ceil(4 * tamanho));
+        double comCopia = 0.0;
+        double semCopia = 0.0;
+        for (int r = 0; r < 3; ++r) {
+            const double c = medirCopia(mensagens, tamanho, capacidade, false);
+            const double z = medirCopia(mensagens, tamanho, capacidade, true);
+            comCopia = (r == 0) ? c : std::min(comCopia, c);
+            semCopia = (r == 0) ? z : std::min(semCopia, z);
+        }
+        for (const auto& [nome, segundos] : { std::pair<const char*, double>{ "enviar/receber", comCopia }, { "sem copia", semCopia } }) {
+            const double porSegundo = static_cast<double>(mensagens) / segundos;
+            std::cout << std::setw(9) << tamanho << std::setw(6) << capacidade / (1 << 20) << "MB" << std::setw(16) << nome
+                << std::fixed << std::setprecision(0) << std::setw(12) << porSegundo
+                << std::setprecision(3) << std::setw(10) << porSegundo * static_cast<double>(tamanho) / 1e9
+                << std::setprecision(2) << std::setw(8) << comCopia / segundos << "x" << std::endl;
+        }
+    }
+}
+
+// --- Difuso: um escritor, vrios leitores ---
+
+/**
+ * @brief Resultado de uma medida da difuso.
+ */
+struct MedidaDaDifusao {
+    double segundos = 0.0;        ///< Do primeiro envio at o ltimo leitor terminar.
+    std::uint64_t descartados = 0; ///< Leitores que o escritor descartou.
+};
+
+/**
+ * @brief Envia `mensagens` mensagens de 64 bytes pela difuso para `leitores` processos leitores.
+ * @param lento Se verdadeiro, o ltimo leitor cochila 1 ms a cada 128 mensagens.
+ *
+ * O escritor s comea depois que todos os leitores entraram na difuso, para que cada um receba as
+ * mensagens desde a primeira. Cada leitor confere a sequncia e sai com 0 (recebeu tudo), 3 (foi
+ * descartado) ou 2 (erro). S o leitor lento, com PoliticaDeLentos::Descartar, pode terminar descartado;
+ * qualquer outro cdigo  um erro.
+ */
+MedidaDaDifusao medirDifusao(std::uint64_t mensagens, unsigned leitores, std::size_t capacidade,
+    ipc::PoliticaDeLentos politica, std::chrono::microseconds tolerancia, bool lento) {
+    const std::string nome = "/MySharedMemoryBenchBroadcast";
+    const std::size_t tamanho = 64;
+    auto segmento = ipc::SegmentoCompartilhado::criar(nome, ipc::AnelDifusao::tamanhoDoSegmento(capacidade));
+    auto difusao = ipc::AnelDifusao::inicializar(segmento.dados(), capacidade, politica, tolerancia);
+
+    std::vector<pid_t> filhos;
+    for (unsigned l = 0; l < leitores; ++l) {
+        const pid_t leitor = fork();
+        if (leitor < 0) throw std::runtime_error("fork falhou");
+        if (leitor == 0) {
+            const bool souLento = lento && l + 1 == leitores;
+            int codigo = 2;
+            try {
+                auto meu = ipc::SegmentoCompartilhado::abrir(nome);
+                ipc::LeitorDaDifusao leitorDaDifusao(meu.dados(), meu.tamanho());
+                bool certo = true;
+                std::uint64_t i = 0;
+                for (std::string_view espiada; leitorDaDifusao.espiar(espiada); ++i) {
+                    const bool conferida = conferirMensagem(espiada.data(), espiada.size(), tamanho, i);
+                    if (!leitorDaDifusao.liberar()) break; // descartado: a mensagem pode ter sido sobrescrita
+                    certo = certo && conferida;
+                    if (souLento && i % 128 == 127) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                codigo = leitorDaDifusao.foiDescartado() ? 3 : (certo && i == mensagens ? 0 : 2);
+            }
+            catch (...) {
+                codigo = 2;
+            }
+            _exit(codigo);
+        }
+        filhos.push_back(leitor);
+    }
+    while (difusao.leitoresAtivos() < leitores) std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < mensagens; ++i) {
+        montarMensagem(static_cast<char*>(difusao.reservar(tamanho)), tamanho, i);
+        difusao.confirmar();
+    }
+    difusao.encerrar();
+
+    MedidaDaDifusao medida;
+    for (unsigned l = 0; l < leitores; ++l) {
+        int status = 0;
+        while (waitpid(filhos[l], &status, 0) < 0 && errno == EINTR) {}
+        const int codigo = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+        const bool podeSerDescartado = lento && l + 1 == leitores && politica == ipc::PoliticaDeLentos::Descartar;
+        if (codigo != 0 && !(codigo == 3 && podeSerDescartado)) {
+            throw std::runtime_error("O leitor " + std::to_string(l) + " da difusao terminou com status " + std::to_string(status) + ".");
+        }
+    }
+    medida.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    medida.descartados = difusao.descartados();
+    return medida;
+}
+
+/**
+ * @brief Mede a vazo da difuso com 1, 2, 4 e 8 leitores e compara as duas polticas com um leitor lento.
+ *
+ * Cada medida de vazo  a melhor de 3. "entregas/s" conta uma mensagem por leitor:  o trabalho total
+ * que a difuso faz, enquanto "msgs/s"  o ritmo que o escritor consegue manter.
+ */
+void benchDifusao(std::uint64_t mensagens) {
+    const std::size_t capacidade = RING_CAPACITY;
+    std::cout << mensagens << " mensagens de 64 bytes por medida, anel de " << capacidade / 1024 << " KB, "
+        << std::thread::hardware_concurrency() << " CPUs" << std::endl;
+    std::cout << std::setw(9) << "leitores" << std::setw(14) << "msgs/s" << std::setw(16) << "entregas/s"
+        << std::setw(10) << "GB/s" << std::endl;
+    for (unsigned leitores : { 1u, 2u, 4u, 8u }) {
+        double melhor = 0.0;
+        for (int r = 0; r < 3; ++r) {
+            const double s = medirDifusao(mensagens, leitores, capacidade, ipc::PoliticaDeLentos::Esperar,
+                std::chrono::milliseconds(1), false).segundos;
+            melhor = (r == 0) ? s : std::min(melhor, s);
+        }
+        const double porSegundo = static_cast<double>(mensagens) / melhor;
+        std::cout << std::setw(9) << leitores << std::fixed << std::setprecision(0) << std::setw(14) << porSegundo
+            << std::setw(16) << porSegundo * leitores << std::setprecision(3) << std::setw(10) << porSegundo * leitores * 64 / 1e9
+            << std::endl;
+    }
+
+    // Anel pequeno para que o leitor lento encha o anel logo.
+    const std::size_t capacidadeDoLento = 64 * 1024;
+    const auto tolerancia = std::chrono::microseconds(500);
+    std::cout << "3 leitores, um deles cochila 1 ms a cada 128 mensagens (anel de " << capacidadeDoLento / 1024
+        << " KB, tolerancia " << tolerancia.count() << " us):" << std::endl;
+    for (const auto& [nomeDaPolitica, politica] : { std::pair<const char*, ipc::PoliticaDeLentos>{ "esperar", ipc::PoliticaDeLentos::Esperar },
+             { "descartar", ipc::PoliticaDeLentos::Descartar } }) {
+        const MedidaDaDifusao medida = medirDifusao(mensagens, 3, capacidadeDoLento, politica, tolerancia, true);
+        std::cout << std::setw(11) << nomeDaPolitica << std::fixed << std::setprecision(0) << std::setw(14)
+            << static_cast<double>(mensagens) / medida.segundos << " msgs/s, " << medida.descartados << " leitor(es) descartado(s), leitores rapidos receberam tudo" << std::endl;
+    }
+}
+
+/**
+ * @brief Modo interativo `--difusao`: envia as linhas digitadas para todos os leitores (`Reader-ipc --difusao`).
+ *
+ * Usa PoliticaDeLentos::Descartar: um leitor parado no trava o escritor por mais de 10 ms.
+ */
+void escritorDaDifusao() {
+    auto segmento = ipc::SegmentoCompartilhado::criar(SHM_BROADCAST_NAME, ipc::AnelDifusao::tamanhoDoSegmento(RING_CAPACITY));
+    auto difusao = ipc::AnelDifusao::inicializar(segmento.dados(), RING_CAPACITY, ipc::PoliticaDeLentos::Descartar,
+        std::chrono::milliseconds(10));
+
+    std::cout << "Programa escritor (difusao) iniciado. Digite mensagens (use 'exit' para sair)." << std::endl;
+    while (true) {
+        std::string line;
+        std::cout << "> ";
+        if (!std::getline(std::cin, line) || line == "exit") {
+            difusao.encerrar();
+            break;
+        }
+        difusao.enviar(line.data(), line.size());
+    }
+    std::cout << "Encerrando o escritor..." << std::endl;
+}
+
+/**
+ * @brief Funo principal do programa escritor (POSIX): envia as linhas digitadas pelo anel.
+ * @return int Retorna 0 em caso de sucesso, 1 em caso de erro.
+ *
+ * Ao contrrio do protocolo de um slot, o escritor no espera o leitor a cada mensagem: as linhas
+ * ficam no anel at o leitor busc-las, e ele s espera quando o anel est cheio.
+ */
+int main(int argc, char* argv[]) {
+    try {
+        if (argc >= 2 && std::string(argv[1]) == "--bench") {
+            benchIpc(argc >= 3 ? std::stoull(argv[2]) : 200000);
+            return 0;
+        }
+        if (argc >= 2 && std::string(argv[1]) == "--bench-zero-copia") {
+            benchZeroCopia(argc >= 3 ? std::stoull(argv[2]) : 1000);
+            return 0;
+        }
+        if (argc >= 2 && std::string(argv[1]) == "--bench-latencia") {
+            const std::uint64_t mensagens = argc >= 3 ? std::stoull(argv[2]) : 20000;
+            if (mensagens == 0) throw std::runtime_error("O numero de mensagens deve ser pelo menos 1.");
+            benchLatencia(mensagens, std::chrono::microseconds(argc >= 4 ? std::stoll(argv[3]) : 50));
+            return 0;
+        }
+        if (argc >= 2 && std::string(argv[1]) == "--bench-difusao") {
+            benchDifusao(argc >= 3 ? std::stoull(argv[2]) : 200000);
+            return 0;
+        }
+        if (argc >= 2 && std::string(argv[1]) == "--difusao") {
+            escritorDaDifusao();
+            return 0;
+        }
+
+        auto segmento = ipc::SegmentoCompartilhado::criar(SHM_RING_NAME, ipc::AnelSpsc::tamanhoDoSegmento(RING_CAPACITY));
+        auto anel = ipc::AnelSpsc::inicializar(segmento.dados(), RING_CAPACITY);
+
+        std::cout << "Programa escritor iniciado. Digite mensagens (use 'exit' para sair)." << std::endl;
+        while (true) {
+            std::string line;
+            std::cout << "> ";
+            if (!std::getline(std::cin, line) || line == "exit") {
+                anel.encerrar();
+                break;
+            }
+            anel.enviar(line.data(), line.size());
+        }
+        std::cout << "Encerrando o escritor..." << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Erro: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+#endif
\ No newline at end of file